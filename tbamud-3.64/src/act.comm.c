@@ -398,8 +398,10 @@ ACMD(do_page)
 ACMD(do_gen_comm)
 {
   struct descriptor_data *i;
+  struct act_variants av[2];
   char color_on[24];
-  char buf1[MAX_INPUT_LENGTH], buf2[MAX_INPUT_LENGTH], *msg;
+  char buf1[MAX_INPUT_LENGTH], buf2[2][MAX_INPUT_LENGTH + 32], *msg;
+  int colored;
   bool emoting = FALSE;
 
   /* Array of flags which must _not_ be set in order for comm to be heard. */
@@ -502,15 +504,24 @@ ACMD(do_gen_comm)
     
     msg = act(buf1, FALSE, ch, 0, 0, TO_CHAR | TO_SLEEP);
     add_history(ch, msg, hist_type[subcmd]);
+    GMCPSendChannel(ch->desc, com_msgs[subcmd][1], GET_NAME(ch), msg);
   }
   if (!emoting)
     snprintf(buf1, sizeof(buf1), "$n %ss, '%s'", com_msgs[subcmd][1], argument);
 
+  /* Everyone hears one of these two, with or without the channel colour. */
+  snprintf(buf2[0], sizeof(buf2[0]), "%s%s", buf1, KNRM);
+  snprintf(buf2[1], sizeof(buf2[1]), "%s%s%s", color_on, buf1, KNRM);
+  act_variants_init(&av[0], buf2[0]);
+  act_variants_init(&av[1], buf2[1]);
+
   /* Now send all the strings out. */
   for (i = descriptor_list; i; i = i->next) {
     if (STATE(i) != CON_PLAYING || i == ch->desc || !i->character )
       continue;
-    if (!IS_NPC(ch) && (PRF_FLAGGED(i->character, channels[subcmd]) || PLR_FLAGGED(i->character, PLR_WRITING)))
+    if (PLR_FLAGGED(i->character, PLR_WRITING))
+      continue;
+    if (!IS_NPC(ch) && PRF_FLAGGED(i->character, channels[subcmd]))
       continue;
 
     if (ROOM_FLAGGED(IN_ROOM(i->character), ROOM_SOUNDPROOF) && (GET_LEVEL(ch) < LVL_GOD))
@@ -520,10 +531,14 @@ ACMD(do_gen_comm)
          !AWAKE(i->character)))
       continue;
 
-    snprintf(buf2, sizeof(buf2), "%s%s%s", (COLOR_LEV(i->character) >= C_NRM) ? color_on : "", buf1, KNRM); 
-    msg = act(buf2, FALSE, ch, 0, i->character, TO_VICT | TO_SLEEP);
+    colored = (COLOR_LEV(i->character) >= C_NRM);
+    msg = act_variant_send(&av[colored], ch, NULL, i->character, i->character);
     add_history(i->character, msg, hist_type[subcmd]);
+    if (!output_behind(i))
+      GMCPSendChannel(i, com_msgs[subcmd][1], PERS(ch, i->character), msg);
   }
+  act_variants_free(&av[0]);
+  act_variants_free(&av[1]);
 }
 
 ACMD(do_qcomm)
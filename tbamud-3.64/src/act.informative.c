@@ -28,6 +28,7 @@
 #include "fight.h"
 #include "modify.h"
 #include "asciimap.h"
+#include "help_index.h"
 
 /* prototypes of local functions */
 /* do_look and do_examine utility functions */
@@ -47,6 +48,8 @@ static void show_obj_modifiers(struct obj_data *obj, struct char_data *ch);
 static void perform_immort_where(struct char_data *ch, char *arg);
 static void perform_mortal_where(struct char_data *ch, char *arg);
 static void print_object_location(int num, struct obj_data *obj, struct char_data *ch, int recur);
+/* do_help utility functions */
+static int show_help_matches(struct char_data *ch, const char *terms, const char *header);
 
 /* Subcommands */
 /* For show_obj_to_char 'mode'.	/-- arbitrary */
@@ -170,53 +173,98 @@ static void show_obj_modifiers(struct obj_data *obj, struct char_data *ch)
       send_to_char(ch, " (humming)");
 }
 
+/* Copies of an object share a short description and keywords. They are
+ * listed once with a count, where the first copy appears in the list. */
+struct obj_group {
+  struct obj_data *first;    /* first copy in the list */
+  struct obj_data *display;  /* first copy ch can see */
+  unsigned long hash;
+  int num;                   /* copies ch can see */
+  int next;                  /* next group in the same bucket, -1 at the end */
+};
+
+#define SAME_OBJ_GROUP(a, b) \
+  (((a)->short_description == (b)->short_description && (a)->name == (b)->name) || \
+   (!strcmp((a)->short_description, (b)->short_description) && !strcmp((a)->name, (b)->name)))
+
+static unsigned long obj_group_hash(struct obj_data *obj)
+{
+  unsigned long hash = 5381;
+  const char *p;
+
+  for (p = obj->short_description; *p; p++)
+    hash = hash * 33 + *p;
+  hash = hash * 33;
+  for (p = obj->name; *p; p++)
+    hash = hash * 33 + *p;
+
+  return hash;
+}
+
 static void list_obj_to_char(struct obj_data *list, struct char_data *ch, int mode, int show)
 {
-  struct obj_data *i, *j, *display;
+  struct obj_data *i, *display;
+  struct obj_group *groups;
+  unsigned long hash;
+  int *buckets, num_objs, num_groups, size, g;
   bool found;
-  int num;
 
   found = FALSE;
 
-  /* Loop through the list of objects */
-  for (i = list; i; i = i->next_content) {
-    num = 0;
-
-    /* Check the list to see if we've already counted this object */
-    for (j = list; j != i; j = j->next_content)
-      if ((j->short_description == i->short_description && j->name == i->name) ||
-          (!strcmp(j->short_description, i->short_description) && !strcmp(j->name, i->name)))
-        break; /* found a matching object */
-    if (j != i)
-      continue; /* we counted object i earlier in the list */
-
-    /* Count matching objects, including this one */
-    for (display = j = i; j; j = j->next_content)
-      /* This if-clause should be exactly the same as the one in the loop above */
-      if ((j->short_description == i->short_description && j->name == i->name) ||
-          (!strcmp(j->short_description, i->short_description) && !strcmp(j->name, i->name)))
-        if (CAN_SEE_OBJ(ch, j)) {
-          ++num;
-          /* If the original item can't be seen, switch it for this one */
-          if (display == i && !CAN_SEE_OBJ(ch, display))
-            display = j;
-        }
+  for (num_objs = 0, i = list; i; i = i->next_content)
+    num_objs++;
+
+  if (num_objs) {
+    for (size = 16; size < num_objs * 2; size <<= 1)
+      ;
+    CREATE(groups, struct obj_group, num_objs);
+    CREATE(buckets, int, size);
+    for (g = 0; g < size; g++)
+      buckets[g] = -1;
+
+    /* Sort the list into groups of matching objects, in one pass */
+    for (num_groups = 0, i = list; i; i = i->next_content) {
+      hash = obj_group_hash(i);
+      for (g = buckets[hash & (size - 1)]; g != -1; g = groups[g].next)
+        if (groups[g].hash == hash && SAME_OBJ_GROUP(groups[g].first, i))
+          break;
+      if (g == -1) {
+        g = num_groups++;
+        groups[g].first = i;
+        groups[g].display = NULL;
+        groups[g].hash = hash;
+        groups[g].num = 0;
+        groups[g].next = buckets[hash & (size - 1)];
+        buckets[hash & (size - 1)] = g;
+      }
+      /* Show the first copy that can be seen */
+      if (CAN_SEE_OBJ(ch, i) && groups[g].num++ == 0)
+        groups[g].display = i;
+    }
 
-    /* When looking in room, hide objects starting with '.', except for holylight */
-    if (num > 0 && (mode != SHOW_OBJ_LONG || *display->description != '.' ||
-        (!IS_NPC(ch) && PRF_FLAGGED(ch, PRF_HOLYLIGHT)))) {
-      if (mode == SHOW_OBJ_LONG)
-        send_to_char(ch, "%s", CCGRN(ch, C_NRM));
-      if (num != 1)
-        send_to_char(ch, "(%2i) ", num);
-      show_obj_to_char(display, ch, mode);
-      send_to_char(ch, "%s", CCNRM(ch, C_NRM));
-      found = TRUE;
+    for (g = 0; g < num_groups; g++) {
+      display = groups[g].display;
+
+      /* When looking in room, hide objects starting with '.', except for holylight */
+      if (groups[g].num > 0 && (mode != SHOW_OBJ_LONG || *display->description != '.' ||
+          (!IS_NPC(ch) && PRF_FLAGGED(ch, PRF_HOLYLIGHT)))) {
+        if (mode == SHOW_OBJ_LONG)
+          send_to_char(ch, "%s", CCGRN(ch, C_NRM));
+        if (groups[g].num != 1)
+          send_to_char(ch, "(%2i) ", groups[g].num);
+        show_obj_to_char(display, ch, mode);
+        send_to_char(ch, "%s", CCNRM(ch, C_NRM));
+        found = TRUE;
+      }
     }
+
+    free(groups);
+    free(buckets);
   }
   if (!found && show)
     send_to_char(ch, "  Nothing.\r\n");
 }
+#undef SAME_OBJ_GROUP
 
 void diag_char_to_char(struct char_data *i, struct char_data *ch)
 {
@@ -732,27 +780,30 @@ ACMD(do_look)
     send_to_char(ch, "It is pitch black...\r\n");
     list_char_to_char(world[IN_ROOM(ch)].people, ch);	/* glowing red eyes */
   } else {
-    char arg[MAX_INPUT_LENGTH], arg2[MAX_INPUT_LENGTH];
+    char arg[MAX_INPUT_LENGTH];
+    struct arg_list args;
+    struct arg_span *word;
 
-    half_chop(argument, arg, arg2);
+    split_args(argument, &args);
+    word = any_arg_nth(&args, 0);
 
     if (subcmd == SCMD_READ) {
-      if (!*arg)
+      if (!word)
 	send_to_char(ch, "Read what?\r\n");
       else
-	look_at_target(ch, arg);
+	look_at_target(ch, arg_copy(word, arg, sizeof(arg)));
       return;
     }
-    if (!*arg)			/* "look" alone, without an argument at all */
+    if (!word)			/* "look" alone, without an argument at all */
       look_at_room(ch, 1);
-    else if (is_abbrev(arg, "in"))
-      look_in_obj(ch, arg2);
+    else if (arg_is_abbrev(word, "in"))
+      look_in_obj(ch, arg_after(word));
     /* did the char type 'look <direction>?' */
-    else if ((look_type = search_block(arg, dirs, FALSE)) >= 0)
+    else if ((look_type = arg_search(word, dirs, FALSE)) >= 0)
       look_in_direction(ch, look_type);
-    else if (is_abbrev(arg, "at"))
-      look_at_target(ch, arg2);
-    else if (is_abbrev(arg, "around")) {
+    else if (arg_is_abbrev(word, "at"))
+      look_at_target(ch, arg_after(word));
+    else if (arg_is_abbrev(word, "around")) {
       struct extra_descr_data *i;
 
       for (i = world[IN_ROOM(ch)].ex_description; i; i = i->next) {
@@ -765,7 +816,7 @@ ACMD(do_look)
       if (!found)
          send_to_char(ch, "You couldn't find anything noticeable.\r\n");
     } else
-      look_at_target(ch, arg);
+      look_at_target(ch, arg_copy(word, arg, sizeof(arg)));
   }
 }
 
@@ -1088,10 +1139,26 @@ int search_help(const char *argument, int level)
   return NOWHERE;
 }
 
+/* Lists the help entries the help index ranks best for the given words. */
+static int show_help_matches(struct char_data *ch, const char *terms, const char *header)
+{
+  int rows[HELP_SEARCH_RESULTS], num, i;
+
+  if ((num = help_index_search(terms, GET_LEVEL(ch), rows, HELP_SEARCH_RESULTS)) == 0)
+    return 0;
+
+  send_to_char(ch, "%s", header);
+  for (i = 0; i < num; i++)
+    send_to_char(ch, "  \t<send link=\"Help %s\">%s\t</send>\r\n",
+      help_table[rows[i]].keywords, help_table[rows[i]].keywords);
+
+  return num;
+}
+
 ACMD(do_help)
 {
+  char arg[MAX_INPUT_LENGTH], *terms;
   int mid = 0;
-  int i, found = 0;
 
     if (!ch->desc)
     return;
@@ -1111,26 +1178,22 @@ ACMD(do_help)
     return;
   }
 
+  /* help search <words>: search the text of the entries, not just keywords. */
+  terms = one_argument(argument, arg);
+  skip_spaces(&terms);
+  if (*terms && !str_cmp(arg, "search")) {
+    if (!show_help_matches(ch, terms, "Help entries matching your search:\r\n"))
+      send_to_char(ch, "No help entries match that search.\r\n");
+    return;
+  }
+
   space_to_minus(argument);
 
   if ((mid = search_help(argument, GET_LEVEL(ch))) == NOWHERE) {
     send_to_char(ch, "There is no help on that word.\r\n");
     mudlog(NRM, MAX(LVL_IMPL, GET_INVIS_LEV(ch)), TRUE,
       "%s tried to get help on %s", GET_NAME(ch), argument);
-    for (i = 0; i < top_of_helpt; i++)  {
-      if (help_table[i].min_level > GET_LEVEL(ch))
-        continue;
-      /* To help narrow down results, if they don't start with the same letters, move on. */
-      if (*argument != *help_table[i].keywords)
-        continue;
-      if (levenshtein_distance(argument, help_table[i].keywords) <= 2) {
-        if (!found) {
-          send_to_char(ch, "\r\nDid you mean:\r\n");
-          found = 1;
-        }
-        send_to_char(ch, "  \t<send link=\"Help %s\">%s\t</send>\r\n", help_table[i].keywords, help_table[i].keywords);
-      }
-    }
+    show_help_matches(ch, argument, "\r\nDid you mean:\r\n");
     return;
   }
   page_string(ch->desc, help_table[mid].entry, 0);
@@ -2486,6 +2549,11 @@ ACMD(do_whois)
     send_to_char(ch, "MSP:     %s\r\n", prot->bMSP ? "Yes" : "No");
     send_to_char(ch, "ATCP:    %s\r\n", prot->bATCP ? "Yes" : "No");
     send_to_char(ch, "MSDP:    %s\r\n", prot->bMSDP ? "Yes" : "No");
+    send_to_char(ch, "GMCP:    %s\r\n", prot->bGMCP ? "Yes" : "No");
+    send_to_char(ch, "Output:  %ld bytes sent, %d waiting, behind %d time%s, %d message%s skipped\r\n",
+        victim->desc->out_bytes, victim->desc->bufptr - victim->desc->out_sent,
+        victim->desc->out_behind_count, victim->desc->out_behind_count == 1 ? "" : "s",
+        victim->desc->out_skipped_total, victim->desc->out_skipped_total == 1 ? "" : "s");
   }
 
   if (got_from_file)
@@ -23,6 +23,7 @@
 #include "act.h"
 #include "fight.h"
 #include "oasis.h" /* for buildwalk */
+#include "asciimap.h"
 
 
 /* local only functions */
@@ -570,6 +571,13 @@ static void do_doorcmd(struct char_data *ch, struct obj_data *obj, int door, int
     break;
   }
 
+  /* An open door shows on the automap, a closed one does not. */
+  if (!obj && (scmd == SCMD_OPEN || scmd == SCMD_CLOSE)) {
+    map_room_changed(IN_ROOM(ch));
+    if (back)
+      map_room_changed(other_room);
+  }
+
   /* Notify the room. */
   if (len < sizeof(buf))
     snprintf(buf + len, sizeof(buf) - len, "%s%s.",
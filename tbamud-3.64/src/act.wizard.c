@@ -34,6 +34,7 @@
 #include "modify.h"
 #include "quest.h"
 #include "ban.h"
+#include "checkpoint.h"
 #include "screen.h"
 
 /* local utility functions with file scope */
@@ -45,6 +46,7 @@ static void do_stat_object(struct char_data *ch, struct obj_data *j);
 static void do_stat_character(struct char_data *ch, struct char_data *k);
 static void stop_snooping(struct char_data *ch);
 static size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int listall);
+static void show_trigger_stats(struct char_data *ch, int count);
 static struct char_data *is_in_game(long idnum);
 static void mob_checkload(struct char_data *ch, mob_vnum mvnum);
 static void obj_checkload(struct char_data *ch, obj_vnum ovnum);
@@ -2449,6 +2451,53 @@ static size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int l
 	zone_table[zone].builders, KNRM, zone_table[zone].bot, zone_table[zone].top);
 }
 
+static int trigger_fired_cmp(const void *a, const void *b)
+{
+  long fa = trig_index[*(const int *) a]->fired;
+  long fb = trig_index[*(const int *) b]->fired;
+
+  return (fa < fb) - (fa > fb);
+}
+
+/* Lists the triggers that have been started most often since boot. */
+static void show_trigger_stats(struct char_data *ch, int count)
+{
+  char buf[MAX_STRING_LENGTH];
+  int *rnums, i, num = 0;
+  size_t len, nlen;
+
+  if (top_of_trigt <= 0) {
+    send_to_char(ch, "There are no triggers.\r\n");
+    return;
+  }
+
+  CREATE(rnums, int, top_of_trigt);
+  for (i = 0; i < top_of_trigt; i++)
+    if (trig_index[i]->fired)
+      rnums[num++] = i;
+
+  if (!num) {
+    send_to_char(ch, "No triggers have fired since boot.\r\n");
+    free(rnums);
+    return;
+  }
+
+  qsort(rnums, num, sizeof(int), trigger_fired_cmp);
+
+  len = strlcpy(buf, "  VNum      Fired  Name\r\n------- ---------- ------------------------------\r\n", sizeof(buf));
+  for (i = 0; i < num && i < count; i++) {
+    nlen = snprintf(buf + len, sizeof(buf) - len, "[%5d] %10ld  %s\r\n",
+      trig_index[rnums[i]]->vnum, trig_index[rnums[i]]->fired,
+      trig_index[rnums[i]]->proto->name);
+    if (len + nlen >= sizeof(buf))
+      break;
+    len += nlen;
+  }
+
+  free(rnums);
+  page_string(ch->desc, buf, TRUE);
+}
+
 ACMD(do_show)
 {
   int i, j, k, l, con, builder =0;		/* i, j, k to specifics? */
@@ -2484,6 +2533,7 @@ ACMD(do_show)
     { "exp",        LVL_IMMORT },
     { "colour",     LVL_IMMORT },
     { "damage",     LVL_IMMORT },
+    { "triggers",   LVL_IMMORT },			/* 15 */
     { "\n", 0 }
   };
 
@@ -2625,6 +2675,8 @@ ACMD(do_show)
   "  %5d triggers         %5d shops\r\n"
   "  %5d large bufs       %5d autoquests\r\n"
 	"  %5d buf switches     %5d overflows\r\n"
+	"  %5d input lines      %5d queue peak\r\n"
+	"  %5d input floods     %5d output stalls\r\n"
 	"  %5d lists\r\n",
 	i, con,
 	top_of_p_table + 1,
@@ -2633,7 +2685,10 @@ ACMD(do_show)
 	top_of_world + 1, top_of_zone_table + 1,
 	top_of_trigt + 1, top_shop + 1,
 	buf_largecount, total_quests,
-	buf_switches, buf_overflows, global_lists->iSize
+	buf_switches, buf_overflows,
+	input_pool_size, input_queue_peak,
+	input_floods, output_stalls,
+	global_lists->iSize
 	);
     break;
 
@@ -2801,6 +2856,11 @@ ACMD(do_show)
 
     break;
 
+  /* show triggers */
+  case 15:
+    show_trigger_stats(ch, (*value && is_number(value)) ? atoi(value) : 20);
+    break;
+
   /* show what? */
   default:
     send_to_char(ch, "Sorry, I don't understand that.\r\n");
@@ -3541,8 +3601,6 @@ ACMD(do_links)
 /* arbitrary limit for per round dam */
 #define MAX_MOB_DAM_ALLOWED      500
 
-#define ZCMD2 zone_table[zone].cmd[cmd_no]  /*fom DB.C*/
-
 /*item limits*/
 #define MAX_DAM_ALLOWED            50    /* for weapons  - avg. dam*/
 #define MAX_AFFECTS_ALLOWED        3
@@ -3987,10 +4045,19 @@ ACMD (do_zcheck)
 
 }
 
+/* The zone command a reference points at, if it is still there. */
+static struct reset_com *checkload_cmd(struct zone_ref *ref)
+{
+  struct reset_com *c = &zone_table[ref->zone].cmd[ref->cmd_no];
+
+  return (c->command == ref->command ? c : NULL);
+}
+
 static void mob_checkload(struct char_data *ch, mob_vnum mvnum)
 {
-  int cmd_no;
-  zone_rnum zone;
+  struct zone_ref *refs;
+  struct reset_com *c;
+  int i, num;
   mob_rnum mrnum = real_mobile(mvnum);
 
   if (mrnum == NOBODY) {
@@ -4001,30 +4068,21 @@ static void mob_checkload(struct char_data *ch, mob_vnum mvnum)
   send_to_char(ch, "Checking load info for the mob %s...\r\n",
                     mob_proto[mrnum].player.short_descr);
 
-  for (zone=0; zone <= top_of_zone_table; zone++) {
-    for (cmd_no = 0; ZCMD2.command != 'S'; cmd_no++) {
-      if (ZCMD2.command != 'M')
-        continue;
-
-      /* read a mobile */
-      if (ZCMD2.arg1 == mrnum) {
-        send_to_char(ch, "  [%5d] %s (%d MAX)\r\n",
-                         world[ZCMD2.arg3].number,
-                         world[ZCMD2.arg3].name,
-                         ZCMD2.arg2);
-      }
-    }
-  }
+  num = find_zone_refs(ZONE_REF_MOB, mrnum, &refs);
+  for (i = 0; i < num; i++)
+    if ((c = checkload_cmd(&refs[i])) != NULL)
+      send_to_char(ch, "  [%5d] %s (%d MAX)\r\n",
+                       world[refs[i].room].number,
+                       world[refs[i].room].name,
+                       c->arg2);
 }
 
 static void obj_checkload(struct char_data *ch, obj_vnum ovnum)
 {
-  int cmd_no;
-  zone_rnum zone;
+  struct zone_ref *refs, *ref;
+  struct reset_com *c;
+  int i, num;
   obj_rnum ornum = real_object(ovnum);
-  room_vnum lastroom_v = 0;
-  room_rnum lastroom_r = 0;
-  mob_rnum lastmob_r = 0;
 
   if (ornum ==NOTHING) {
     send_to_char(ch, "That object does not exist.\r\n");
@@ -4034,71 +4092,54 @@ static void obj_checkload(struct char_data *ch, obj_vnum ovnum)
   send_to_char(ch, "Checking load info for the obj %s...\r\n",
                    obj_proto[ornum].short_description);
 
-  for (zone=0; zone <= top_of_zone_table; zone++) {
-    for (cmd_no = 0; ZCMD2.command != 'S'; cmd_no++) {
-      switch (ZCMD2.command) {
-        case 'M':
-          lastroom_v = world[ZCMD2.arg3].number;
-          lastroom_r = ZCMD2.arg3;
-          lastmob_r = ZCMD2.arg1;
-          break;
-        case 'O':                   /* read an object */
-          lastroom_v = world[ZCMD2.arg3].number;
-          lastroom_r = ZCMD2.arg3;
-          if (ZCMD2.arg1 == ornum)
-            send_to_char(ch, "  [%5d] %s (%d Max)\r\n",
-                             lastroom_v,
-                             world[lastroom_r].name,
-                             ZCMD2.arg2);
-          break;
-        case 'P':                   /* object to object */
-          if (ZCMD2.arg1 == ornum)
-            send_to_char(ch, "  [%5d] %s (Put in another object [%d Max])\r\n",
-                             lastroom_v,
-                             world[lastroom_r].name,
-                             ZCMD2.arg2);
-          break;
-        case 'G':                   /* obj_to_char */
-          if (ZCMD2.arg1 == ornum)
-            send_to_char(ch, "  [%5d] %s (Given to %s [%d][%d Max])\r\n",
-                             lastroom_v,
-                             world[lastroom_r].name,
-                             mob_proto[lastmob_r].player.short_descr,
-                             mob_index[lastmob_r].vnum,
-                             ZCMD2.arg2);
-          break;
-        case 'E':                   /* object to equipment list */
-          if (ZCMD2.arg1 == ornum)
-            send_to_char(ch, "  [%5d] %s (Equipped to %s [%d][%d Max])\r\n",
-                             lastroom_v,
-                             world[lastroom_r].name,
-                             mob_proto[lastmob_r].player.short_descr,
-                             mob_index[lastmob_r].vnum,
-                             ZCMD2.arg2);
-            break;
-          case 'R': /* rem obj from room */
-            lastroom_v = world[ZCMD2.arg1].number;
-            lastroom_r = ZCMD2.arg1;
-            if (ZCMD2.arg2 == ornum)
-              send_to_char(ch, "  [%5d] %s (Removed from room)\r\n",
-                               lastroom_v,
-                               world[lastroom_r].name);
-            break;
-      }/* switch */
-    } /*for cmd_no......*/
-  }  /*for zone...*/
+  num = find_zone_refs(ZONE_REF_OBJ, ornum, &refs);
+  for (i = 0; i < num; i++) {
+    ref = &refs[i];
+    if (!(c = checkload_cmd(ref)))
+      continue;
+    switch (c->command) {
+      case 'O':                   /* read an object */
+        send_to_char(ch, "  [%5d] %s (%d Max)\r\n",
+                         world[ref->room].number,
+                         world[ref->room].name,
+                         c->arg2);
+        break;
+      case 'P':                   /* object to object */
+        send_to_char(ch, "  [%5d] %s (Put in another object [%d Max])\r\n",
+                         world[ref->room].number,
+                         world[ref->room].name,
+                         c->arg2);
+        break;
+      case 'G':                   /* obj_to_char */
+        send_to_char(ch, "  [%5d] %s (Given to %s [%d][%d Max])\r\n",
+                         world[ref->room].number,
+                         world[ref->room].name,
+                         mob_proto[ref->mob].player.short_descr,
+                         mob_index[ref->mob].vnum,
+                         c->arg2);
+        break;
+      case 'E':                   /* object to equipment list */
+        send_to_char(ch, "  [%5d] %s (Equipped to %s [%d][%d Max])\r\n",
+                         world[ref->room].number,
+                         world[ref->room].name,
+                         mob_proto[ref->mob].player.short_descr,
+                         mob_index[ref->mob].vnum,
+                         c->arg2);
+        break;
+      case 'R': /* rem obj from room */
+        send_to_char(ch, "  [%5d] %s (Removed from room)\r\n",
+                         world[ref->room].number,
+                         world[ref->room].name);
+        break;
+    }
+  }
 }
 
 static void trg_checkload(struct char_data *ch, trig_vnum tvnum)
 {
-  int cmd_no, found = 0;
-  zone_rnum zone;
+  struct zone_ref *refs, *ref;
+  int i, num, found = 0;
   trig_rnum trnum = real_trigger(tvnum);
-  room_vnum lastroom_v = 0;
-  room_rnum lastroom_r = 0, k;
-  mob_rnum lastmob_r = 0, i;
-  obj_rnum lastobj_r = 0, j;
-  struct trig_proto_list *tpl;
 
   if (trnum == NOTHING) {
     send_to_char(ch, "That trigger does not exist.\r\n");
@@ -4110,96 +4151,39 @@ static void trg_checkload(struct char_data *ch, trig_vnum tvnum)
                     (trig_index[trnum]->proto->attach_type == OBJ_TRIGGER ? "object" : "room"),
                     trig_index[trnum]->proto->name);
 
-  for (zone=0; zone <= top_of_zone_table; zone++) {
-    for (cmd_no = 0; ZCMD2.command != 'S'; cmd_no++) {
-      switch (ZCMD2.command) {
-        case 'M':
-          lastroom_v = world[ZCMD2.arg3].number;
-          lastroom_r = ZCMD2.arg3;
-          lastmob_r = ZCMD2.arg1;
-          break;
-        case 'O':                   /* read an object */
-          lastroom_v = world[ZCMD2.arg3].number;
-          lastroom_r = ZCMD2.arg3;
-          lastobj_r = ZCMD2.arg1;
-          break;
-        case 'P':                   /* object to object */
-          lastobj_r = ZCMD2.arg1;
-          break;
-        case 'G':                   /* obj_to_char */
-          lastobj_r = ZCMD2.arg1;
-          break;
-        case 'E':                   /* object to equipment list */
-          lastobj_r = ZCMD2.arg1;
-          break;
-        case 'R':                   /* rem obj from room */
-          lastroom_v = 0;
-          lastroom_r = 0;
-          lastobj_r = 0;
-          lastmob_r = 0;
-        case 'T':                   /* trigger to something */
-          if (ZCMD2.arg2 != trnum)
-            break;
-          if (ZCMD2.arg1 == MOB_TRIGGER) {
-            send_to_char(ch, "mob [%5d] %-60s (zedit room %5d)\r\n",
-                               mob_index[lastmob_r].vnum,
-                               mob_proto[lastmob_r].player.short_descr,
-                               lastroom_v);
-            found = 1;
-          } else if (ZCMD2.arg1 == OBJ_TRIGGER) {
-            send_to_char(ch, "obj [%5d] %-60s  (zedit room %d)\r\n",
-                               obj_index[lastobj_r].vnum,
-                               obj_proto[lastobj_r].short_description,
-                               lastroom_v);
-            found = 1;
-          } else if (ZCMD2.arg1==WLD_TRIGGER) {
-            send_to_char(ch, "room [%5d] %-60s (zedit)\r\n",
-                               lastroom_v,
-                               world[lastroom_r].name);
-            found = 1;
-          }
-        break;
-      } /* switch */
-    } /*for cmd_no......*/
-  }  /*for zone...*/
-
-  for (i = 0; i < top_of_mobt; i++) {
-    if (!mob_proto[i].proto_script)
-      continue;
-
-    for (tpl = mob_proto[i].proto_script;tpl;tpl = tpl->next)
-      if (tpl->vnum == tvnum) {
-        send_to_char(ch, "mob [%5d] %s\r\n",
-                         mob_index[i].vnum,
-                         mob_proto[i].player.short_descr);
-        found = 1;
-      }
-  }
-
-  for (j = 0; j < top_of_objt; j++) {
-    if (!obj_proto[j].proto_script)
-      continue;
-
-    for (tpl = obj_proto[j].proto_script;tpl;tpl = tpl->next)
-      if (tpl->vnum == tvnum) {
-        send_to_char(ch, "obj [%5d] %s\r\n",
-                         obj_index[j].vnum,
-                         obj_proto[j].short_description);
-        found = 1;
-      }
-  }
-
-  for (k = 0;k < top_of_world; k++) {
-    if (!world[k].proto_script)
-      continue;
-
-    for (tpl = world[k].proto_script;tpl;tpl = tpl->next)
-      if (tpl->vnum == tvnum) {
-        send_to_char(ch, "room[%5d] %s\r\n",
-                         world[k].number,
-                         world[k].name);
-        found = 1;
-      }
+  num = find_zone_refs(ZONE_REF_TRIG, trnum, &refs);
+  for (i = 0; i < num; i++) {
+    ref = &refs[i];
+    if (ref->command) {           /* trigger to something */
+      if (!checkload_cmd(ref))
+        continue;
+      if (ref->type == MOB_TRIGGER)
+        send_to_char(ch, "mob [%5d] %-60s (zedit room %5d)\r\n",
+                           mob_index[ref->mob].vnum,
+                           mob_proto[ref->mob].player.short_descr,
+                           world[ref->room].number);
+      else if (ref->type == OBJ_TRIGGER)
+        send_to_char(ch, "obj [%5d] %-60s  (zedit room %d)\r\n",
+                           obj_index[ref->obj].vnum,
+                           obj_proto[ref->obj].short_description,
+                           world[ref->room].number);
+      else if (ref->type == WLD_TRIGGER)
+        send_to_char(ch, "room [%5d] %-60s (zedit)\r\n",
+                           world[ref->room].number,
+                           world[ref->room].name);
+    } else if (ref->type == MOB_TRIGGER)
+      send_to_char(ch, "mob [%5d] %s\r\n",
+                       mob_index[ref->mob].vnum,
+                       mob_proto[ref->mob].player.short_descr);
+    else if (ref->type == OBJ_TRIGGER)
+      send_to_char(ch, "obj [%5d] %s\r\n",
+                       obj_index[ref->obj].vnum,
+                       obj_proto[ref->obj].short_description);
+    else
+      send_to_char(ch, "room[%5d] %s\r\n",
+                       world[ref->room].number,
+                       world[ref->room].name);
+    found = 1;
   }
 
   if (!found)
@@ -4281,6 +4265,9 @@ ACMD(do_copyover)
   fprintf (fp, "-1\n");
   fclose (fp);
 
+  /* The mobs and objects in the world carry over too. */
+  checkpoint_save();
+
   /* exec - descriptors are inherited */
   sprintf (buf, "%d", port);
   sprintf (buf2, "-C%d", mother_desc);
@@ -4289,6 +4276,7 @@ ACMD(do_copyover)
   i = chdir ("..");
 
   /* Close reserve and other always-open files and release other resources */
+   flush_log(TRUE);
    execl (EXE_FILE, "circle", buf2, buf, (char *) NULL);
 
    /* Failed - successful exec will not return */
@@ -4769,6 +4757,10 @@ bool change_player_name(struct char_data *ch, struct char_data *vict, char *new_
   /* Rename the player's pfile */
   sprintf(buf, "mv %s %s", old_pfile, new_pfile);
   j = system(buf);
+  /* ...or the binary one, if that is what it was last saved as. */
+  if (get_filename(old_pfile, sizeof(old_pfile), PLR_BIN_FILE, old_name) &&
+      get_filename(new_pfile, sizeof(new_pfile), PLR_BIN_FILE, new_name))
+    rename(old_pfile, new_pfile);
 
   /* Save the changed player index - the pfile is saved by perform_set */
   save_player_index();
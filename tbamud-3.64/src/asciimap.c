@@ -70,6 +70,7 @@ struct map_info_type
 {
   int  sector_type;
   char disp[20];
+  int  len;       /* strlen(disp), filled in by map_lengths() */
 };
 
 static struct map_info_type door_info[] =
@@ -185,6 +186,35 @@ static struct map_info_type world_map_info[] =
 
 
 static int map[MAX_MAP][MAX_MAP];
+
+/* Minimap tiles. The automap beside a room description only changes when
+ * the exits or sectors of the rooms it was drawn from do, so the map drawn
+ * for each room is kept along with the rooms MapArea() looked at for it.
+ * map_room_changed() stamps a room, and a tile drawn before any of its rooms
+ * was last stamped is drawn again. */
+#define MAP_TILE_WORLD     (1 << 0)
+#define MAP_TILE_HOLYLIGHT (1 << 1)
+
+struct map_tile
+{
+  int variant;         /* MAP_TILE_ bits it was drawn for */
+  int size;            /* CONFIG_MINIMAP_SIZE it was drawn at */
+  long drawn;          /* map_clock when it was drawn */
+  room_rnum *rooms;    /* rooms MapArea() looked at */
+  int num_rooms;
+  char *text;
+  struct map_tile *next;
+};
+
+static struct map_tile **map_tiles = NULL;  /* by room rnum */
+static long *map_stamps = NULL;             /* by room rnum */
+static int map_tiles_size = 0;
+static long map_clock = 0;
+
+/* Rooms looked at by the MapArea() in progress, when drawing a tile. */
+static room_rnum *map_seen = NULL;
+static int num_seen = 0, max_seen = 0;
+static bool map_seeing = FALSE;
 /*
 static int offsets[4][2] ={ {-2, 0},{ 0, 2},{ 2, 0},{ 0, -2} };
 static int offsets_worldmap[4][2] ={ {-1, 0},{ 0, 1},{ 1, 0},{ 0, -1} };
@@ -208,6 +238,11 @@ static char *StringMap(int centre, int size);
 static char *WorldMap(int centre, int size, int mapshape, int maptype );
 static char *CompactStringMap(int centre, int size);
 static void perform_map( struct char_data *ch, char *argument, bool worldmap );
+static void map_lengths(void);
+static void map_saw(room_rnum room);
+static void free_map_tile(struct map_tile *tile);
+static struct map_tile *find_map_tile(room_rnum room, int variant, int size);
+static void keep_map_tile(room_rnum room, int variant, int size, const char *text);
 /******************************************************************************
  * End Local (File Scope) Function Prototypes
  *****************************************************************************/
@@ -234,6 +269,8 @@ static void MapArea(room_rnum room, struct char_data *ch, int x, int y, int min,
   if (map[x][y] < 0)
     return; /* this is a door */
 
+  map_saw(room);
+
   /* marks the room as visited */
   if(room == IN_ROOM(ch))
     map[x][y] = SECT_HERE;
@@ -295,6 +332,7 @@ static void MapArea(room_rnum room, struct char_data *ch, int x, int y, int min,
 
  /*     if ( (x < min) || ( y < min) || ( x > max ) || ( y > max) ) return;*/
       prospect_room = pexit->to_room;
+      map_saw(prospect_room);
 
         /* one way into area OR maze */
         if ( world[prospect_room].dir_option[rev_dir[door]] &&
@@ -357,23 +395,25 @@ static char *StringMap(int centre, int size)
 {
   static char strmap[MAX_MAP*MAX_MAP*11 + MAX_MAP*2 + 1];
   char *mp = strmap;
-  char *tmp;
+  struct map_info_type *tmp;
   int x, y;
 
+  map_lengths();
+
   /* every row */
   for (x = centre - CANVAS_HEIGHT/2; x <= centre + CANVAS_HEIGHT/2; x++) {
     /* every column */
     for (y = centre - CANVAS_WIDTH/6; y <= centre + CANVAS_WIDTH/6; y++) {
       if (abs(centre - x)<=size && abs(centre-y)<=size)
         tmp = (map[x][y]<0) ? \
-       door_info[NUM_DOOR_TYPES + map[x][y]].disp : \
-       map_info[map[x][y]].disp ;
+       &door_info[NUM_DOOR_TYPES + map[x][y]] : \
+       &map_info[map[x][y]] ;
       else
- tmp = map_info[SECT_EMPTY].disp;
-      strcpy(mp, tmp);
-      mp += strlen(tmp);
+ tmp = &map_info[SECT_EMPTY];
+      memcpy(mp, tmp->disp, tmp->len);
+      mp += tmp->len;
     }
-    strcpy(mp, "\r\n");
+    memcpy(mp, "\r\n", 2);
     mp+=2;
   }
   *mp='\0';
@@ -387,6 +427,8 @@ static char *WorldMap(int centre, int size, int mapshape, int maptype )
   int x, y;
   int xmin, xmax, ymin, ymax;
 
+  map_lengths();
+
   switch(maptype) {
     case MAP_COMPACT:
       xmin = centre - size;
@@ -411,13 +453,13 @@ static char *WorldMap(int centre, int size, int mapshape, int maptype )
 
       if((mapshape == MAP_RECTANGLE && abs(centre - y) <= size*2  && abs(centre - x) <= size ) ||
    ((mapshape == MAP_CIRCLE) && (centre-x)*(centre-x) + (centre-y)*(centre-y)/4 <= (size * size + 1))) {
-        strcpy(mp, world_map_info[map[x][y]].disp);
-        mp += strlen(world_map_info[map[x][y]].disp);
+        memcpy(mp, world_map_info[map[x][y]].disp, world_map_info[map[x][y]].len);
+        mp += world_map_info[map[x][y]].len;
       } else {
- strcpy(mp++, " ");
+ *mp++ = ' ';
       }
     }
-    strcpy(mp, "\tn\r\n");
+    memcpy(mp, "\tn\r\n", 4);
     mp+=4;
   }
   *mp='\0';
@@ -428,20 +470,22 @@ static char *CompactStringMap(int centre, int size)
 {
   static char strmap[MAX_MAP*MAX_MAP*12 + MAX_MAP*2 + 1];
   char *mp = strmap;
+  struct map_info_type *tmp;
   int x, y;
 
+  map_lengths();
+
   /* every row */
   for (x = centre - size; x <= centre + size; x++) {
     /* every column */
     for (y = centre - size; y <= centre + size; y++) {
-      strcpy(mp, (map[x][y]<0) ? \
-       compact_door_info[NUM_DOOR_TYPES + map[x][y]].disp : \
-       map_info[map[x][y]].disp);
-      mp += strlen((map[x][y]<0) ? \
-       compact_door_info[NUM_DOOR_TYPES + map[x][y]].disp : \
-       map_info[map[x][y]].disp);
+      tmp = (map[x][y]<0) ? \
+       &compact_door_info[NUM_DOOR_TYPES + map[x][y]] : \
+       &map_info[map[x][y]];
+      memcpy(mp, tmp->disp, tmp->len);
+      mp += tmp->len;
     }
-    strcpy(mp, "\r\n");
+    memcpy(mp, "\r\n", 2);
     mp+=2;
   }
   *mp='\0';
@@ -548,9 +592,11 @@ static void perform_map( struct char_data *ch, char *argument, bool worldmap )
 
 /* Display a string with the map beside it */
 void str_and_map(char *str, struct char_data *ch, room_vnum target_room ) {
-  int size, centre, x, y, min, max, char_size;
+  int size, centre, x, y, min, max, char_size, variant;
   int ew_size=0, ns_size=0;
   bool worldmap;
+  struct map_tile *tile = NULL;
+  char *mapstr;
 
   /* Check MUDs map config options - if disabled, just show room decsription */
   if (!can_see_map(ch)) {
@@ -569,14 +615,37 @@ void str_and_map(char *str, struct char_data *ch, room_vnum target_room ) {
   centre = MAX_MAP/2;
   min = centre - 2*size;
   max = centre + 2*size;
+  variant = (worldmap ? MAP_TILE_WORLD : 0) |
+            (PRF_FLAGGED(ch, PRF_HOLYLIGHT) ? MAP_TILE_HOLYLIGHT : 0);
 
-  for (x = 0; x < MAX_MAP; ++x)
-    for (y = 0; y < MAX_MAP; ++y)
-      map[x][y]= (!(y%2) && !worldmap) ? DOOR_NONE : SECT_EMPTY;
+  /* Only the map of the room ch stands in is kept; it marks ch there. */
+  if (target_room == IN_ROOM(ch))
+    tile = find_map_tile(target_room, variant, size);
 
-  /* starts the mapping with the center room */
-MapArea(target_room, ch, centre, centre, min, max, ns_size/2, ew_size/2, worldmap ); 
-  map[centre][centre] = SECT_HERE;
+  if (tile)
+    mapstr = tile->text;
+  else {
+    for (x = 0; x < MAX_MAP; ++x)
+      for (y = 0; y < MAX_MAP; ++y)
+        map[x][y]= (!(y%2) && !worldmap) ? DOOR_NONE : SECT_EMPTY;
+
+    num_seen = 0;
+    map_seeing = (target_room == IN_ROOM(ch));
+
+    /* starts the mapping with the center room */
+    MapArea(target_room, ch, centre, centre, min, max, ns_size/2, ew_size/2, worldmap );
+    map[centre][centre] = SECT_HERE;
+
+    map_seeing = FALSE;
+
+    if(worldmap)
+      mapstr = WorldMap(centre, size, MAP_CIRCLE, MAP_COMPACT);
+    else
+      mapstr = CompactStringMap(centre, size);
+
+    if (target_room == IN_ROOM(ch))
+      keep_map_tile(target_room, variant, size, mapstr);
+  }
 
   /* char_size = rooms + doors + padding */
   if(worldmap)
@@ -584,11 +653,134 @@ MapArea(target_room, ch, centre, centre, min, max, ns_size/2, ew_size/2, worldma
   else
     char_size = 3*(size+1) + (size) + 4;
 
-  if(worldmap)
-    send_to_char(ch, "%s", strpaste(strfrmt(str, GET_SCREEN_WIDTH(ch) - char_size, size*2 + 1, FALSE, TRUE, TRUE), WorldMap(centre, size, MAP_CIRCLE, MAP_COMPACT), " \tn"));
-  else
-    send_to_char(ch, "%s", strpaste(strfrmt(str, GET_SCREEN_WIDTH(ch) - char_size, size*2 + 1, FALSE, TRUE, TRUE), CompactStringMap(centre, size), " \tn"));
+  send_to_char(ch, "%s", strpaste(strfrmt(str, GET_SCREEN_WIDTH(ch) - char_size, size*2 + 1, FALSE, TRUE, TRUE), mapstr, " \tn"));
+}
+
+/* Fills in the display lengths of the map symbols, once. */
+static void map_lengths(void)
+{
+  static bool done = FALSE;
+  size_t i;
+
+  if (done)
+    return;
+
+  for (i = 0; i < sizeof(door_info) / sizeof(door_info[0]); i++)
+    door_info[i].len = strlen(door_info[i].disp);
+  for (i = 0; i < sizeof(compact_door_info) / sizeof(compact_door_info[0]); i++)
+    compact_door_info[i].len = strlen(compact_door_info[i].disp);
+  for (i = 0; i < sizeof(map_info) / sizeof(map_info[0]); i++)
+    map_info[i].len = strlen(map_info[i].disp);
+  for (i = 0; i < sizeof(world_map_info) / sizeof(world_map_info[0]); i++)
+    world_map_info[i].len = strlen(world_map_info[i].disp);
+
+  done = TRUE;
+}
+
+/* Notes a room the tile being drawn depends on. */
+static void map_saw(room_rnum room)
+{
+  if (!map_seeing)
+    return;
+
+  if (num_seen >= max_seen) {
+    max_seen = max_seen ? max_seen * 2 : 64;
+    RECREATE(map_seen, room_rnum, max_seen);
+  }
+  map_seen[num_seen++] = room;
+}
+
+static void free_map_tile(struct map_tile *tile)
+{
+  if (tile->rooms)
+    free(tile->rooms);
+  free(tile->text);
+  free(tile);
+}
+
+/* Returns the tile kept for room, if it is still good. */
+static struct map_tile *find_map_tile(room_rnum room, int variant, int size)
+{
+  struct map_tile *tile, **prev;
+  int i;
+
+  /* The world array has grown or shrunk under us. */
+  if (map_tiles_size != top_of_world + 1) {
+    map_tiles_changed();
+    map_tiles_size = top_of_world + 1;
+    CREATE(map_tiles, struct map_tile *, map_tiles_size);
+    CREATE(map_stamps, long, map_tiles_size);
+    return NULL;
+  }
+
+  for (prev = &map_tiles[room]; (tile = *prev); prev = &tile->next) {
+    if (tile->variant != variant)
+      continue;
+
+    for (i = 0; i < tile->num_rooms; i++)
+      if (map_stamps[tile->rooms[i]] > tile->drawn)
+        break;
+
+    if (tile->size == size && i == tile->num_rooms)
+      return tile;
+
+    *prev = tile->next;
+    free_map_tile(tile);
+    return NULL;
+  }
+
+  return NULL;
+}
+
+static void keep_map_tile(room_rnum room, int variant, int size, const char *text)
+{
+  struct map_tile *tile;
+
+  if (!map_tiles || room >= map_tiles_size)
+    return;
+
+  CREATE(tile, struct map_tile, 1);
+  tile->variant = variant;
+  tile->size = size;
+  tile->drawn = map_clock;
+  if ((tile->num_rooms = num_seen) > 0) {
+    CREATE(tile->rooms, room_rnum, num_seen);
+    memcpy(tile->rooms, map_seen, num_seen * sizeof(room_rnum));
+  }
+  tile->text = strdup(text);
+  tile->next = map_tiles[room];
+  map_tiles[room] = tile;
+}
+
+/** Marks a room whose exits or sector have changed, so that the minimaps
+ * drawn through it are drawn again.
+ * @param room The room that changed. */
+void map_room_changed(room_rnum room)
+{
+  if (map_stamps && room < map_tiles_size)
+    map_stamps[room] = ++map_clock;
+}
+
+/** Throws away every minimap tile. For changes to the world as a whole,
+ * such as rooms being added or removed in OLC. */
+void map_tiles_changed(void)
+{
+  struct map_tile *tile;
+  int i;
+
+  for (i = 0; i < map_tiles_size; i++)
+    while ((tile = map_tiles[i])) {
+      map_tiles[i] = tile->next;
+      free_map_tile(tile);
+    }
 
+  if (map_tiles)
+    free(map_tiles);
+  if (map_stamps)
+    free(map_stamps);
+  map_tiles = NULL;
+  map_stamps = NULL;
+  map_tiles_size = 0;
 }
 
 static bool show_worldmap(struct char_data *ch) {
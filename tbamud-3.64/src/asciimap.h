@@ -18,6 +18,8 @@
 /* Exported function prototypes */
 bool can_see_map(struct char_data *ch);
 void str_and_map(char *str, struct char_data *ch, room_vnum target_room );
+void map_room_changed(room_rnum room);
+void map_tiles_changed(void);
 ACMD(do_map);
 
 #endif /* ASCIIMAP_H_*/
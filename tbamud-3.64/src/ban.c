@@ -28,9 +28,47 @@ int num_invalid = 0;
 #define MAX_INVALID_NAMES 200
 static char *invalid_list[MAX_INVALID_NAMES];
 
+/* The ban list compiled for isbanned(): an Aho-Corasick automaton over the
+ * site substrings, and a binary radix tree over the address/bits ranges. Both
+ * are rebuilt from ban_list whenever it changes. */
+struct ban_match_node {
+  char c;        /* character leading to this node */
+  int child;     /* first child, 0 if none */
+  int sibling;   /* next child of the same parent, 0 if none */
+  int fail;      /* longest proper suffix that is also a trie path */
+  int type;      /* highest ban type of any site ending here or on a suffix */
+};
+
+struct ban_range_node {
+  int child[2];  /* next bit 0/1, 0 if none */
+  int type;      /* highest ban type of a range ending here */
+};
+
+static struct ban_match_node *ban_match = NULL;
+static int ban_match_top = 0, ban_match_max = 0;
+static struct ban_range_node *ban_range = NULL;
+static int ban_range_top = 0, ban_range_max = 0;
+
+/* Connection throttling, one slot per /24 network. Colliding networks share
+ * a slot and simply reset each other's count. */
+#define BAN_THROTTLE_SLOTS 1024
+
+struct ban_throttle {
+  unsigned long prefix;
+  time_t start;  /* start of the current window */
+  int count;     /* connections seen in it */
+};
+
+static struct ban_throttle ban_throttle_table[BAN_THROTTLE_SLOTS];
+
 /* local utility functions */
 static void write_ban_list(void);
 static void _write_one_node(FILE *fp, struct ban_list_element *node);
+static bool parse_address(const char *str, unsigned long *addr, int *bits);
+static int ban_match_child(int node, char c);
+static int ban_match_add(int parent, char c);
+static int ban_range_add(int parent, int bit);
+static void build_ban_matcher(void);
 
 static const char *ban_types[] = {
   "no",
@@ -74,28 +112,204 @@ void load_banned(void)
   }
 
   fclose(fl);
+  build_ban_matcher();
 }
 
-int isbanned(char *hostname)
+/* Reads a dotted quad, optionally followed by /bits, into a host order
+ * address. Without /bits the whole address (32 bits) is meant. */
+static bool parse_address(const char *str, unsigned long *addr, int *bits)
+{
+  int part, i, val;
+
+  *addr = 0;
+  for (part = 0; part < 4; part++) {
+    if (part && *str++ != '.')
+      return (FALSE);
+    if (!isdigit(*str))
+      return (FALSE);
+    for (val = 0, i = 0; isdigit(*str) && i < 3; i++)
+      val = val * 10 + (*str++ - '0');
+    if (val > 255 || isdigit(*str))
+      return (FALSE);
+    *addr = (*addr << 8) | val;
+  }
+
+  if (!*str) {
+    *bits = 32;
+    return (TRUE);
+  }
+  if (*str++ != '/' || !isdigit(*str))
+    return (FALSE);
+  for (val = 0; isdigit(*str) && val <= 32; str++)
+    val = val * 10 + (*str - '0');
+  if (*str || val > 32)
+    return (FALSE);
+
+  *bits = val;
+  return (TRUE);
+}
+
+static int ban_match_child(int node, char c)
 {
   int i;
-  struct ban_list_element *banned_node;
+
+  for (i = ban_match[node].child; i; i = ban_match[i].sibling)
+    if (ban_match[i].c == c)
+      return (i);
+
+  return (0);
+}
+
+static int ban_match_add(int parent, char c)
+{
+  int node;
+
+  if ((node = ban_match_child(parent, c)) != 0)
+    return (node);
+
+  if (ban_match_top == ban_match_max) {
+    ban_match_max *= 2;
+    RECREATE(ban_match, struct ban_match_node, ban_match_max);
+  }
+  node = ban_match_top++;
+  ban_match[node].c = c;
+  ban_match[node].child = 0;
+  ban_match[node].sibling = ban_match[parent].child;
+  ban_match[node].fail = 0;
+  ban_match[node].type = BAN_NOT;
+  ban_match[parent].child = node;
+
+  return (node);
+}
+
+static int ban_range_add(int parent, int bit)
+{
+  int node;
+
+  if ((node = ban_range[parent].child[bit]) != 0)
+    return (node);
+
+  if (ban_range_top == ban_range_max) {
+    ban_range_max *= 2;
+    RECREATE(ban_range, struct ban_range_node, ban_range_max);
+  }
+  node = ban_range_top++;
+  ban_range[node].child[0] = ban_range[node].child[1] = 0;
+  ban_range[node].type = BAN_NOT;
+  ban_range[parent].child[bit] = node;
+
+  return (node);
+}
+
+/* Compiles ban_list. Sites written as address/bits go into the range tree,
+ * everything else is matched as a substring of the hostname, as always. */
+static void build_ban_matcher(void)
+{
+  struct ban_list_element *ban_node;
+  unsigned long addr;
+  int node, bits, i, head, tail, *queue, child, f;
+  char *p;
+
+  ban_match_top = ban_range_top = 1;
+  if (!ban_match) {
+    ban_match_max = ban_range_max = 64;
+    CREATE(ban_match, struct ban_match_node, ban_match_max);
+    CREATE(ban_range, struct ban_range_node, ban_range_max);
+  }
+  memset(ban_match, 0, sizeof(struct ban_match_node));
+  memset(ban_range, 0, sizeof(struct ban_range_node));
+
+  for (ban_node = ban_list; ban_node; ban_node = ban_node->next) {
+    if (strchr(ban_node->site, '/') && parse_address(ban_node->site, &addr, &bits)) {
+      for (node = 0, i = 0; i < bits; i++)
+        node = ban_range_add(node, (addr >> (31 - i)) & 1);
+      ban_range[node].type = MAX(ban_range[node].type, ban_node->type);
+      continue;
+    }
+    if (!*ban_node->site)
+      continue;
+    for (node = 0, p = ban_node->site; *p; p++)
+      node = ban_match_add(node, LOWER(*p));
+    ban_match[node].type = MAX(ban_match[node].type, ban_node->type);
+  }
+
+  /* Breadth first, so every node's fail target is finished before its own
+   * children need it. */
+  CREATE(queue, int, ban_match_top);
+  head = tail = 0;
+  for (child = ban_match[0].child; child; child = ban_match[child].sibling)
+    queue[tail++] = child;
+
+  while (head < tail) {
+    node = queue[head++];
+    for (child = ban_match[node].child; child; child = ban_match[child].sibling) {
+      for (f = ban_match[node].fail; f && !ban_match_child(f, ban_match[child].c); f = ban_match[f].fail)
+        ;
+      ban_match[child].fail = ban_match_child(f, ban_match[child].c);
+      ban_match[child].type = MAX(ban_match[child].type, ban_match[ban_match[child].fail].type);
+      queue[tail++] = child;
+    }
+  }
+  free(queue);
+}
+
+/* Site bans are matched against the hostname, and address ranges against
+ * addr, the numeric peer address. An addr of 0 falls back to reading the
+ * address from the hostname. */
+int isbanned(char *hostname, unsigned long addr)
+{
+  int i, node, bits;
   char *nextchar;
 
-  if (!hostname || !*hostname)
+  if (!hostname || !*hostname || !ban_match)
     return (0);
 
   i = 0;
-  for (nextchar = hostname; *nextchar; nextchar++)
+  for (node = 0, nextchar = hostname; *nextchar; nextchar++) {
     *nextchar = LOWER(*nextchar);
+    while (node && !ban_match_child(node, *nextchar))
+      node = ban_match[node].fail;
+    node = ban_match_child(node, *nextchar);
+    i = MAX(i, ban_match[node].type);
+  }
 
-  for (banned_node = ban_list; banned_node; banned_node = banned_node->next)
-    if (strstr(hostname, banned_node->site))	/* if hostname is a substring */
-      i = MAX(i, banned_node->type);
+  if (ban_range_top > 1 && (addr || parse_address(hostname, &addr, &bits)))
+    for (node = 0, bits = 0; ; bits++) {
+      i = MAX(i, ban_range[node].type);
+      if (bits == 32 || !(node = ban_range[node].child[(addr >> (31 - bits)) & 1]))
+        break;
+    }
 
   return (i);
 }
 
+/* Counts a new connection from addr (host order) against its /24 network.
+ * Returns TRUE once the network has opened more than BAN_THROTTLE_CONNECTS
+ * connections within BAN_THROTTLE_WINDOW seconds. Loopback is never
+ * throttled. */
+bool ban_throttled(unsigned long addr)
+{
+  struct ban_throttle *slot;
+  unsigned long prefix = addr >> 8;
+  time_t now = time(0);
+
+  if ((addr >> 24) == 127)
+    return (FALSE);
+
+  slot = ban_throttle_table + (prefix ^ (prefix >> 12)) % BAN_THROTTLE_SLOTS;
+  if (slot->prefix != prefix || now - slot->start >= BAN_THROTTLE_WINDOW) {
+    slot->prefix = prefix;
+    slot->start = now;
+    slot->count = 0;
+  }
+
+  if (++slot->count == BAN_THROTTLE_CONNECTS + 1)
+    mudlog(CMP, LVL_GOD, TRUE, "Throttling connections from %lu.%lu.%lu.0/24",
+      (prefix >> 16) & 255, (prefix >> 8) & 255, prefix & 255);
+
+  return (slot->count > BAN_THROTTLE_CONNECTS);
+}
+
 static void _write_one_node(FILE *fp, struct ban_list_element *node)
 {
   if (node) {
@@ -190,6 +404,7 @@ ACMD(do_ban)
 	GET_NAME(ch), site, ban_types[ban_node->type]);
   send_to_char(ch, "Site banned.\r\n");
   write_ban_list();
+  build_ban_matcher();
 }
 #undef BAN_LIST_FORMAT
 
@@ -223,6 +438,7 @@ ACMD(do_unban)
 
   free(ban_node);
   write_ban_list();
+  build_ban_matcher();
 }
 
 
@@ -25,6 +25,12 @@
 #define BAN_ALL   3
 
 #define BANNED_SITE_LENGTH    50
+
+/* A /24 network opening more than BAN_THROTTLE_CONNECTS connections within
+ * BAN_THROTTLE_WINDOW seconds has the rest of them refused. */
+#define BAN_THROTTLE_WINDOW   10
+#define BAN_THROTTLE_CONNECTS 10
+
 struct ban_list_element {
    char site[BANNED_SITE_LENGTH+1];
    int  type;
@@ -36,7 +42,8 @@ struct ban_list_element {
 /* Global functions */
 /* Utility Functions */
 void load_banned(void);
-int isbanned(char *hostname);
+int isbanned(char *hostname, unsigned long addr);
+bool ban_throttled(unsigned long addr);
 int valid_name(char *newname);
 void read_invalid_list(void);
 void free_invalid_list(void);
@@ -124,6 +124,8 @@ static void cedit_setup(struct descriptor_data *d)
   OLC_CONFIG(d)->operation.max_playing        = CONFIG_MAX_PLAYING;
   OLC_CONFIG(d)->operation.max_filesize       = CONFIG_MAX_FILESIZE;
   OLC_CONFIG(d)->operation.max_bad_pws        = CONFIG_MAX_BAD_PWS;
+  OLC_CONFIG(d)->operation.max_input_queue    = CONFIG_MAX_INPUT_QUEUE;
+  OLC_CONFIG(d)->operation.binary_pfiles      = CONFIG_BINARY_PFILES;
   OLC_CONFIG(d)->operation.siteok_everyone    = CONFIG_SITEOK_ALL;
   OLC_CONFIG(d)->operation.use_new_socials    = CONFIG_NEW_SOCIALS;
   OLC_CONFIG(d)->operation.auto_save_olc      = CONFIG_OLC_SAVE;
@@ -227,6 +229,8 @@ static void cedit_save_internally(struct descriptor_data *d)
   CONFIG_MAX_PLAYING        = OLC_CONFIG(d)->operation.max_playing;
   CONFIG_MAX_FILESIZE       = OLC_CONFIG(d)->operation.max_filesize;
   CONFIG_MAX_BAD_PWS        = OLC_CONFIG(d)->operation.max_bad_pws;
+  CONFIG_MAX_INPUT_QUEUE    = OLC_CONFIG(d)->operation.max_input_queue;
+  CONFIG_BINARY_PFILES      = OLC_CONFIG(d)->operation.binary_pfiles;
   CONFIG_SITEOK_ALL    = OLC_CONFIG(d)->operation.siteok_everyone;
   CONFIG_NEW_SOCIALS        = OLC_CONFIG(d)->operation.use_new_socials;
   CONFIG_NS_IS_SLOW = OLC_CONFIG(d)->operation.nameserver_is_slow;
@@ -487,6 +491,14 @@ int save_config( IDXTYPE nowhere )
               "max_bad_pws = %d\n\n",
               CONFIG_MAX_BAD_PWS);
 
+  fprintf(fl, "* Maximum number of commands queued before disconnecting for flooding.\n"
+              "max_input_queue = %d\n\n",
+              CONFIG_MAX_INPUT_QUEUE);
+
+  fprintf(fl, "* Save player files in the binary format (1) or as ASCII (0).\n"
+              "binary_pfiles = %d\n\n",
+              CONFIG_BINARY_PFILES);
+
   fprintf(fl, "* Is the site ok for everyone except those that are banned?\n"
               "siteok_everyone = %d\n\n",
               CONFIG_SITEOK_ALL);
@@ -745,6 +757,8 @@ static void cedit_disp_operation_options(struct descriptor_data *d)
   	"%sR%s) Enable Protocol Negotiation : %s%s\r\n"
   	"%sS%s) Enable Special Char in Comm : %s%s\r\n"
   	"%sT%s) Current Debug Mode : %s%s\r\n"
+  	"%sU%s) Max Queued Commands : %s%d\r\n"
+  	"%sV%s) Binary Player Files : %s%s\r\n"
     "%sQ%s) Exit To The Main Menu\r\n"
     "Enter your choice : ",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.DFLT_PORT,
@@ -766,6 +780,8 @@ static void cedit_disp_operation_options(struct descriptor_data *d)
     grn, nrm, cyn, OLC_CONFIG(d)->operation.protocol_negotiation ? "Yes" : "No",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.special_in_comm ? "Yes" : "No",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.debug_mode == 0 ? "OFF" : (OLC_CONFIG(d)->operation.debug_mode == 1 ? "BRIEF" : (OLC_CONFIG(d)->operation.debug_mode == 2 ? "NORMAL" : "COMPLETE")),
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.max_input_queue,
+    grn, nrm, cyn, YESNO(OLC_CONFIG(d)->operation.binary_pfiles),
     grn, nrm
     );
 
@@ -1255,6 +1271,17 @@ void cedit_parse(struct descriptor_data *d, char *arg)
            OLC_MODE(d) = CEDIT_DEBUG_MODE;
            return;
 
+         case 'u':
+         case 'U':
+           write_to_output(d, "Enter the maximum number of queued commands (0 for no limit) : ");
+           OLC_MODE(d) = CEDIT_MAX_INPUT_QUEUE;
+           return;
+
+         case 'v':
+         case 'V':
+           TOGGLE_VAR(OLC_CONFIG(d)->operation.binary_pfiles);
+           break;
+
          case 'q':
          case 'Q':
            cedit_disp_menu(d);
@@ -1633,6 +1660,11 @@ void cedit_parse(struct descriptor_data *d, char *arg)
       cedit_disp_operation_options(d);
       break;
 
+    case CEDIT_MAX_INPUT_QUEUE:
+      OLC_CONFIG(d)->operation.max_input_queue = LIMIT(atoi(arg), 0, INPUT_Q_SLOTS);
+      cedit_disp_operation_options(d);
+      break;
+
     case CEDIT_MIN_WIZLIST_LEV:
       if (atoi(arg) > LVL_IMPL) {
         write_to_output(d,
@@ -0,0 +1,593 @@
+/**
+* @file checkpoint.c
+* World checkpoint for copyover. Before the exec, the mobiles in the world,
+* the objects lying about or held by them, room scripts, queued mud events,
+* zone ages, fights, followers and groups are written to COPYOVER_WORLD_FILE. The new process
+* loads them in place of the boot-time zone resets, and links fights,
+* followers and groups back up once the players have been restored.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "interpreter.h"
+#include "handler.h"
+#include "db.h"
+#include "dg_scripts.h"
+#include "fight.h"
+#include "house.h"
+#include "mud_event.h"
+#include "checkpoint.h"
+
+/* The checkpoint being restored, from checkpoint_open() until
+ * checkpoint_finish(). */
+static FILE *checkpoint_fp = NULL;
+
+/* Mobs and objects restored so far, to find the holder of each object.
+ * A holder is always written just before what it holds, so these are
+ * searched from the end. */
+struct checkpoint_thing {
+  long id;
+  void *thing;
+};
+
+static struct checkpoint_thing *restored_mobs = NULL, *restored_objs = NULL;
+static int num_mobs = 0, max_mobs = 0, num_objs = 0, max_objs = 0;
+
+/* local functions */
+static void save_obj(FILE *fp, struct obj_data *obj, char where, long key, int pos);
+static void save_obj_list(FILE *fp, struct obj_data *list, char where, long key);
+static void save_events(FILE *fp, struct list_data *events);
+static void save_mob(FILE *fp, struct char_data *mob);
+static void save_mob_list(FILE *fp, struct char_data *list);
+static int checkpoint_line(char *buf, size_t len);
+static void remember_thing(struct checkpoint_thing **list, int *num, int *max, long id, void *thing);
+static void *find_thing(struct checkpoint_thing *list, int num, long id);
+static void restore_id(long *idp, long id, void *thing);
+static struct char_data *restore_mob(char *line);
+static struct obj_data *restore_obj(char *line);
+static bool read_mob_line(struct char_data *mob, char *line);
+static bool read_event_line(void *go, int type, char *line);
+static struct char_data *checkpoint_char(long id);
+static void restore_group(char *line);
+
+/* Writes obj and everything in it. The weight written for a container is
+ * its own, as putting the contents back in adds theirs. */
+static void save_obj(FILE *fp, struct obj_data *obj, char where, long key, int pos)
+{
+  struct obj_data *tmp;
+  int contained = 0;
+
+  for (tmp = obj->contains; tmp; tmp = tmp->next_content)
+    contained += GET_OBJ_WEIGHT(tmp);
+
+  fprintf(fp, "#O %ld %c %ld %d %d\n", GET_ID(obj), where, key, pos, GET_OBJ_TIMER(obj));
+  GET_OBJ_WEIGHT(obj) -= contained;
+  objsave_save_obj_record(obj, fp, 0);
+  GET_OBJ_WEIGHT(obj) += contained;
+  fprintf(fp, "$~\n");
+  save_script_state(fp, SCRIPT(obj));
+  fprintf(fp, "End\n");
+
+  save_obj_list(fp, obj->contains, 'I', GET_ID(obj));
+}
+
+/* Lists are written back to front, so that putting each one at the head of
+ * its list again rebuilds them in their old order. */
+static void save_obj_list(FILE *fp, struct obj_data *list, char where, long key)
+{
+  if (!list)
+    return;
+
+  save_obj_list(fp, list->next_content, where, key);
+  save_obj(fp, list, where, key, 0);
+}
+
+/* Queued mud events, with the pulses they have left. The combat action event
+ * is left out, as set_fighting() attaches it again when fights are linked. */
+static void save_events(FILE *fp, struct list_data *events)
+{
+  struct item_data *pItem;
+  struct event *pEvent;
+  struct mud_event_data *pMudEvent;
+
+  if (!events)
+    return;
+
+  for (pItem = events->pFirstItem; pItem; pItem = pItem->pNextItem) {
+    pEvent = (struct event *) pItem->pContent;
+    pMudEvent = (struct mud_event_data *) pEvent->event_obj;
+    if (!pMudEvent || !event_is_queued(pEvent) || pMudEvent->iId == eCOMBAT_ACTION)
+      continue;
+    fprintf(fp, "Evnt: %d %ld %s\n", pMudEvent->iId, event_time(pEvent),
+      pMudEvent->sVariables ? pMudEvent->sVariables : "");
+  }
+}
+
+static void save_mob(FILE *fp, struct char_data *mob)
+{
+  struct affected_type *af;
+  int i;
+
+  fprintf(fp, "#M %d %ld %d\n", GET_MOB_VNUM(mob), GET_ID(mob), GET_ROOM_VNUM(IN_ROOM(mob)));
+
+  /* Affects first, as adding them back changes the points. */
+  for (af = mob->affected; af; af = af->next)
+    fprintf(fp, "Affs: %d %d %d %d %d %d %d %d\n", af->spell, af->duration,
+      af->modifier, af->location, af->bitvector[0], af->bitvector[1],
+      af->bitvector[2], af->bitvector[3]);
+  fprintf(fp, "AFlg: %d %d %d %d\n", AFF_FLAGS(mob)[0], AFF_FLAGS(mob)[1],
+    AFF_FLAGS(mob)[2], AFF_FLAGS(mob)[3]);
+  fprintf(fp, "MFlg: %d %d %d %d\n", MOB_FLAGS(mob)[0], MOB_FLAGS(mob)[1],
+    MOB_FLAGS(mob)[2], MOB_FLAGS(mob)[3]);
+
+  /* The maximums are saved without what the equipment adds, which it adds
+   * again when it is put back on. */
+  for (i = 0; i < NUM_WEARS; i++)
+    if (GET_EQ(mob, i))
+      affect_modify_obj(mob, GET_EQ(mob, i), FALSE);
+  fprintf(fp, "Pnts: %d %d %d %d %d %d\n", GET_HIT(mob), GET_MAX_HIT(mob),
+    GET_MANA(mob), GET_MAX_MANA(mob), GET_MOVE(mob), GET_MAX_MOVE(mob));
+  for (i = 0; i < NUM_WEARS; i++)
+    if (GET_EQ(mob, i))
+      affect_modify_obj(mob, GET_EQ(mob, i), TRUE);
+
+  fprintf(fp, "Gold: %d\n", GET_GOLD(mob));
+  fprintf(fp, "Exp : %d\n", GET_EXP(mob));
+  fprintf(fp, "Pos : %d %d\n", GET_POS(mob), GET_DEFAULT_POS(mob));
+  save_script_state(fp, SCRIPT(mob));
+  save_events(fp, mob->events);
+  fprintf(fp, "End\n");
+
+  for (i = 0; i < NUM_WEARS; i++)
+    if (GET_EQ(mob, i))
+      save_obj(fp, GET_EQ(mob, i), 'E', GET_ID(mob), i);
+  save_obj_list(fp, mob->carrying, 'C', GET_ID(mob));
+}
+
+static void save_mob_list(FILE *fp, struct char_data *list)
+{
+  if (!list)
+    return;
+
+  save_mob_list(fp, list->next_in_room);
+  if (IS_NPC(list) && !MOB_FLAGGED(list, MOB_NOTDEADYET))
+    save_mob(fp, list);
+}
+
+/** Writes the live world out for the process copyover is about to start.
+ * Players are not included; copyover saves them to their own files. Houses
+ * are saved to theirs, and loaded from them again at boot. */
+void checkpoint_save(void)
+{
+  struct char_data *ch;
+  struct group_data *group;
+  struct iterator_data iterator;
+  room_rnum r;
+  zone_rnum z;
+  FILE *fp;
+
+  if (!(fp = fopen(COPYOVER_WORLD_FILE, "w"))) {
+    log("SYSERR: Cannot write world checkpoint %s: %s", COPYOVER_WORLD_FILE, strerror(errno));
+    return;
+  }
+
+  House_save_all();
+  save_mud_time(&time_info);
+
+  fprintf(fp, "Ids : %ld %ld\n", max_mob_id, max_obj_id);
+
+  for (z = 0; z <= top_of_zone_table; z++)
+    fprintf(fp, "Zone: %d %d\n", zone_table[z].number, zone_table[z].age);
+
+  for (r = 0; r <= top_of_world; r++) {
+    save_mob_list(fp, world[r].people);
+
+    if (!ROOM_FLAGGED(r, ROOM_HOUSE))
+      save_obj_list(fp, world[r].contents, 'R', world[r].number);
+
+    if (SCRIPT(&world[r]) || world[r].events) {
+      fprintf(fp, "#R %d\n", world[r].number);
+      save_script_state(fp, SCRIPT(&world[r]));
+      save_events(fp, world[r].events);
+      fprintf(fp, "End\n");
+    }
+  }
+
+  /* Everything below needs the players back in the game. */
+  fprintf(fp, "Links\n");
+
+  for (ch = character_list; ch; ch = ch->next) {
+    if (FIGHTING(ch))
+      fprintf(fp, "Fght: %ld %ld\n", GET_ID(ch), GET_ID(FIGHTING(ch)));
+    if (ch->master)
+      fprintf(fp, "Foll: %ld %ld\n", GET_ID(ch), GET_ID(ch->master));
+  }
+
+  while ((group = (struct group_data *) simple_list(group_list))) {
+    fprintf(fp, "Grp : %d %ld", group->group_flags, group->leader ? GET_ID(group->leader) : 0);
+    for (ch = (struct char_data *) merge_iterator(&iterator, group->members); ch;
+         ch = (struct char_data *) next_in_list(&iterator))
+      if (ch != group->leader)
+        fprintf(fp, " %ld", GET_ID(ch));
+    remove_iterator(&iterator);
+    fprintf(fp, "\n");
+  }
+
+  fprintf(fp, "$\n");
+  fclose(fp);
+}
+
+/* Reads the next line that is not blank, without its line ending. */
+static int checkpoint_line(char *buf, size_t len)
+{
+  size_t n;
+
+  do {
+    if (!fgets(buf, len, checkpoint_fp))
+      return FALSE;
+    n = strlen(buf);
+    while (n && (buf[n - 1] == '\n' || buf[n - 1] == '\r'))
+      buf[--n] = '\0';
+  } while (!*buf);
+
+  return TRUE;
+}
+
+/** Opens the checkpoint left by copyover, if there is one. Called before
+ * boot_db(), as the id counters have to go on from where the old process
+ * left them for the restored ids not to clash with the new ones. */
+void checkpoint_open(void)
+{
+  char line[READ_SIZE];
+  long mob_id, obj_id;
+
+  if (!(checkpoint_fp = fopen(COPYOVER_WORLD_FILE, "r")))
+    return;
+
+  /* In case something crashes, a later boot must not find it. */
+  unlink(COPYOVER_WORLD_FILE);
+
+  if (!checkpoint_line(line, sizeof(line)) ||
+      sscanf(line, "Ids : %ld %ld", &mob_id, &obj_id) != 2) {
+    log("SYSERR: World checkpoint is damaged, resetting zones instead.");
+    fclose(checkpoint_fp);
+    checkpoint_fp = NULL;
+    return;
+  }
+
+  max_mob_id = MAX(max_mob_id, mob_id);
+  max_obj_id = MAX(max_obj_id, obj_id);
+}
+
+/** Whether the world is to come from a checkpoint rather than zone resets. */
+bool checkpoint_pending(void)
+{
+  return (checkpoint_fp != NULL);
+}
+
+static void remember_thing(struct checkpoint_thing **list, int *num, int *max, long id, void *thing)
+{
+  if (*num >= *max) {
+    *max = *max ? *max * 2 : 256;
+    RECREATE(*list, struct checkpoint_thing, *max);
+  }
+  (*list)[*num].id = id;
+  (*list)[(*num)++].thing = thing;
+}
+
+static void *find_thing(struct checkpoint_thing *list, int num, long id)
+{
+  while (num-- > 0)
+    if (list[num].id == id)
+      return list[num].thing;
+
+  return NULL;
+}
+
+/* Gives a fresh copy the id the original had, so that script variables
+ * holding it still find it. */
+static void restore_id(long *idp, long id, void *thing)
+{
+  if (id <= 0 || id == *idp)
+    return;
+
+  remove_from_lookup_table(*idp);
+  *idp = id;
+  add_to_lookup_table(id, thing);
+}
+
+static struct char_data *restore_mob(char *line)
+{
+  struct char_data *mob;
+  room_rnum room;
+  long id;
+  int vnum, rvnum;
+
+  if (sscanf(line, "#M %d %ld %d", &vnum, &id, &rvnum) != 3)
+    return NULL;
+
+  if ((room = real_room(rvnum)) == NOWHERE || !(mob = read_mobile(vnum, VIRTUAL))) {
+    log("SYSERR: Checkpoint mob %d in room %d could not be restored.", vnum, rvnum);
+    return NULL;
+  }
+
+  restore_id(&GET_ID(mob), id, mob);
+  char_to_room(mob, room);
+  remember_thing(&restored_mobs, &num_mobs, &max_mobs, id, mob);
+
+  return mob;
+}
+
+static struct obj_data *restore_obj(char *line)
+{
+  obj_save_data *loaded, *next;
+  struct obj_data *obj, *cont;
+  struct char_data *mob;
+  room_rnum room;
+  long id, key;
+  int pos, timer;
+  char where;
+
+  if (sscanf(line, "#O %ld %c %ld %d %d", &id, &where, &key, &pos, &timer) != 5)
+    return NULL;
+
+  loaded = objsave_parse_objects(checkpoint_fp);
+  obj = loaded ? loaded->obj : NULL;
+  for (; loaded; loaded = next) {
+    next = loaded->next;
+    free(loaded);
+  }
+  if (!obj)
+    return NULL;
+
+  restore_id(&GET_ID(obj), id, obj);
+  remember_thing(&restored_objs, &num_objs, &max_objs, id, obj);
+
+  switch (where) {
+  case 'R':
+    if ((room = real_room(key)) != NOWHERE) {
+      obj_to_room(obj, room);
+      break;
+    }
+    /* fall through */
+  default:
+    extract_obj(obj);
+    return NULL;
+  case 'I':
+    if (!(cont = (struct obj_data *) find_thing(restored_objs, num_objs - 1, key))) {
+      extract_obj(obj);
+      return NULL;
+    }
+    obj_to_obj(obj, cont);
+    break;
+  case 'C':
+  case 'E':
+    if (!(mob = (struct char_data *) find_thing(restored_mobs, num_mobs, key))) {
+      extract_obj(obj);
+      return NULL;
+    }
+    if (where == 'E' && pos >= 0 && pos < NUM_WEARS && !GET_EQ(mob, pos))
+      equip_char(mob, obj, pos);
+    else
+      obj_to_char(obj, mob);
+    break;
+  }
+
+  set_obj_timer(obj, timer);
+  return obj;
+}
+
+static bool read_mob_line(struct char_data *mob, char *line)
+{
+  struct affected_type af;
+  int t[8];
+
+  if (!strncmp(line, "Affs:", 5)) {
+    if (sscanf(line + 5, "%d %d %d %d %d %d %d %d", &t[0], &t[1], &t[2], &t[3],
+        &t[4], &t[5], &t[6], &t[7]) == 8) {
+      new_affect(&af);
+      af.spell = t[0];
+      af.duration = t[1];
+      af.modifier = t[2];
+      af.location = t[3];
+      af.bitvector[0] = t[4];
+      af.bitvector[1] = t[5];
+      af.bitvector[2] = t[6];
+      af.bitvector[3] = t[7];
+      affect_to_char(mob, &af);
+    }
+  } else if (!strncmp(line, "AFlg:", 5)) {
+    if (sscanf(line + 5, "%d %d %d %d", &t[0], &t[1], &t[2], &t[3]) == 4) {
+      AFF_FLAGS(mob)[0] = t[0];
+      AFF_FLAGS(mob)[1] = t[1];
+      AFF_FLAGS(mob)[2] = t[2];
+      AFF_FLAGS(mob)[3] = t[3];
+    }
+  } else if (!strncmp(line, "MFlg:", 5)) {
+    if (sscanf(line + 5, "%d %d %d %d", &t[0], &t[1], &t[2], &t[3]) == 4) {
+      MOB_FLAGS(mob)[0] = t[0];
+      MOB_FLAGS(mob)[1] = t[1];
+      MOB_FLAGS(mob)[2] = t[2];
+      MOB_FLAGS(mob)[3] = t[3];
+    }
+  } else if (!strncmp(line, "Pnts:", 5)) {
+    if (sscanf(line + 5, "%d %d %d %d %d %d", &t[0], &t[1], &t[2], &t[3], &t[4], &t[5]) == 6) {
+      GET_HIT(mob) = t[0];
+      GET_MAX_HIT(mob) = t[1];
+      GET_MANA(mob) = t[2];
+      GET_MAX_MANA(mob) = t[3];
+      GET_MOVE(mob) = t[4];
+      GET_MAX_MOVE(mob) = t[5];
+    }
+  } else if (!strncmp(line, "Gold:", 5))
+    GET_GOLD(mob) = atoi(line + 5);
+  else if (!strncmp(line, "Exp :", 5))
+    GET_EXP(mob) = atoi(line + 5);
+  else if (!strncmp(line, "Pos :", 5)) {
+    if (sscanf(line + 5, "%d %d", &t[0], &t[1]) == 2) {
+      GET_POS(mob) = t[0];
+      GET_DEFAULT_POS(mob) = t[1];
+    }
+  } else
+    return FALSE;
+
+  return TRUE;
+}
+
+/* Queues a saved mud event again on the mob or room it was attached to. */
+static bool read_event_line(void *go, int type, char *line)
+{
+  char vars[MAX_STRING_LENGTH];
+  long time;
+  int id, n;
+
+  if (strncmp(line, "Evnt:", 5))
+    return FALSE;
+
+  *vars = '\0';
+  if ((n = sscanf(line + 5, "%d %ld %[^\n]", &id, &time, vars)) < 2 ||
+      id <= eNULL || id >= NUM_MUD_EVENTS || id == eCOMBAT_ACTION ||
+      mud_event_index[id].iEvent_Type != (type == MOB_TRIGGER ? EVENT_CHAR :
+                                          type == WLD_TRIGGER ? EVENT_ROOM : -1))
+    return TRUE;
+
+  /* The room flags came back from the world files. */
+  if (id == eSPL_DARKNESS)
+    SET_BIT_AR(((struct room_data *) go)->room_flags, ROOM_DARK);
+
+  NEW_EVENT(id, go, n == 3 ? vars : NULL, MAX(1, time));
+  return TRUE;
+}
+
+/** Puts back the mobiles, objects, room scripts, mud events and zone ages from the
+ * checkpoint. Called by boot_db() in place of resetting the zones. */
+void checkpoint_load_world(void)
+{
+  char line[MAX_STRING_LENGTH];
+  void *go = NULL;
+  int type = MOB_TRIGGER, znum, age;
+  zone_rnum z;
+  room_rnum r;
+
+  while (checkpoint_line(line, sizeof(line)) && strcmp(line, "Links")) {
+    if (!strncmp(line, "Zone:", 5)) {
+      if (sscanf(line + 5, "%d %d", &znum, &age) == 2 && (z = real_zone(znum)) != NOWHERE)
+        /* A zone that was waiting in the reset queue asks again. */
+        zone_table[z].age = MIN(age, zone_table[z].lifespan);
+    } else if (!strncmp(line, "#M ", 3)) {
+      go = restore_mob(line);
+      type = MOB_TRIGGER;
+    } else if (!strncmp(line, "#O ", 3)) {
+      go = restore_obj(line);
+      type = OBJ_TRIGGER;
+    } else if (!strncmp(line, "#R ", 3)) {
+      go = (r = real_room(atoi(line + 3))) != NOWHERE ? &world[r] : NULL;
+      type = WLD_TRIGGER;
+    } else if (!strcmp(line, "End"))
+      go = NULL;
+    else if (go && !(type == MOB_TRIGGER && read_mob_line((struct char_data *) go, line)) &&
+             !read_event_line(go, type, line))
+      read_script_state(go, type, line);
+  }
+
+  /* Restored scripts went in behind the rooms' backs. */
+  trig_types_changed();
+
+  log("Restored %d mobiles and %d objects from the world checkpoint.", num_mobs, num_objs);
+}
+
+static struct char_data *checkpoint_char(long id)
+{
+  struct char_data *ch;
+
+  for (ch = character_list; ch; ch = ch->next)
+    if (GET_ID(ch) == id && !DEAD(ch))
+      return ch;
+
+  return NULL;
+}
+
+/* Rebuilds a group without telling its members they are joining it. */
+static void restore_group(char *line)
+{
+  struct group_data *group = NULL;
+  struct char_data *ch;
+  char arg[MAX_INPUT_LENGTH], *p;
+  int flags;
+
+  p = any_one_arg(line + 5, arg);
+  flags = atoi(arg);
+
+  for (p = any_one_arg(p, arg); *arg; p = any_one_arg(p, arg)) {
+    if (!(ch = checkpoint_char(atol(arg))) || ch->group)
+      continue;
+
+    if (!group) {
+      CREATE(group, struct group_data, 1);
+      add_to_list(group, group_list);
+      group->members = create_list();
+      group->group_flags = flags;
+      group->leader = ch;
+    }
+    add_to_list(ch, group->members);
+    ch->group = group;
+  }
+}
+
+/** Links fights, followers and groups back up once the players are back,
+ * and closes the checkpoint. */
+void checkpoint_finish(void)
+{
+  struct char_data *ch, *other;
+  struct follow_type *k;
+  char line[MAX_STRING_LENGTH];
+  long a, b;
+
+  if (!checkpoint_fp)
+    return;
+
+  while (checkpoint_line(line, sizeof(line)) && strcmp(line, "$")) {
+    if (!strncmp(line, "Grp :", 5)) {
+      restore_group(line);
+      continue;
+    }
+
+    if (sscanf(line + 5, "%ld %ld", &a, &b) != 2 ||
+        !(ch = checkpoint_char(a)) || !(other = checkpoint_char(b)))
+      continue;
+
+    if (!strncmp(line, "Fght:", 5)) {
+      if (!FIGHTING(ch) && ch != other && IN_ROOM(ch) == IN_ROOM(other))
+        set_fighting(ch, other);
+    } else if (!strncmp(line, "Foll:", 5)) {
+      /* as add_follower(), without the messages */
+      if (ch->master || ch == other)
+        continue;
+      ch->master = other;
+      CREATE(k, struct follow_type, 1);
+      k->follower = ch;
+      k->next = other->followers;
+      other->followers = k;
+    }
+  }
+
+  fclose(checkpoint_fp);
+  checkpoint_fp = NULL;
+
+  if (restored_mobs)
+    free(restored_mobs);
+  if (restored_objs)
+    free(restored_objs);
+  restored_mobs = restored_objs = NULL;
+  num_mobs = max_mobs = num_objs = max_objs = 0;
+}
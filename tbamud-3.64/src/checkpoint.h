@@ -0,0 +1,25 @@
+/**
+* @file checkpoint.h
+* World checkpoint written by copyover and read back by the new process, so
+* that the live world carries over instead of every zone being reset.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+/** The checkpoint file, next to COPYOVER_FILE in the lib directory. */
+#define COPYOVER_WORLD_FILE "copyover.wld"
+
+void checkpoint_save(void);
+void checkpoint_open(void);
+bool checkpoint_pending(void);
+void checkpoint_load_world(void);
+void checkpoint_finish(void);
+
+#endif /* _CHECKPOINT_H_ */
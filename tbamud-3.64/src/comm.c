@@ -67,6 +67,7 @@
 #include "handler.h"
 #include "db.h"
 #include "house.h"
+#include "checkpoint.h"
 #include "oasis.h"
 #include "genolc.h"
 #include "dg_scripts.h"
@@ -96,10 +97,15 @@ struct descriptor_data *descriptor_list = NULL;   /* master desc list */
 int buf_largecount = 0;   /* # of large buffers which exist */
 int buf_overflows = 0;    /* # of overflows of output */
 int buf_switches = 0;     /* # of switches from small to large buf */
+int input_pool_size = 0;  /* # of input lines allocated to the pool */
+int input_queue_peak = 0; /* most commands any connection has had queued */
+int input_floods = 0;     /* # of connections closed for input flooding */
+int output_stalls = 0;    /* # of connections closed for not reading output */
 int circle_shutdown = 0;  /* clean shutdown */
 int circle_reboot = 0;    /* reboot the game after a shutdown */
 int no_specials = 0;      /* Suppress ass. of special routines */
 int scheck = 0;           /* for syntax checking mode */
+static int rent_benchmark = 0;  /* passes for the -b rent benchmark */
 FILE *logfile = NULL;     /* Where to send the log messages. */
 unsigned long pulse = 0;  /* number of pulses since game start */
 ush_int port;
@@ -110,6 +116,7 @@ long last_webster_teller = -1L;
 
 /* static local global variable declarations (current file scope only) */
 static struct txt_block *bufpool = 0;  /* pool of large output buffers */
+static struct txt_line *input_pool = NULL; /* pool of free input lines */
 static int max_players = 0;   /* max descriptors available */
 static int tics_passed = 0;     /* for extern checkpointing */
 static struct timeval null_time; /* zero-valued time structure */
@@ -131,16 +138,24 @@ static RETSIGTYPE unrestrict_game(int sig);
 static RETSIGTYPE reap(int sig);
 static RETSIGTYPE checkpointing(int sig);
 static RETSIGTYPE hupsig(int sig);
+static RETSIGTYPE crashsig(int sig);
 static ssize_t perform_socket_read(socket_t desc, char *read_point,size_t space_left);
 static ssize_t perform_socket_write(socket_t desc, const char *txt,size_t length);
 static void circle_sleep(struct timeval *timeout);
+static struct txt_line *get_input_line(void);
 static int get_from_q(struct txt_q *queue, char *dest, int *aliased);
+static void flush_input_q(struct txt_q *queue);
 static void init_game(ush_int port);
 static void signal_setup(void);
 static socket_t init_socket(ush_int port);
 static int new_descriptor(socket_t s);
 static int get_max_players(void);
 static int process_output(struct descriptor_data *t);
+static int check_output_backlog(struct descriptor_data *t, time_t now);
+static void use_large_outbuf(struct descriptor_data *t);
+static void compact_output(struct descriptor_data *t);
+static void reset_bufspace(struct descriptor_data *t);
+static int write_bytes_to_descriptor(socket_t desc, const char *txt, size_t total);
 static int process_input(struct descriptor_data *t);
 static void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
 static void timeadd(struct timeval *sum, struct timeval *a, struct timeval *b);
@@ -158,6 +173,7 @@ static int set_sendbuf(socket_t s);
 static void free_bufpool(void);
 static void setup_log(const char *filename, int fd);
 static int open_logfile(const char *filename, FILE *stderr_fp);
+static void flush_log_at_exit(void);
 #if defined(POSIX)
 static sigfunc *my_signal(int signo, sigfunc *func);
 #endif
@@ -166,6 +182,7 @@ static RETSIGTYPE websterlink(int sig);
 static void handle_webster_file();
 
 static void msdp_update(void); /* KaVir plugin*/
+static int msdp_pending = 0;   /* descriptors waiting on msdp_update() */
 
 /* externally defined functions, used locally */
 #ifdef __CXREF__
@@ -286,6 +303,12 @@ int main(int argc, char **argv)
       scheck = 1;
       puts("Syntax check mode enabled.");
       break;
+    case 'b':
+      scheck = 1;
+      if ((rent_benchmark = atoi(argv[pos] + 2)) <= 0)
+        rent_benchmark = 10;
+      puts("Rent file benchmark mode enabled.");
+      break;
     case 'q':
       no_rent_check = 1;
       puts("Quick boot mode -- rent check supressed.");
@@ -301,7 +324,8 @@ int main(int argc, char **argv)
     case 'h':
       /* From: Anil Mahajan. Do NOT use -C, this is the copyover mode and
        * without the proper copyover.dat file, the game will go nuts! */
-      printf("Usage: %s [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n"
+      printf("Usage: %s [-b] [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n"
+              "  -b<passes>     Time loading every rent and house file, then exit.\n"
               "  -c             Enable syntax check mode.\n"
               "  -d <directory> Specify library directory (defaults to 'lib').\n"
               "  -h             Print this command line argument help.\n"
@@ -324,7 +348,7 @@ int main(int argc, char **argv)
 
   if (pos < argc) {
     if (!isdigit(*argv[pos])) {
-      printf("Usage: %s [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n", argv[0]);
+      printf("Usage: %s [-b] [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n", argv[0]);
       exit(1);
     } else if ((port = atoi(argv[pos])) <= 1024) {
       printf("SYSERR: Illegal port number %d.\n", port);
@@ -346,9 +370,11 @@ int main(int argc, char **argv)
   }
   log("Using %s as data directory.", dir);
 
-  if (scheck)
+  if (scheck) {
     boot_world();
-  else {
+    if (rent_benchmark)
+      Crash_benchmark(rent_benchmark);
+  } else {
     log("Running game on port %d.", port);
     init_game(port);
   }
@@ -401,6 +427,8 @@ void copyover_recover()
   bool fOld;
   char name[MAX_INPUT_LENGTH];
   long pref;
+  struct sockaddr_in peer;
+  socklen_t peer_len;
 
   log ("Copyover recovery initiated");
 
@@ -439,6 +467,9 @@ void copyover_recover()
     init_descriptor (d,desc); /* set up various stuff */
 
     strcpy(d->host, host);
+    peer_len = sizeof(peer);
+    if (getpeername(desc, (struct sockaddr *) &peer, &peer_len) == 0 && peer.sin_family == AF_INET)
+      d->host_addr = ntohl(peer.sin_addr.s_addr);
     d->next = descriptor_list;
     descriptor_list = d;
 
@@ -482,6 +513,8 @@ void copyover_recover()
 
       d->connected = CON_PLAYING;
       look_at_room(d->character, 0);
+      msdp_changed(d->character);
+      mssp_players_changed();
 
       /* Add to the list of 'recent' players (since last reboot) with copyover flag */
       if (AddRecentPlayer(GET_NAME(d->character), d->host, FALSE, TRUE) == FALSE)
@@ -515,6 +548,10 @@ static void init_game(ush_int local_port)
   /* set up hash table for find_char() */
   init_lookup_table();
 
+  /* Before boot_db(), which loads the world from it instead of resetting. */
+  if (fCopyOver)
+    checkpoint_open();
+
   boot_db();
 
 #if defined(CIRCLE_UNIX) || defined(CIRCLE_MACINTOSH)
@@ -528,6 +565,8 @@ static void init_game(ush_int local_port)
   if (fCopyOver) /* reload players */
   copyover_recover();
 
+  checkpoint_finish();
+
   log("Entering game loop.");
 
   game_loop(mother_desc);
@@ -749,16 +788,27 @@ void game_loop(socket_t local_mother_desc)
 
     /* Sleep if we don't have any connections */
     if (descriptor_list == NULL) {
-      log("No connections.  Going to sleep.");
+      /* Nobody is waiting on us, so get on with checking rent files, but
+       * look for a new connection between batches. */
       FD_ZERO(&input_set);
-      FD_SET(local_mother_desc, &input_set);
-      if (select(local_mother_desc + 1, &input_set, (fd_set *) 0, (fd_set *) 0, NULL) < 0) {
-	if (errno == EINTR)
-	  log("Waking up to process signal.");
-	else
-	  perror("SYSERR: Select coma");
-      } else
-	log("New connection.  Waking up.");
+      while (Crash_sweep_rent_files()) {
+        FD_SET(local_mother_desc, &input_set);
+        if (select(local_mother_desc + 1, &input_set, (fd_set *) 0, (fd_set *) 0, &null_time) > 0)
+          break;
+        FD_ZERO(&input_set);
+      }
+      if (!FD_ISSET(local_mother_desc, &input_set)) {
+        log("No connections.  Going to sleep.");
+        flush_log(TRUE);
+        FD_SET(local_mother_desc, &input_set);
+        if (select(local_mother_desc + 1, &input_set, (fd_set *) 0, (fd_set *) 0, NULL) < 0) {
+	  if (errno == EINTR)
+	    log("Waking up to process signal.");
+	  else
+	    perror("SYSERR: Select coma");
+        } else
+	  log("New connection.  Waking up.");
+      }
       gettimeofday(&last_time, (struct timezone *) 0);
     }
     /* Set up the input, output, and exception sets for select(). */
@@ -774,8 +824,11 @@ void game_loop(socket_t local_mother_desc)
 	maxdesc = d->descriptor;
 #endif
       FD_SET(d->descriptor, &input_set);
-      FD_SET(d->descriptor, &output_set);
       FD_SET(d->descriptor, &exc_set);
+      /* Only ask about sockets that could not take everything last time;
+       * fresh output is written straight out below. */
+      if (d->out_stalled && d->bufptr > d->out_sent)
+        FD_SET(d->descriptor, &output_set);
     }
 
     /* At this point, we have completed all input, output and heartbeat
@@ -834,7 +887,7 @@ void game_loop(socket_t local_mother_desc)
     /* Process descriptors with input pending */
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
-      if (FD_ISSET(d->descriptor, &input_set))
+      if (FD_ISSET(d->descriptor, &input_set) || strpbrk(d->inbuf, "\r\n"))
        {
         if ( d->pProtocol != NULL )      /* KaVir's plugin */
           d->pProtocol->WriteOOB = 0;    /* KaVir's plugin */
@@ -893,18 +946,21 @@ void game_loop(socket_t local_mother_desc)
     /* Send queued output out to the operating system (ultimately to user). */
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
-      if (*(d->output) && FD_ISSET(d->descriptor, &output_set)) {
+      if (d->bufptr > d->out_sent && (!d->out_stalled || FD_ISSET(d->descriptor, &output_set))) {
 	/* Output for this player is ready */
-	if (process_output(d) < 0)
+	if (process_output(d) < 0) {
 	  close_socket(d);
-	else
+	  continue;
+	} else
 	  d->has_prompt = 1;
       }
+      if (check_output_backlog(d, now.tv_sec) < 0)
+        close_socket(d);
     }
 
     /* Print prompts for other descriptors who had no other output */
     for (d = descriptor_list; d; d = d->next) {
-      if (!d->has_prompt) {
+      if (!d->has_prompt && d->bufptr == d->out_sent) {
 	      write_to_descriptor(d->descriptor, make_prompt(d));
 	      d->has_prompt = TRUE;
       }
@@ -957,6 +1013,9 @@ void game_loop(socket_t local_mother_desc)
       handle_webster_file();
     }
 
+    /* Write out what was logged during this pass. */
+    flush_log(FALSE);
+
 #ifdef CIRCLE_UNIX
     /* Update tics_passed for deadlock protection (UNIX only) */
     tics_passed++;
@@ -973,10 +1032,8 @@ void heartbeat(int heart_pulse)
   if (!(heart_pulse % PULSE_DG_SCRIPT))
     script_trigger_check();
 
-  if (!(heart_pulse % PASSES_PER_SEC)) {    /* EVERY second */
-    msdp_update();
+  if (!(heart_pulse % PASSES_PER_SEC))     /* EVERY second */
     next_tick--;
-  }
 
   if (!(heart_pulse % PULSE_ZONE))
     zone_update();
@@ -990,9 +1047,6 @@ void heartbeat(int heart_pulse)
   if (!(heart_pulse % PULSE_VIOLENCE))
     perform_violence();
 
-  // every pulse mobs will have a chance to do something!
-  performMobCombatAction();
-
   if (!(heart_pulse % (SECS_PER_MUD_HOUR * PASSES_PER_SEC))) {  /* Tick ! */
     next_tick = SECS_PER_MUD_HOUR;  /* Reset tick coundown */
     weather_and_time(1);
@@ -1016,8 +1070,15 @@ void heartbeat(int heart_pulse)
   if (!(heart_pulse % PULSE_TIMESAVE))
   save_mud_time(&time_info);
 
+  /* Works through the rent files left unchecked at boot. */
+  Crash_sweep_rent_files();
+
   /* Every pulse! Don't want them to stink the place up... */
   extract_pending_chars();
+
+  /* Everything that changed this pulse goes out to MSDP clients together. */
+  if (msdp_pending)
+    msdp_update();
 }
 
 /* new code to calculate time differences, which works on systems for which
@@ -1219,46 +1280,105 @@ static char *make_prompt(struct descriptor_data *d)
   return (prompt);
 }
 
-/* NOTE: 'txt' must be at most MAX_INPUT_LENGTH big. */
-void write_to_q(const char *txt, struct txt_q *queue, int aliased)
+/* Input lines are handed out from a pool that grows a chunk at a time and
+ * never shrinks, so a busy game stops allocating for commands at all. */
+#define INPUT_POOL_CHUNK 64
+
+static struct txt_line *get_input_line(void)
 {
-  struct txt_block *newt;
+  struct txt_line *line;
+  int i;
+
+  if (!input_pool) {
+    CREATE(line, struct txt_line, INPUT_POOL_CHUNK);
+    for (i = 0; i < INPUT_POOL_CHUNK; i++) {
+      line[i].next = input_pool;
+      input_pool = &line[i];
+    }
+    input_pool_size += INPUT_POOL_CHUNK;
+  }
 
-  CREATE(newt, struct txt_block, 1);
-  newt->text = strdup(txt);
-  newt->aliased = aliased;
+  line = input_pool;
+  input_pool = line->next;
+  return (line);
+}
 
-  /* queue empty? */
-  if (!queue->head) {
-    newt->next = NULL;
-    queue->head = queue->tail = newt;
-  } else {
-    queue->tail->next = newt;
-    queue->tail = newt;
-    newt->next = NULL;
+static void free_input_line(struct txt_line *line)
+{
+  line->next = input_pool;
+  input_pool = line;
+}
+
+/* Add a line to the end of an input queue.  Lines longer than MAX_INPUT_LENGTH
+ * are cut short.  Returns FALSE, and drops the line, if the queue is full. */
+int write_to_q(const char *txt, struct txt_q *queue, int aliased)
+{
+  struct txt_line *line;
+
+  if (queue->count >= INPUT_Q_SLOTS)
+    return (FALSE);
+
+  line = get_input_line();
+  strlcpy(line->text, txt, sizeof(line->text));
+  line->aliased = aliased;
+  queue->line[(queue->first + queue->count++) % INPUT_Q_SLOTS] = line;
+
+  if (queue->count > queue->peak)
+    queue->peak = queue->count;
+  return (TRUE);
+}
+
+/* Move every line of 'front' ahead of the lines already in 'queue', leaving
+ * 'front' empty.  Used for alias expansion, which has to run before anything
+ * typed after it.  Lines that do not fit are dropped from the end of 'front'. */
+void write_to_q_front(struct txt_q *queue, struct txt_q *front)
+{
+  struct txt_line *line;
+
+  while (front->count > INPUT_Q_SLOTS - queue->count)
+    free_input_line(front->line[(front->first + --front->count) % INPUT_Q_SLOTS]);
+
+  while (front->count) {
+    line = front->line[(front->first + --front->count) % INPUT_Q_SLOTS];
+    queue->first = (queue->first + INPUT_Q_SLOTS - 1) % INPUT_Q_SLOTS;
+    queue->line[queue->first] = line;
+    queue->count++;
   }
+
+  if (queue->count > queue->peak)
+    queue->peak = queue->count;
 }
 
 /* NOTE: 'dest' must be at least MAX_INPUT_LENGTH big. */
 static int get_from_q(struct txt_q *queue, char *dest, int *aliased)
 {
-  struct txt_block *tmp;
+  struct txt_line *line;
 
   /* queue empty? */
-  if (!queue->head)
+  if (!queue->count)
     return (0);
 
-  strcpy(dest, queue->head->text);	/* strcpy: OK (mutual MAX_INPUT_LENGTH) */
-  *aliased = queue->head->aliased;
+  line = queue->line[queue->first];
+  strcpy(dest, line->text);	/* strcpy: OK (mutual MAX_INPUT_LENGTH) */
+  *aliased = line->aliased;
 
-  tmp = queue->head;
-  queue->head = queue->head->next;
-  free(tmp->text);
-  free(tmp);
+  queue->first = (queue->first + 1) % INPUT_Q_SLOTS;
+  queue->count--;
+  free_input_line(line);
 
   return (1);
 }
 
+/* Drop every line waiting in an input queue. */
+static void flush_input_q(struct txt_q *queue)
+{
+  while (queue->count) {
+    free_input_line(queue->line[queue->first]);
+    queue->first = (queue->first + 1) % INPUT_Q_SLOTS;
+    queue->count--;
+  }
+}
+
 /* Empty the queues before closing connection */
 static void flush_queues(struct descriptor_data *d)
 {
@@ -1266,12 +1386,7 @@ static void flush_queues(struct descriptor_data *d)
     d->large_outbuf->next = bufpool;
     bufpool = d->large_outbuf;
   }
-  while (d->input.head) {
-    struct txt_block *tmp = d->input.head;
-    d->input.head = d->input.head->next;
-    free(tmp->text);
-    free(tmp);
-  }
+  flush_input_q(&d->input);
 }
 
 /* Add a new string to a player's output queue. For outside use. */
@@ -1312,6 +1427,11 @@ size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list a
     strcpy(txt + size - strlen(text_overflow), text_overflow);	/* strcpy: OK */
   }
 
+  /* Whatever went out at the front of a half sent flush is only taking up
+   * room now, so get it back before deciding the new text does not fit. */
+  if (t->out_sent && size >= t->bufspace)
+    compact_output(t);
+
   /* If the text is too big to fit into even a large buffer, truncate
    * the new text to make it fit.  (This will switch to the overflow
    * state automatically because t->bufspace will end up 0.) */
@@ -1321,15 +1441,25 @@ size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list a
     buf_overflows++;
   }
 
-  /* If we have enough space, just write to buffer and that's it! If the
-   * text just barely fits, then it's switched to a large buffer instead. */
-  if (t->bufspace > size) {
-    strcpy(t->output + t->bufptr, txt);	/* strcpy: OK (size checked above) */
-    t->bufspace -= size;
-    t->bufptr += size;
-    return (t->bufspace);
-  }
+  /* If the text just barely fits the small buffer, it's switched to a large
+   * buffer instead.  A large buffer it only just fits is left full, which is
+   * the overflow state. */
+  if (t->bufspace <= size && !t->large_outbuf)
+    use_large_outbuf(t);
 
+  strcpy(t->output + t->bufptr, txt);	/* strcpy: OK (size checked above) */
+  t->bufptr += size;
+  t->bufspace -= size;
+
+  return (t->bufspace);
+}
+
+/* Move a descriptor's output from its small buffer into a large one, taking
+ * it from the pool if there is one.  Large buffers are MAX_SOCK_BUF long, so
+ * past LARGE_BUFSIZE there is always room for process_output()'s overflow
+ * notice and prompt. */
+static void use_large_outbuf(struct descriptor_data *t)
+{
   buf_switches++;
 
   /* if the pool has a buffer in it, grab it */
@@ -1338,21 +1468,34 @@ size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list a
     bufpool = bufpool->next;
   } else {			/* else create a new one */
     CREATE(t->large_outbuf, struct txt_block, 1);
-    CREATE(t->large_outbuf->text, char, LARGE_BUFSIZE);
+    CREATE(t->large_outbuf->text, char, MAX_SOCK_BUF);
     buf_largecount++;
   }
 
-  strcpy(t->large_outbuf->text, t->output);	/* strcpy: OK (size checked previously) */
+  memcpy(t->large_outbuf->text, t->output, t->bufptr + 1);
   t->output = t->large_outbuf->text;	/* make big buffer primary */
-  strcat(t->output, txt);	/* strcat: OK (size checked) */
+  reset_bufspace(t);
+}
 
-  /* set the pointer for the next write */
-  t->bufptr = strlen(t->output);
+/* Drop the part of the output buffer that has already been sent. */
+static void compact_output(struct descriptor_data *t)
+{
+  memmove(t->output, t->output + t->out_sent, t->bufptr - t->out_sent + 1);
+  t->bufptr -= t->out_sent;
+  t->flushing = MAX(t->flushing - t->out_sent, 0);
+  t->out_sent = 0;
+  reset_bufspace(t);
+}
 
-  /* calculate how much space is left in the buffer */
-  t->bufspace = LARGE_BUFSIZE - 1 - t->bufptr;
+/* Work out the space left from where the output ends.  Once the text (and
+ * anything process_output() has added) reaches the end of the buffer it is
+ * in the overflow state, with no space at all. */
+static void reset_bufspace(struct descriptor_data *t)
+{
+  int size = t->large_outbuf ? LARGE_BUFSIZE : SMALL_BUFSIZE;
 
-  return (t->bufspace);
+  if (t->bufspace)
+    t->bufspace = MAX(size - 1 - t->bufptr, 0);
 }
 
 static void free_bufpool(void)
@@ -1492,6 +1635,12 @@ static int new_descriptor(socket_t s)
   /* keep it from blocking */
   nonblock(desc);
 
+  /* turn away networks that are hammering us before doing any work for them */
+  if (ban_throttled(ntohl(peer.sin_addr.s_addr))) {
+    CLOSE_SOCKET(desc);
+    return (0);
+  }
+
   /* set the send buffer size */
   if (set_sendbuf(desc) < 0) {
     CLOSE_SOCKET(desc);
@@ -1528,7 +1677,8 @@ static int new_descriptor(socket_t s)
   }
 
   /* determine if the site is banned */
-  if (isbanned(newd->host) == BAN_ALL) {
+  newd->host_addr = ntohl(peer.sin_addr.s_addr);
+  if (isbanned(newd->host, newd->host_addr) == BAN_ALL) {
     CLOSE_SOCKET(desc);
     mudlog(CMP, LVL_GOD, TRUE, "Connection attempt denied from [%s]", newd->host);
     free(newd);
@@ -1556,55 +1706,74 @@ static int new_descriptor(socket_t s)
 }
 
 /* Send all of the output that we've accumulated for a player out to the
- * player's descriptor. 32 byte GARBAGE_SPACE in MAX_SOCK_BUF used for:
+ * player's descriptor.  A new flush is finished off in the output buffer
+ * itself, which has GARBAGE_SPACE and MAX_PROMPT_LENGTH to spare for:
  *	 2 bytes: prepended \r\n
  *	14 bytes: overflow message
  *	 2 bytes: extra \r\n for non-comapct
- *      14 bytes: unused */
+ *	the prompt
+ * Whatever the kernel will not take yet stays there as it is, with out_sent
+ * marking how far it got, so a client that is not reading costs a write()
+ * and nothing more each pulse. */
 static int process_output(struct descriptor_data *t)
 {
-  char i[MAX_SOCK_BUF], *osb = i + 2;
+  const char *text_overflow = "**OVERFLOW**\r\n";
+  const char *prompt = "";
   int result;
 
-  /* we may need this \r\n for later -- see below */
-  strcpy(i, "\r\n");	/* strcpy: OK (for 'MAX_SOCK_BUF >= 3') */
+  if (!t->flushing) {
+    if (!t->pProtocol->WriteOOB) /* add a prompt */
+      prompt = make_prompt(t);
 
-  /* now, append the 'real' output */
-  strcpy(osb, t->output);	/* strcpy: OK (t->output:LARGE_BUFSIZE < osb:MAX_SOCK_BUF-2) */
+    if (!t->large_outbuf && t->bufptr + 2 + strlen(text_overflow) + 2 + strlen(prompt) >= SMALL_BUFSIZE)
+      use_large_outbuf(t);
 
-  /* if we're in the overflow state, notify the user */
-  if (t->bufspace == 0)
-    strcat(osb, "**OVERFLOW**\r\n");	/* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
-
-  /* add the extra CRLF if the person isn't in compact mode */
-  if (STATE(t) == CON_PLAYING && t->character && !IS_NPC(t->character) && !PRF_FLAGGED(t->character, PRF_COMPACT))
-    strcat(osb, "\r\n");	/* strcpy: OK (osb:MAX_SOCK_BUF-2 reserves space) */
-
-  if (!t->pProtocol->WriteOOB) /* add a prompt */
-    strcat(i, make_prompt(t));	/* strcpy: OK (i:MAX_SOCK_BUF reserves space) */
-
-  /* now, send the output.  If this is an 'interruption', use the prepended
-   * CRLF, otherwise send the straight output sans CRLF. */
-  if (t->has_prompt) {
-    t->has_prompt = FALSE;
-    result = write_to_descriptor(t->descriptor, i);
-    if (result >= 2)
-      result -= 2;
-  } else
-    result = write_to_descriptor(t->descriptor, osb);
+    /* If this is an 'interruption', prepend a CRLF. */
+    if (t->has_prompt) {
+      t->has_prompt = FALSE;
+      memmove(t->output + t->out_sent + 2, t->output + t->out_sent, t->bufptr - t->out_sent + 1);
+      memcpy(t->output + t->out_sent, "\r\n", 2);
+      t->bufptr += 2;
+    }
+
+    /* if we're in the overflow state, notify the user */
+    if (t->bufspace == 0)
+      strcpy(t->output + t->bufptr, text_overflow);	/* strcpy: OK (GARBAGE_SPACE reserves space) */
+
+    /* add the extra CRLF if the person isn't in compact mode */
+    if (STATE(t) == CON_PLAYING && t->character && !IS_NPC(t->character) && !PRF_FLAGGED(t->character, PRF_COMPACT))
+      strcat(t->output + t->bufptr, "\r\n");	/* strcat: OK (GARBAGE_SPACE reserves space) */
+
+    strcat(t->output + t->bufptr, prompt);	/* strcat: OK (MAX_PROMPT_LENGTH reserves space) */
+
+    t->bufptr += strlen(t->output + t->bufptr);
+    t->flushing = t->bufptr;
+    reset_bufspace(t);
+  }
 
-  if (result < 0) {	/* Oops, fatal error. Bye! */
-    close_socket(t);
+  result = write_bytes_to_descriptor(t->descriptor, t->output + t->out_sent, t->flushing - t->out_sent);
+
+  if (result < 0)	/* Oops, fatal error. Bye! */
     return (-1);
-  } else if (result == 0)	/* Socket buffer full. Try later. */
-    return (0);
 
   /* Handle snooping: prepend "% " and send to snooper. */
-  if (t->snoop_by)
-    write_to_output(t->snoop_by, "%% %*s%%%%", result, t->output);
+  if (result > 0 && t->snoop_by)
+    write_to_output(t->snoop_by, "%% %.*s%%%%", result, t->output + t->out_sent);
+
+  t->out_sent += result;
+  t->out_bytes += result;
+
+  /* Still partway through; try the rest when the socket will take it. */
+  if (t->out_sent < t->flushing) {
+    if (result > 0 || !t->out_stalled)
+      t->out_stalled = time(0);
+    return (result);
+  }
+
+  t->out_stalled = 0;
 
   /* The common case: all saved output was handed off to the kernel buffer. */
-  if (result >= t->bufptr) {
+  if (t->bufptr == t->flushing) {
     /* If we were using a large buffer, put the large buffer on the buffer pool
      * and switch back to the small one. */
     if (t->large_outbuf) {
@@ -1615,30 +1784,56 @@ static int process_output(struct descriptor_data *t)
     }
     /* reset total bufspace back to that of a small buffer */
     t->bufspace = SMALL_BUFSIZE - 1;
-    t->bufptr = 0;
+    t->bufptr = t->out_sent = t->flushing = 0;
     *(t->output) = '\0';
-
-    /* If the overflow message or prompt were partially written, try to save
-     * them. There will be enough space for them if this is true.  'result'
-     * is effectively unsigned here anyway. */
-    if ((unsigned int)result < strlen(osb)) {
-      size_t savetextlen = strlen(osb + result);
-
-      strcat(t->output, osb + result);
-      t->bufptr   -= savetextlen;
-      t->bufspace += savetextlen;
-    }
-
   } else {
-    /* Not all data in buffer sent.  result < output buffersize. */
-    strcpy(t->output, t->output + result);	/* strcpy: OK (overlap) */
-    t->bufptr   -= result;
-    t->bufspace += result;
+    /* More was written while this went out; it goes in the next flush. */
+    compact_output(t);
+    t->flushing = 0;
   }
 
   return (result);
 }
 
+/* Keep track of a descriptor with output waiting.  Once the backlog passes
+ * OUTPUT_HIGH_WATER on a connection that has stopped keeping up, room and
+ * channel chatter is skipped for it (see output_behind()) until it drains
+ * below OUTPUT_LOW_WATER, and then it is told how much it missed.  Returns
+ * -1 if nothing has been sent for OUTPUT_STALL_TIMEOUT seconds. */
+static int check_output_backlog(struct descriptor_data *t, time_t now)
+{
+  int waiting = t->bufptr - t->out_sent;
+
+  if (waiting && !t->out_stalled)
+    t->out_stalled = now;
+
+  if (!t->out_behind && t->out_stalled && waiting >= OUTPUT_HIGH_WATER) {
+    t->out_behind = TRUE;
+    t->out_behind_count++;
+  } else if (t->out_behind && waiting < OUTPUT_LOW_WATER) {
+    t->out_behind = FALSE;
+    if (t->out_skipped)
+      write_to_output(t, "\r\n[ %d room and channel message%s skipped while your connection caught up. ]\r\n",
+        t->out_skipped, t->out_skipped == 1 ? " was" : "s were");
+    t->out_skipped = 0;
+  }
+
+  if (t->out_stalled && now - t->out_stalled > OUTPUT_STALL_TIMEOUT) {
+    mudlog(BRF, LVL_GOD, TRUE, "Output stalled: %s [%s] with %d bytes waiting.",
+      t->character && GET_NAME(t->character) ? GET_NAME(t->character) : "<unknown>",
+      t->host, waiting);
+    output_stalls++;
+    return (-1);
+  }
+  return (0);
+}
+
+/* TRUE if 'd' is too far behind on output for room and channel chatter. */
+bool output_behind(struct descriptor_data *d)
+{
+  return (d && d->out_behind);
+}
+
 /* perform_socket_write: takes a descriptor, a pointer to text, and a
  * text length, and tries once to send that text to the OS.  This is
  * where we stuff all the platform-dependent stuff that used to be
@@ -1731,9 +1926,15 @@ static ssize_t perform_socket_write(socket_t desc, const char *txt, size_t lengt
  * >=0  If all is well and good.
  *  -1  If an error was encountered, so that the player should be cut off. */
 int write_to_descriptor(socket_t desc, const char *txt)
+{
+  return (write_bytes_to_descriptor(desc, txt, strlen(txt)));
+}
+
+/* As write_to_descriptor(), for the first 'total' bytes of 'txt'. */
+static int write_bytes_to_descriptor(socket_t desc, const char *txt, size_t total)
 {
   ssize_t bytes_written;
-  size_t total = strlen(txt), write_total = 0;
+  size_t write_total = 0;
 
   while (total > 0) {
     bytes_written = perform_socket_write(desc, txt, total);
@@ -1842,7 +2043,13 @@ static int process_input(struct descriptor_data *t)
   read_point = t->inbuf + buf_length;
   space_left = MAX_RAW_INPUT_LENGTH - buf_length - 1;
 
-  do {
+  /* Lines held back while the string editor's queue was full are split off
+   * before anything more is read; the rest waits in the socket. */
+  for (ptr = t->inbuf; *ptr && !nl_pos; ptr++)
+    if (ISNEWL(*ptr))
+      nl_pos = ptr;
+
+  if (nl_pos == NULL) do {
     if (space_left <= 0) {
       log("WARNING: process_input: about to close connection: input overflow");
       return (-1);
@@ -1855,8 +2062,11 @@ static int process_input(struct descriptor_data *t)
 
     /* Since we have recieved atleast 1 byte of data from the socket, lets run it through
      * ProtocolInput() and rip out anything that is Out Of Band */ 
-    if ( bytes_read > 0 )
+    if ( bytes_read > 0 ) {
       bytes_read = ProtocolInput( t, read_buf, bytes_read, t->inbuf );
+      /* A client asking for MSDP variables is sent them next pulse. */
+      msdp_changed(t->character);
+    }
 
     if (bytes_read < 0)	/* Error, disconnect them. */
       return (-1);
@@ -1897,6 +2107,10 @@ static int process_input(struct descriptor_data *t)
   read_point = t->inbuf;
 
   while (nl_pos != NULL) {
+    /* A long paste into the string editor is taken a queue at a time. */
+    if (t->str && t->input.count >= INPUT_Q_SLOTS)
+      break;
+
     write_point = tmp;
     space_left = MAX_INPUT_LENGTH - 1;
 
@@ -1966,12 +2180,26 @@ static int process_input(struct descriptor_data *t)
    if ( (*tmp == '-') && (*(tmp+1) == '-') && !(*(tmp+2)) )
    {
      write_to_output(t, "All queued commands cancelled.\r\n");
-     flush_queues(t);  /* Flush the command queue */
+     flush_input_q(&t->input);  /* Flush the command queue */
      failed_subst = 1;  /* Allow the read point to be moved, but don't add to queue */
    }
 
-    if (!failed_subst)
-      write_to_q(tmp, &t->input, 0);
+    if (!failed_subst) {
+      /* Anyone this far behind is pasting or scripting faster than the game
+       * will ever run it; let them go rather than queue it all up. Builders
+       * pasting into the string editor are expected to be far ahead. */
+      if ((!t->str && CONFIG_MAX_INPUT_QUEUE > 0 && t->input.count >= CONFIG_MAX_INPUT_QUEUE) ||
+          !write_to_q(tmp, &t->input, 0)) {
+        write_to_descriptor(t->descriptor, "\r\nToo many commands queued.  Disconnecting.\r\n");
+        mudlog(BRF, LVL_GOD, TRUE, "Input flood: %s [%s] with %d commands queued.",
+          t->character && GET_NAME(t->character) ? GET_NAME(t->character) : "<unknown>",
+          t->host, t->input.count);
+        input_floods++;
+        return (-1);
+      }
+      if (t->input.peak > input_queue_peak)
+        input_queue_peak = t->input.peak;
+    }
 
     /* find the end of this line */
     while (ISNEWL(*nl_pos))
@@ -2046,6 +2274,7 @@ void close_socket(struct descriptor_data *d)
   struct descriptor_data *temp;
 
   REMOVE_FROM_LIST(d, descriptor_list, next);
+  mssp_players_changed();
   CLOSE_SOCKET(d->descriptor);
   flush_queues(d);
 
@@ -2104,8 +2333,8 @@ void close_socket(struct descriptor_data *d)
 
   if (d->showstr_head)
     free(d->showstr_head);
-  if (d->showstr_count)
-    free(d->showstr_vector);
+  if (d->showstr_lines)
+    free(d->showstr_lines);
   
   /* KaVir's plugin*/
   ProtocolDestroy( d->pProtocol );
@@ -2259,6 +2488,7 @@ static RETSIGTYPE checkpointing(int sig)
 #ifndef MEMORY_DEBUG
   if (!tics_passed) {
     log("SYSERR: CHECKPOINT shutdown: tics not updated. (Infinite loop suspected)");
+    flush_log_crash();
     abort();
   } else
     tics_passed = 0;
@@ -2272,6 +2502,14 @@ static RETSIGTYPE hupsig(int sig)
   exit(1); /* perhaps something more elegant should substituted */
 }
 
+/* Crashing: write out what has been logged, then die as we would have. */
+static RETSIGTYPE crashsig(int sig)
+{
+  flush_log_crash();
+  my_signal(sig, SIG_DFL);
+  raise(sig);
+}
+
 #endif	/* CIRCLE_UNIX */
 
 /* This is an implementation of signal() using sigaction() for portability.
@@ -2335,6 +2573,14 @@ static void signal_setup(void)
   my_signal(SIGTERM, hupsig);
   my_signal(SIGPIPE, SIG_IGN);
   my_signal(SIGALRM, SIG_IGN);
+
+  /* so the last log lines before a crash are not lost */
+  my_signal(SIGSEGV, crashsig);
+  my_signal(SIGFPE, crashsig);
+  my_signal(SIGABRT, crashsig);
+#ifdef SIGBUS
+  my_signal(SIGBUS, crashsig);
+#endif
 }
 
 #endif	/* CIRCLE_UNIX || CIRCLE_MACINTOSH */
@@ -2483,19 +2729,80 @@ void send_to_range(room_vnum start, room_vnum finish, const char *messg, ...)
   }
 }
 
+/* higher-level communication: the act() function */
+
+/* What an act() string depends on.  The ACT_SEE_ bits name the $-codes whose
+ * text changes with who is reading; the ACT_DG_ bits say what vict_obj is to
+ * an act trigger. */
+#define ACT_SEE_CH     (1 << 0)   /* $n */
+#define ACT_SEE_VICT   (1 << 1)   /* $N */
+#define ACT_SEE_OBJ    (1 << 2)   /* $o $p */
+#define ACT_SEE_VOBJ   (1 << 3)   /* $O $P */
+#define ACT_DG_VICTIM  (1 << 4)   /* $N $M $S $E */
+#define ACT_DG_TARGET  (1 << 5)   /* $O $P $A */
+#define ACT_DG_ARG     (1 << 6)   /* $T */
+
+static int act_uses(const char *orig)
+{
+  int uses = 0;
+
+  for (; *orig; orig++) {
+    if (*orig != '$' || !*(orig + 1))
+      continue;
+    switch (*(++orig)) {
+    case 'n':
+      uses |= ACT_SEE_CH;
+      break;
+    case 'N':
+      uses |= ACT_SEE_VICT | ACT_DG_VICTIM;
+      break;
+    case 'M': case 'S': case 'E':
+      uses |= ACT_DG_VICTIM;
+      break;
+    case 'o': case 'p':
+      uses |= ACT_SEE_OBJ;
+      break;
+    case 'O': case 'P':
+      uses |= ACT_SEE_VOBJ | ACT_DG_TARGET;
+      break;
+    case 'A':
+      uses |= ACT_DG_TARGET;
+      break;
+    case 'T':
+      uses |= ACT_DG_ARG;
+      break;
+    }
+  }
+  return (uses);
+}
+
+/* Which variant of the message 'to' gets: one bit for each ACT_SEE_ check
+ * the string depends on and 'to' passes. */
+static int act_variant_key(int uses, struct char_data *ch,
+    struct obj_data *obj, void *vict_obj, struct char_data *to)
+{
+  int key = 0;
+
+  if ((uses & ACT_SEE_CH) && ch && CAN_SEE(to, ch))
+    key |= ACT_SEE_CH;
+  if ((uses & ACT_SEE_VICT) && vict_obj && CAN_SEE(to, ((struct char_data *) vict_obj)))
+    key |= ACT_SEE_VICT;
+  if ((uses & ACT_SEE_OBJ) && obj && CAN_SEE_OBJ(to, obj))
+    key |= ACT_SEE_OBJ;
+  if ((uses & ACT_SEE_VOBJ) && vict_obj && CAN_SEE_OBJ(to, ((struct obj_data *) vict_obj)))
+    key |= ACT_SEE_VOBJ;
+  return (key);
+}
+
 const char *ACTNULL = "<NULL>";
 #define CHECK_NULL(pointer, expression) \
   if ((pointer) == NULL) i = ACTNULL; else i = (expression);
-/* higher-level communication: the act() function */
-void perform_act(const char *orig, struct char_data *ch, struct obj_data *obj,
-    void *vict_obj, struct char_data *to)
+static void format_act(const char *orig, struct char_data *ch, struct obj_data *obj,
+    void *vict_obj, struct char_data *to, char *lbuf)
 {
   const char *i = NULL, *colorHighLight = NULL;
-  char lbuf[MAX_STRING_LENGTH], *buf, *j;
+  char *buf, *j;
   bool uppercasenext = FALSE;
-  struct char_data *dg_victim = NULL;
-  struct obj_data *dg_target = NULL;
-  char *dg_arg = NULL;
 
   buf = lbuf;
 
@@ -2511,53 +2818,45 @@ void perform_act(const char *orig, struct char_data *ch, struct obj_data *obj,
         colorHighLight = IS_NPC((struct char_data *) vict_obj) ? NULL : colorRatio(((struct char_data *) vict_obj),
                          COLOR_RAW, COLOR_LEV((struct char_data *) vict_obj),
                          GET_HIT((struct char_data *) vict_obj), GET_MAX_HIT((struct char_data *) vict_obj));
-        dg_victim = (struct char_data *) vict_obj;
         break;
       case 'm':
         i = HMHR(ch);
         break;
       case 'M':
         CHECK_NULL(vict_obj, HMHR((const struct char_data *) vict_obj));
-        dg_victim = (struct char_data *) vict_obj;
         break;
       case 's':
         i = HSHR(ch);
         break;
       case 'S':
         CHECK_NULL(vict_obj, HSHR((const struct char_data *) vict_obj));
-        dg_victim = (struct char_data *) vict_obj;
         break;
       case 'e':
         i = HSSH(ch);
         break;
       case 'E':
         CHECK_NULL(vict_obj, HSSH((const struct char_data *) vict_obj));
-        dg_victim = (struct char_data *) vict_obj;
         break;
       case 'o':
         CHECK_NULL(obj, OBJN(obj, to));
         break;
       case 'O':
         CHECK_NULL(vict_obj, OBJN((const struct obj_data *) vict_obj, to));
-        dg_target = (struct obj_data *) vict_obj;
         break;
       case 'p':
         CHECK_NULL(obj, OBJS(obj, to));
         break;
       case 'P':
         CHECK_NULL(vict_obj, OBJS((const struct obj_data *) vict_obj, to));
-        dg_target = (struct obj_data *) vict_obj;
         break;
       case 'a':
         CHECK_NULL(obj, SANA(obj));
         break;
       case 'A':
         CHECK_NULL(vict_obj, SANA((const struct obj_data *) vict_obj));
-        dg_target = (struct obj_data *) vict_obj;
         break;
       case 'T':
         CHECK_NULL(vict_obj, (const char *) vict_obj);
-        dg_arg = (char *) vict_obj;
         break;
       case 't':
         CHECK_NULL(obj, (char *) obj);
@@ -2622,21 +2921,82 @@ void perform_act(const char *orig, struct char_data *ch, struct obj_data *obj,
   *(++buf) = '\n';
   *(++buf) = '\0';
 
-  if (to->desc)
-    write_to_output(to->desc, "%s", CAP(lbuf));
+  CAP(lbuf);
+}
+
+static void deliver_act(char *text, int uses, struct char_data *ch,
+    struct obj_data *obj, void *vict_obj, struct char_data *to, bool chatter)
+{
+  if (to->desc && chatter && output_behind(to->desc)) {
+    to->desc->out_skipped++;
+    to->desc->out_skipped_total++;
+  } else if (to->desc)
+    write_to_output(to->desc, "%s", text);
 
   if ((IS_NPC(to) && dg_act_check) && (to != ch))
-    act_mtrigger(to, lbuf, ch, dg_victim, obj, dg_target, dg_arg);
+    act_mtrigger(to, text, ch,
+        (uses & ACT_DG_VICTIM) ? (struct char_data *) vict_obj : NULL, obj,
+        (uses & ACT_DG_TARGET) ? (struct obj_data *) vict_obj : NULL,
+        (uses & ACT_DG_ARG) ? (char *) vict_obj : NULL);
+}
+
+void perform_act(const char *orig, struct char_data *ch, struct obj_data *obj,
+    void *vict_obj, struct char_data *to)
+{
+  char lbuf[MAX_STRING_LENGTH];
+
+  format_act(orig, ch, obj, vict_obj, to, lbuf);
+  deliver_act(lbuf, act_uses(orig), ch, obj, vict_obj, to, FALSE);
 
   if (last_act_message)
     free(last_act_message);
   last_act_message = strdup(lbuf);
 }
 
+void act_variants_init(struct act_variants *av, const char *str)
+{
+  av->str = str;
+  av->uses = act_uses(str);
+  av->dg_check = TRUE;
+  memset(av->text, 0, sizeof(av->text));
+}
+
+/* Sends one recipient its variant of the message, formatting it only if no
+ * earlier recipient has needed the same one.  The returned text belongs to
+ * av and lasts until act_variants_free().  These are room and channel
+ * messages, so anyone whose output is behind does not get sent them. */
+char *act_variant_send(struct act_variants *av, struct char_data *ch,
+    struct obj_data *obj, void *vict_obj, struct char_data *to)
+{
+  char lbuf[MAX_STRING_LENGTH];
+  int key = act_variant_key(av->uses, ch, obj, vict_obj, to);
+
+  if (!av->text[key]) {
+    format_act(av->str, ch, obj, vict_obj, to, lbuf);
+    av->text[key] = strdup(lbuf);
+  }
+  dg_act_check = av->dg_check;
+  deliver_act(av->text[key], av->uses, ch, obj, vict_obj, to, TRUE);
+  return (av->text[key]);
+}
+
+void act_variants_free(struct act_variants *av)
+{
+  int i;
+
+  for (i = 0; i < ACT_VARIANTS; i++)
+    if (av->text[i]) {
+      free(av->text[i]);
+      av->text[i] = NULL;
+    }
+}
+
 char *act(const char *str, int hide_invisible, struct char_data *ch,
 	 struct obj_data *obj, void *vict_obj, int type)
 {
+  struct act_variants av;
   struct char_data *to;
+  char *text = NULL;
   int to_sleeping;
 
   if (!str || !*str)
@@ -2693,7 +3053,18 @@ char *act(const char *str, int hide_invisible, struct char_data *ch,
       continue;
     if (type != TO_ROOM && to == vict_obj)
       continue;
-    perform_act(str, ch, obj, vict_obj, to);
+    if (!text) {
+      act_variants_init(&av, str);
+      av.dg_check = dg_act_check;
+    }
+    text = act_variant_send(&av, ch, obj, vict_obj, to);
+  }
+
+  if (text) {
+    if (last_act_message)
+      free(last_act_message);
+    last_act_message = strdup(text);
+    act_variants_free(&av);
   }
   return last_act_message;
 }
@@ -2703,6 +3074,9 @@ static void setup_log(const char *filename, int fd)
 {
   FILE *s_fp;
 
+  /* Log lines are written in batches; make sure the last batch goes out. */
+  atexit(flush_log_at_exit);
+
 #if defined(__MWERKS__) || defined(__GNUC__)
   s_fp = stderr;
 #else
@@ -2760,6 +3134,11 @@ static int open_logfile(const char *filename, FILE *stderr_fp)
   return (FALSE);
 }
 
+static void flush_log_at_exit(void)
+{
+  flush_log(TRUE);
+}
+
 /* This may not be pretty but it keeps game_loop() neater than if it was inline. */
 #if defined(CIRCLE_WINDOWS)
 void circle_sleep(struct timeval *timeout)
@@ -2820,20 +3199,53 @@ static void handle_webster_file(void) {
 
 
 /* KaVir's plugin*/
-static void msdp_update( void )
+/* MSDP variables are pushed rather than polled.  Whatever changes a player's
+ * hit points, mana, gold, opponent and so on calls msdp_changed(), and each
+ * descriptor marked that way is refreshed once, at the end of the pulse.
+ * Clients that did not negotiate MSDP, ATCP or GMCP are never marked. */
+void msdp_changed(struct char_data *ch)
+{
+  struct descriptor_data *d;
+
+  if (!ch || IS_NPC(ch) || !(d = ch->desc) || d->msdp_pending)
+    return;
+  if (!d->pProtocol || !(d->pProtocol->bMSDP || d->pProtocol->bATCP || d->pProtocol->bGMCP))
+    return;
+
+  d->msdp_pending = TRUE;
+  msdp_pending++;
+}
+
+/* Recounts the players MSSP reports; called as they enter and leave. */
+void mssp_players_changed(void)
 {
   struct descriptor_data *d;
   int PlayerCount = 0;
+
+  for (d = descriptor_list; d; d = d->next)
+    if (d->character && !IS_NPC(d->character) && d->connected == CON_PLAYING)
+      ++PlayerCount;
+
+  MSSPSetPlayers( PlayerCount );
+}
+
+static void msdp_update( void )
+{
+  struct descriptor_data *d;
   char buf[MAX_STRING_LENGTH];
   extern const char *pc_class_types[];
 
   for (d = descriptor_list; d; d = d->next)
   {
     struct char_data *ch = d->character;
+
+    if ( !d->msdp_pending )
+      continue;
+    d->msdp_pending = FALSE;
+
     if ( ch && !IS_NPC(ch) && d->connected == CON_PLAYING )
     {
       struct char_data *pOpponent = FIGHTING(ch);
-      ++PlayerCount;
 
       MSDPSetString( d, eMSDP_CHARACTER_NAME, GET_NAME(ch) );
       MSDPSetNumber( d, eMSDP_ALIGNMENT, GET_ALIGNMENT(ch) );
@@ -2854,7 +3266,6 @@ static void msdp_update( void )
       MSDPSetNumber( d, eMSDP_MOVEMENT_MAX, GET_MAX_MOVE(ch) );
       MSDPSetNumber( d, eMSDP_AC, compute_armor_class(ch) );
 
-      /* This would be better moved elsewhere */
       if ( pOpponent != NULL )
       {
           int hit_points = (GET_HIT(pOpponent) * 100) / GET_MAX_HIT(pOpponent);
@@ -2870,13 +3281,27 @@ static void msdp_update( void )
           MSDPSetString( d, eMSDP_OPPONENT_NAME, "" ); 
       }
 
+      if ( IN_ROOM(ch) != NOWHERE )
+      {
+          room_rnum rm = IN_ROOM(ch);
+          size_t len = 0;
+          int dir;
+
+          MSDPSetNumber( d, eMSDP_ROOM_VNUM, GET_ROOM_VNUM(rm) );
+          MSDPSetString( d, eMSDP_ROOM_NAME, world[rm].name );
+          MSDPSetString( d, eMSDP_AREA_NAME, zone_table[world[rm].zone].name );
+
+          *buf = '\0';
+          for (dir = 0; dir < DIR_COUNT; dir++)
+            if (W_EXIT(rm, dir) && W_EXIT(rm, dir)->to_room != NOWHERE &&
+                !EXIT_FLAGGED(W_EXIT(rm, dir), EX_CLOSED) && len < sizeof(buf))
+              len += snprintf(buf + len, sizeof(buf) - len, "%c%s%c%d", (char)MSDP_VAR,
+                  dirs[dir], (char)MSDP_VAL, GET_ROOM_VNUM(W_EXIT(rm, dir)->to_room));
+          MSDPSetTable( d, eMSDP_ROOM_EXITS, buf );
+      }
+
       MSDPUpdate( d );
     }
-
-    /* Ideally this should be called once at startup, and again whenever
-     * someone leaves or joins the mud.  But this works, and it keeps the
-     * snippet simple.  Optimise as you see fit.
-     */
-    MSSPSetPlayers( PlayerCount );
   }
+  msdp_pending = 0;
 }
@@ -41,12 +41,30 @@ void send_to_range(room_vnum start, room_vnum finish, const char *messg, ...)
 #define DG_NO_TRIG  256 /**< act() flag: don't check act trigger   */
 
 
+/** The texts one act() string comes out as, kept while it goes to a crowd so
+ * that each distinct variant is formatted once rather than once per reader.
+ * A variant is which of the actor, victim and objects in the string the
+ * reader can see, so there are at most ACT_VARIANTS of them. */
+#define ACT_VARIANTS 16
+struct act_variants
+{
+  const char *str;             /**< The act() string being sent */
+  int uses;                    /**< Which $-codes str depends on */
+  char *text[ACT_VARIANTS];    /**< Formatted texts, by what the reader sees */
+  bool dg_check;               /**< Fire act triggers, as act()'s dg_act_check */
+};
+
 /* act functions */
 void perform_act(const char *orig, struct char_data *ch, struct obj_data *obj, void *vict_obj, struct char_data *to);
+void act_variants_init(struct act_variants *av, const char *str);
+char *act_variant_send(struct act_variants *av, struct char_data *ch, struct obj_data *obj, void *vict_obj, struct char_data *to);
+void act_variants_free(struct act_variants *av);
 char * act(const char *str, int hide_invisible, struct char_data *ch, struct obj_data *obj, void *vict_obj, int type);
 
 /* I/O functions */
-void	write_to_q(const char *txt, struct txt_q *queue, int aliased);
+int	write_to_q(const char *txt, struct txt_q *queue, int aliased);
+void	write_to_q_front(struct txt_q *queue, struct txt_q *front);
+bool	output_behind(struct descriptor_data *d);
 int	write_to_descriptor(socket_t desc, const char *txt);
 size_t	write_to_output(struct descriptor_data *d, const char *txt, ...) __attribute__ ((format (printf, 2, 3)));
 size_t	vwrite_to_output(struct descriptor_data *d, const char *format, va_list args);
@@ -57,6 +75,8 @@ void echo_off(struct descriptor_data *d);
 void echo_on(struct descriptor_data *d);
 void game_loop(socket_t mother_desc);
 void heartbeat(int heart_pulse);
+void msdp_changed(struct char_data *ch);
+void mssp_players_changed(void);
 void copyover_recover(void);
 
 /* global buffering system - allow access to global variables within comm.c */
@@ -69,6 +89,10 @@ extern struct descriptor_data *descriptor_list;
 extern int buf_largecount;
 extern int buf_overflows;
 extern int buf_switches;
+extern int input_pool_size;
+extern int input_queue_peak;
+extern int input_floods;
+extern int output_stalls;
 extern int circle_shutdown;
 extern int circle_reboot;
 extern int no_specials;
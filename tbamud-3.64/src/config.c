@@ -231,6 +231,18 @@ int max_filesize = 50000;
 /* Maximum number of password attempts before disconnection. */
 int max_bad_pws = 3;
 
+/* Maximum number of commands a connection may have waiting to be run.  Typing
+ * (or pasting) past this is treated as a flood and the connection is closed.
+ * 0 allows the queue to fill up completely (INPUT_Q_SLOTS) before that.  Text
+ * pasted into the string editor is not counted; it is read in as it is used. */
+int max_input_queue = 100;
+
+/* Save player files in the binary format (YES) instead of ASCII (NO). Either
+ * format is always read, whichever is set; a player's file is converted the
+ * next time it is saved. The binary files load faster and are checksummed,
+ * but cannot be edited by hand. */
+int binary_pfiles = NO;
+
 /* Rationale for enabling this, as explained by Naved:
  * Usually, when you select ban a site, it is because one or two people are
  * causing troubles while there are still many people from that site who you
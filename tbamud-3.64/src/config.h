@@ -58,6 +58,8 @@ extern const char *LOGNAME;
 extern int max_playing;
 extern int max_filesize;
 extern int max_bad_pws;
+extern int max_input_queue;
+extern int binary_pfiles;
 extern int siteok_everyone;
 extern int nameserver_is_slow;
 extern int auto_save_olc;
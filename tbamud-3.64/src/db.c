@@ -42,6 +42,9 @@
 #include "class.h"
 #include "race.h"
 #include "skills.h"
+#include "help_index.h"
+#include "checkpoint.h"
+#include "asciimap.h"
 #include <sys/stat.h>
 
 /*  declarations of most of the 'global' variables */
@@ -762,9 +765,8 @@ void boot_db(void)
   load_ibt_file(SCMD_TYPO);
 
   if (!no_rent_check) {
-    log("Deleting timed-out crash and rent files:");
+    log("Timed-out crash and rent files will be deleted once the game is up.");
     update_obj_file();
-    log("   Done.");
   }
 
   /* Moved here so the object limit code works. -gg 6/24/98 */
@@ -789,11 +791,15 @@ void boot_db(void)
 }
 #endif
 
-  for (i = 0; i <= top_of_zone_table; i++) {
-    log("Resetting #%d: %s (rooms %d-%d).", zone_table[i].number,
-	zone_table[i].name, zone_table[i].bot, zone_table[i].top);
-    reset_zone(i);
-  }
+  /* After a copyover, the world is as the old process left it. */
+  if (checkpoint_pending())
+    checkpoint_load_world();
+  else
+    for (i = 0; i <= top_of_zone_table; i++) {
+      log("Resetting #%d: %s (rooms %d-%d).", zone_table[i].number,
+	  zone_table[i].name, zone_table[i].bot, zone_table[i].top);
+      reset_zone(i);
+    }
 
   reset_q.head = reset_q.tail = NULL;
 
@@ -1074,9 +1080,10 @@ void index_boot(int mode)
   }
   fclose(db_index);
 
-  /* Sort the help index. */
+  /* Sort the help index and build its word index. */
   if (mode == DB_BOOT_HLP) {
     qsort(help_table, top_of_helpt, sizeof(struct help_index_element), hsort);
+    help_index_build();
   }
 }
 
@@ -2000,7 +2007,7 @@ char *parse_object(FILE *obj_f, int nr)
   GET_OBJ_COST(obj_proto + i) = t[1];
   GET_OBJ_RENT(obj_proto + i) = t[2];
   GET_OBJ_LEVEL(obj_proto + i) = t[3];
-  GET_OBJ_TIMER(obj_proto + i) = t[4];
+  obj_proto[i].obj_flags.timer = t[4];
 
   obj_proto[i].sitting_here = NULL;
 
@@ -2249,13 +2256,17 @@ void free_help(struct help_index_element *hentry)
 
 void free_help_table(void)
 {
+  help_index_free();
+
   if (help_table) {
     int hp;
     for (hp = 0; hp < top_of_helpt; hp++) {
       if (help_table[hp].keywords)
         free(help_table[hp].keywords);
-      if (help_table[hp].entry && !help_table[hp].duplicate)
+      if (help_table[hp].entry && !help_table[hp].duplicate) {
+        page_string_release(help_table[hp].entry);
         free(help_table[hp].entry);
+      }
     }
     free(help_table);
     help_table = NULL;
@@ -2468,6 +2479,8 @@ struct obj_data *create_obj(void)
   CREATE(obj, struct obj_data, 1);
   clear_object(obj);
   obj->next = object_list;
+  if (object_list)
+    object_list->prev = obj;
   object_list = obj;
   
   obj->events = NULL;
@@ -2493,10 +2506,14 @@ struct obj_data *read_object(obj_vnum nr, int type) /* and obj_rnum */
   CREATE(obj, struct obj_data, 1);
   clear_object(obj);
   *obj = obj_proto[i];
+  obj->prev = NULL;
   obj->next = object_list;
+  if (object_list)
+    object_list->prev = obj;
   object_list = obj;
   
   obj->events = NULL;
+  set_obj_timer(obj, obj->obj_flags.timer);
 
   obj_index[i].number++;
 
@@ -2725,7 +2742,12 @@ void reset_zone(zone_rnum zone)
         snprintf(error, sizeof(error), "door does not exist in room %d - dir %d, command disabled",  world[ZCMD.arg1].number, ZCMD.arg2);
 	ZONE_ERROR(error);
 	ZCMD.command = '*';
-      } else
+      } else {
+	/* Only a door that opens or shuts changes the automap. */
+	if (!IS_SET(world[ZCMD.arg1].dir_option[ZCMD.arg2]->exit_info, EX_CLOSED) ==
+	    (ZCMD.arg3 == 1 || ZCMD.arg3 == 2))
+	  map_room_changed(ZCMD.arg1);
+
 	switch (ZCMD.arg3) {
 	case 0:
 	  REMOVE_BIT(world[ZCMD.arg1].dir_option[ZCMD.arg2]->exit_info,
@@ -2746,6 +2768,7 @@ void reset_zone(zone_rnum zone)
 		  EX_CLOSED);
 	  break;
 	}
+      }
       last_cmd = 1;
       tmob = NULL;
       tobj = NULL;
@@ -2756,11 +2779,13 @@ void reset_zone(zone_rnum zone)
         if (!SCRIPT(tmob))
           CREATE(SCRIPT(tmob), struct script_data, 1);
         add_trigger(SCRIPT(tmob), read_trigger(ZCMD.arg2), -1);
+        trig_types_attached(tmob, MOB_TRIGGER);
         last_cmd = 1;
       } else if (ZCMD.arg1==OBJ_TRIGGER && tobj) {
         if (!SCRIPT(tobj))
           CREATE(SCRIPT(tobj), struct script_data, 1);
         add_trigger(SCRIPT(tobj), read_trigger(ZCMD.arg2), -1);
+        trig_types_attached(tobj, OBJ_TRIGGER);
         last_cmd = 1;
       } else if (ZCMD.arg1==WLD_TRIGGER) {
         if (ZCMD.arg3 == NOWHERE || ZCMD.arg3>top_of_world) {
@@ -3327,40 +3352,21 @@ void free_obj(struct obj_data *obj)
 }
 
 /* Steps: 1: Read contents of a text file. 2: Make sure no one is using the
- * pointer in paging. 3: Allocate space. 4: Point 'buf' to it.
- * We don't want to free() the string that someone may be viewing in the pager.
- * page_string() keeps the internal strdup()'d copy on ->showstr_head and it
- * won't care if we delete the original.  Otherwise, strings are kept on
- * ->showstr_vector but we'll only match if the pointer is to the string we're
- * interested in and not a copy. If someone is reading a global copy we're
- * trying to replace, give everybody using it a different copy so as to avoid
- * special cases. */
+ * old text in the pager, which reads these in place; page_string_release()
+ * hands anyone still reading it their own copy. 3: Allocate space. 4: Point
+ * 'buf' to it. */
 static int file_to_string_alloc(const char *name, char **buf)
 {
-  int temppage;
   char temp[MAX_STRING_LENGTH];
-  struct descriptor_data *in_use;
-
-  for (in_use = descriptor_list; in_use; in_use = in_use->next)
-    if (in_use->showstr_vector && *in_use->showstr_vector == *buf)
-      return (-1);
 
   /* Lets not free() what used to be there unless we succeeded. */
   if (file_to_string(name, temp) < 0)
     return (-1);
 
-  for (in_use = descriptor_list; in_use; in_use = in_use->next) {
-    if (!in_use->showstr_count || *in_use->showstr_vector != *buf)
-      continue;
-
-    /* Let's be nice and leave them at the page they were on. */
-    temppage = in_use->showstr_page;
-    paginate_string((in_use->showstr_head = strdup(*in_use->showstr_vector)), in_use);
-    in_use->showstr_page = temppage;
-  }
-
-  if (*buf)
+  if (*buf) {
+    page_string_release(*buf);
     free(*buf);
+  }
   
   parse_at(temp);   
     
@@ -3884,6 +3890,8 @@ static void load_default_config( void )
   CONFIG_MAX_PLAYING            = max_playing;
   CONFIG_MAX_FILESIZE           = max_filesize;
   CONFIG_MAX_BAD_PWS            = max_bad_pws;
+  CONFIG_MAX_INPUT_QUEUE        = max_input_queue;
+  CONFIG_BINARY_PFILES          = binary_pfiles;
   CONFIG_SITEOK_ALL             = siteok_everyone;
   CONFIG_NS_IS_SLOW             = nameserver_is_slow;
   CONFIG_NEW_SOCIALS            = use_new_socials;
@@ -3930,6 +3938,11 @@ void load_config( void )
           CONFIG_OLC_SAVE = num;
         break;
 
+      case 'b':
+        if (!str_cmp(tag, "binary_pfiles"))
+          CONFIG_BINARY_PFILES = num;
+        break;
+
       case 'c':
         if (!str_cmp(tag, "crash_file_timeout"))
           CONFIG_CRASH_TIMEOUT = num;
@@ -4030,6 +4043,8 @@ void load_config( void )
           CONFIG_MAX_EXP_LOSS = num;
         else if (!str_cmp(tag, "max_filesize"))
           CONFIG_MAX_FILESIZE = num;
+        else if (!str_cmp(tag, "max_input_queue"))
+          CONFIG_MAX_INPUT_QUEUE = num;
         else if (!str_cmp(tag, "max_npc_corpse_time"))
           CONFIG_MAX_NPC_CORPSE_TIME = num;
         else if (!str_cmp(tag, "max_obj_save"))
@@ -56,6 +56,7 @@
 #define SUF_TEXT	"text"
 #define SUF_MEM	        "mem"
 #define SUF_PLR		"plr"
+#define SUF_PLRBIN	"plb"
 
 #if defined(CIRCLE_AMIGA)
 #define EXE_FILE "/bin/circle" /* maybe use argv[0] but it's not reliable */
@@ -275,8 +276,11 @@ int Crash_clean_file(char *name);
 int Crash_delete_crashfile(struct char_data *ch);
 int Crash_delete_file(char *name);
 void update_obj_file(void);
+bool Crash_sweep_rent_files(void);
 void Crash_rentsave(struct char_data *ch, int cost);
 obj_save_data *objsave_parse_objects(FILE *fl);
+obj_save_data *objsave_parse_file(FILE *fl);
+void Crash_benchmark(int passes);
 int objsave_save_obj_record(struct obj_data *obj, FILE *fl, int location);
 /* Special functions */
 SPECIAL(receptionist);
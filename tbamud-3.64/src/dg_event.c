@@ -148,10 +148,13 @@ long event_time(struct event *event)
   return (when - pulse);
 }
 
-/** Frees all events from event_q. */
+/** Frees all events from event_q. The queue is only set up by init_game(),
+ * so there is none after a syntax check or benchmark boot. */
 void event_free_all(void)
 {
-  queue_free(event_q);
+  if (event_q)
+    queue_free(event_q);
+  event_q = NULL;
 }
 
 /** Boolean function to tell whether an event is queued or not. Does this by
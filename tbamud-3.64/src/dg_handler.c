@@ -157,6 +157,7 @@ void extract_script(void *thing, int type)
     extract_trigger(trig);
   }
   TRIGGERS(sc) = NULL;
+  cmd_trig_index_free(sc);
 
   /* Thanks to James Long for tracking down this memory leak */
   free_varlist(sc->global_vars);
@@ -289,3 +290,128 @@ void update_wait_events(struct room_data *to, struct room_data *from)
     ((struct wait_event_data *)GET_TRIG_WAIT(trig)->event_obj)->go = to;
   }
 }
+
+/* Every room keeps the script types of the mobs in it, and of the objects
+ * lying in it or carried or worn by someone in it, so that dispatching a
+ * trigger can pass over the many rooms with nothing scripted in them without
+ * looking at anything. Arrivals are added to the summary as they come; a
+ * scripted departure only marks the room stale, and the summary is gathered
+ * again when next asked for. It may have bits nobody here has any more, but
+ * never misses one. Bumping trig_types_epoch makes every room stale. */
+static long trig_types_epoch = 1;
+
+static long carried_trig_types(struct char_data *ch)
+{
+  struct obj_data *obj;
+  long types = 0;
+  int i;
+
+  for (i = 0; i < NUM_WEARS; i++)
+    if (GET_EQ(ch, i) && SCRIPT(GET_EQ(ch, i)))
+      types |= SCRIPT_TYPES(SCRIPT(GET_EQ(ch, i)));
+
+  for (obj = ch->carrying; obj; obj = obj->next_content)
+    if (SCRIPT(obj))
+      types |= SCRIPT_TYPES(SCRIPT(obj));
+
+  return types;
+}
+
+static void gather_trig_types(struct room_data *room)
+{
+  struct char_data *ch;
+  struct obj_data *obj;
+
+  room->mob_trig_types = room->obj_trig_types = 0;
+
+  for (ch = room->people; ch; ch = ch->next_in_room) {
+    if (SCRIPT(ch))
+      room->mob_trig_types |= SCRIPT_TYPES(SCRIPT(ch));
+    room->obj_trig_types |= carried_trig_types(ch);
+  }
+
+  for (obj = room->contents; obj; obj = obj->next_content)
+    if (SCRIPT(obj))
+      room->obj_trig_types |= SCRIPT_TYPES(SCRIPT(obj));
+
+  room->trig_types_epoch = trig_types_epoch;
+}
+
+long room_mob_trig_types(struct room_data *room)
+{
+  if (room->trig_types_epoch != trig_types_epoch)
+    gather_trig_types(room);
+
+  return room->mob_trig_types;
+}
+
+long room_obj_trig_types(struct room_data *room)
+{
+  if (room->trig_types_epoch != trig_types_epoch)
+    gather_trig_types(room);
+
+  return room->obj_trig_types;
+}
+
+/* ch, with everything it carries, has just been put in room. */
+void trig_types_add_char(struct char_data *ch, room_rnum room)
+{
+  if (room == NOWHERE || world[room].trig_types_epoch != trig_types_epoch)
+    return;
+
+  if (SCRIPT(ch))
+    world[room].mob_trig_types |= SCRIPT_TYPES(SCRIPT(ch));
+  world[room].obj_trig_types |= carried_trig_types(ch);
+}
+
+/* ch, with everything it carries, is about to leave room. */
+void trig_types_remove_char(struct char_data *ch, room_rnum room)
+{
+  if (room == NOWHERE || world[room].trig_types_epoch != trig_types_epoch)
+    return;
+
+  if ((SCRIPT(ch) && SCRIPT_TYPES(SCRIPT(ch))) || carried_trig_types(ch))
+    world[room].trig_types_epoch = 0;
+}
+
+/* obj has just been put in room, or on someone standing there. */
+void trig_types_add_obj(struct obj_data *obj, room_rnum room)
+{
+  if (room == NOWHERE || !SCRIPT(obj) || world[room].trig_types_epoch != trig_types_epoch)
+    return;
+
+  world[room].obj_trig_types |= SCRIPT_TYPES(SCRIPT(obj));
+}
+
+/* obj is about to leave room, or someone standing there. */
+void trig_types_remove_obj(struct obj_data *obj, room_rnum room)
+{
+  if (room != NOWHERE && SCRIPT(obj) && SCRIPT_TYPES(SCRIPT(obj)))
+    world[room].trig_types_epoch = 0;
+}
+
+/* Triggers have been attached to a mob or object that is already out in the
+ * world. */
+void trig_types_attached(void *thing, int type)
+{
+  struct char_data *ch;
+  struct obj_data *obj;
+
+  switch (type) {
+  case MOB_TRIGGER:
+    ch = (struct char_data *) thing;
+    trig_types_add_char(ch, IN_ROOM(ch));
+    break;
+  case OBJ_TRIGGER:
+    obj = (struct obj_data *) thing;
+    trig_types_add_obj(obj, obj_room(obj));
+    break;
+  }
+}
+
+/* Something changed that the room summaries can't follow one room at a time
+ * (trigger types edited in place, the world array moved). */
+void trig_types_changed(void)
+{
+  trig_types_epoch++;
+}
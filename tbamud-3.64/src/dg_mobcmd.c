@@ -22,6 +22,7 @@
 #include "genzon.h" /* for real_zone_by_thing */
 #include "act.h"
 #include "fight.h"
+#include "asciimap.h"
 
 
 /* Local file scope functions. */
@@ -1065,6 +1066,8 @@ ACMD(do_mdoor)
             break;
         }
     }
+
+    map_room_changed(real_room(rm->number));
 }
 
 ACMD(do_mfollow)
@@ -20,6 +20,7 @@
 #include "constants.h"
 #include "genzon.h" /* for access to real_zone_by_thing */
 #include "fight.h" /* for die() */
+#include "asciimap.h"
 
 
 
@@ -282,7 +283,7 @@ static OCMD(do_otimer)
   else if (!isdigit(*arg))
     obj_log(obj, "otimer: bad argument");
   else
-    GET_OBJ_TIMER(obj) = atoi(arg);
+    set_obj_timer(obj, atoi(arg));
 }
 
 /* Transform into a different object. Note: this shouldn't be used with 
@@ -314,6 +315,8 @@ static OCMD(do_otransform)
     }
 
     /* move new obj info over to old object and delete new obj */
+    obj_timer_cancel(o);
+    obj_timer_cancel(obj);
     memcpy(&tmpobj, o, sizeof(*o));
     tmpobj.in_room = IN_ROOM(obj);
     tmpobj.carried_by = obj->carried_by;
@@ -326,7 +329,9 @@ static OCMD(do_otransform)
     tmpobj.script = obj->script;
     tmpobj.next_content = obj->next_content;
     tmpobj.next = obj->next;
+    tmpobj.prev = obj->prev;
     memcpy(obj, &tmpobj, sizeof(*obj));
+    set_obj_timer(obj, obj->obj_flags.timer);
 
     if (wearer) {
       equip_char(wearer, obj, pos);
@@ -678,6 +683,8 @@ static OCMD(do_odoor)
             break;
         }
     }
+
+    map_room_changed(real_room(rm->number));
 }
 
 static OCMD(do_osetval)
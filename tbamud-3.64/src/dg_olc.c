@@ -482,6 +482,9 @@ void trigedit_save(struct descriptor_data *d)
 
       live_trig = live_trig->next_in_world;
     }
+    /* Arguments and types may have changed under every script using it. */
+    cmd_trig_index_changed();
+    trig_types_changed();
   } else {
     /* this is a new trigger */
     CREATE(new_index, struct index_data *, top_of_trigt + 2);
@@ -551,6 +554,8 @@ void trigedit_save(struct descriptor_data *d)
 
     trig_index = new_index;
     top_of_trigt++;
+    trig_types_changed();
+    zone_refs_changed();
 
     /* HERE IT HAS TO GO THROUGH AND FIX ALL SCRIPTS/TRIGS OF HIGHER RNUM */
     for (live_trig = trigger_list; live_trig; live_trig = live_trig->next_in_world)
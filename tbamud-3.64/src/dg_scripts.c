@@ -937,6 +937,7 @@ void add_trigger(struct script_data *sc, trig_data *t, int loc)
   }
 
   SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(t);
+  cmd_trig_index_free(sc);
 
   t->next_in_world = trigger_list;
   trigger_list = t;
@@ -995,6 +996,7 @@ ACMD(do_attach)
     if (!SCRIPT(victim))
       CREATE(SCRIPT(victim), struct script_data, 1);
     add_trigger(SCRIPT(victim), trig, loc);
+    trig_types_attached(victim, MOB_TRIGGER);
 
     if (IS_NPC(victim))
     send_to_char(ch, "Trigger %d (%s) attached to %s [%d].\r\n",
@@ -1037,6 +1039,7 @@ ACMD(do_attach)
     if (!SCRIPT(object))
       CREATE(SCRIPT(object), struct script_data, 1);
     add_trigger(SCRIPT(object), trig, loc);
+    trig_types_attached(object, OBJ_TRIGGER);
 
     send_to_char(ch, "Trigger %d (%s) attached to %s [%d].\r\n",
                  tn, GET_TRIG_NAME(trig),
@@ -1140,6 +1143,7 @@ static int remove_trigger(struct script_data *sc, char *name)
     SCRIPT_TYPES(sc) = 0;
     for (i = TRIGGERS(sc); i; i = i->next)
       SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(i);
+    cmd_trig_index_free(sc);
 
     return 1;
   } else
@@ -1667,12 +1671,24 @@ static struct cmdlist_element *find_else_end(trig_data *trig,
   return c;
 }
 
+/* pauses a trigger for the given number of pulses */
+static void start_trig_wait(void *go, trig_data *trig, int type, long when)
+{
+  struct wait_event_data *wait_event_obj;
+
+  CREATE(wait_event_obj, struct wait_event_data, 1);
+  wait_event_obj->trigger = trig;
+  wait_event_obj->go = go;
+  wait_event_obj->type = type;
+
+  GET_TRIG_WAIT(trig) = event_create(trig_wait_event, wait_event_obj, when);
+}
+
 /* processes any 'wait' commands in a trigger */
 static void process_wait(void *go, trig_data *trig, int type, char *cmd,
                   struct cmdlist_element *cl)
 {
   char buf[MAX_INPUT_LENGTH], *arg;
-  struct wait_event_data *wait_event_obj;
   long when, hr, min, ntime;
   char c;
 
@@ -1715,12 +1731,7 @@ static void process_wait(void *go, trig_data *trig, int type, char *cmd,
     }
   }
 
-  CREATE(wait_event_obj, struct wait_event_data, 1);
-  wait_event_obj->trigger = trig;
-  wait_event_obj->go = go;
-  wait_event_obj->type = type;
-
-  GET_TRIG_WAIT(trig) = event_create(trig_wait_event, wait_event_obj, when);
+  start_trig_wait(go, trig, type, when);
   trig->curr_state = cl->next;
 }
 
@@ -1829,6 +1840,7 @@ static void process_attach(void *go, struct script_data *sc, trig_data *trig,
     if (!SCRIPT(c))
       CREATE(SCRIPT(c), struct script_data, 1);
     add_trigger(SCRIPT(c), newtrig, -1);
+    trig_types_attached(c, MOB_TRIGGER);
     return;
   }
 
@@ -1836,6 +1848,7 @@ static void process_attach(void *go, struct script_data *sc, trig_data *trig,
     if (!SCRIPT(o))
       CREATE(SCRIPT(o), struct script_data, 1);
     add_trigger(SCRIPT(o), newtrig, -1);
+    trig_types_attached(o, OBJ_TRIGGER);
     return;
   }
 
@@ -2524,6 +2537,7 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
     GET_TRIG_DEPTH(trig) = 1;
     GET_TRIG_LOOPS(trig) = 0;
     sc->context = 0;
+    trig_index[GET_TRIG_RNUM(trig)]->fired++;
   }
 
   dg_owner_purged = 0;
@@ -2955,6 +2969,129 @@ void save_char_vars_ascii(FILE *file, struct char_data *ch)
   }
 }
 
+/* Writes the state of a mob, object or room script that a fresh copy from
+ * the prototype would not have: its trigger list, its global variables and
+ * any triggers paused in a wait, with their local variables. Used by the
+ * copyover checkpoint; read back line by line by read_script_state(). */
+void save_script_state(FILE *fp, struct script_data *sc)
+{
+  struct trig_var_data *vars;
+  struct cmdlist_element *cl;
+  trig_data *t;
+  int pos, line;
+
+  if (!sc)
+    return;
+
+  fprintf(fp, "Trig:");
+  for (t = TRIGGERS(sc); t; t = t->next)
+    fprintf(fp, " %d", GET_TRIG_VNUM(t));
+  fprintf(fp, "\n");
+
+  for (vars = sc->global_vars; vars; vars = vars->next)
+    fprintf(fp, "Var : %s %ld %s\n", vars->name, vars->context, vars->value);
+
+  for (pos = 0, t = TRIGGERS(sc); t; t = t->next, pos++) {
+    if (!GET_TRIG_WAIT(t))
+      continue;
+
+    /* The line the trigger goes on from; it may be the end of the list. */
+    for (line = 0, cl = t->cmdlist; cl && cl != t->curr_state; cl = cl->next)
+      line++;
+    if (cl != t->curr_state)
+      continue;
+
+    fprintf(fp, "Wait: %d %d %d %ld %d %d\n", pos, GET_TRIG_VNUM(t), line,
+      event_time(GET_TRIG_WAIT(t)), GET_TRIG_DEPTH(t), GET_TRIG_LOOPS(t));
+    for (vars = GET_TRIG_VARS(t); vars; vars = vars->next)
+      fprintf(fp, "TVar: %s %ld %s\n", vars->name, vars->context, vars->value);
+  }
+}
+
+/* Reads back one line written by save_script_state() for go, which is a
+ * mob, object or room according to type. Returns FALSE if the line is not
+ * one of ours. A Trig line must come before the others. */
+int read_script_state(void *go, int type, char *line)
+{
+  static trig_data *waiting = NULL;
+  struct script_data **scp = NULL;
+  struct cmdlist_element *cl;
+  char name[MAX_INPUT_LENGTH], context[MAX_INPUT_LENGTH], *value;
+  trig_data *t;
+  int pos, vnum, num, depth, loops;
+  long when;
+
+  switch (type) {
+    case MOB_TRIGGER: scp = &SCRIPT((char_data *) go); break;
+    case OBJ_TRIGGER: scp = &SCRIPT((obj_data *) go); break;
+    case WLD_TRIGGER: scp = &SCRIPT((room_data *) go); break;
+    default: return FALSE;
+  }
+
+  if (!strncmp(line, "Trig:", 5)) {
+    char *p = line + 5;
+    trig_rnum rnum;
+
+    /* Keep the script copied from the prototype if it is the same. */
+    for (t = *scp ? TRIGGERS(*scp) : NULL; t; t = t->next) {
+      p = any_one_arg(p, name);
+      if (!*name || atoi(name) != GET_TRIG_VNUM(t))
+        break;
+    }
+    any_one_arg(p, name);
+    if (!t && !*name) {
+      if (!*scp)
+        CREATE(*scp, struct script_data, 1);
+      return TRUE;
+    }
+
+    if (*scp)
+      extract_script(go, type);
+    CREATE(*scp, struct script_data, 1);
+    for (p = any_one_arg(line + 5, name); *name; p = any_one_arg(p, name))
+      if ((rnum = real_trigger(atoi(name))) != NOTHING)
+        add_trigger(*scp, read_trigger(rnum), -1);
+    return TRUE;
+  }
+
+  if (strncmp(line, "Var :", 5) && strncmp(line, "TVar:", 5) && strncmp(line, "Wait:", 5))
+    return FALSE;
+
+  if (!*scp)
+    return TRUE;
+
+  if (*line == 'W') {
+    waiting = NULL;
+    if (sscanf(line + 5, "%d %d %d %ld %d %d", &pos, &vnum, &num, &when, &depth, &loops) != 6)
+      return TRUE;
+    for (t = TRIGGERS(*scp); t && pos; t = t->next)
+      pos--;
+    if (!t || GET_TRIG_VNUM(t) != vnum || GET_TRIG_WAIT(t))
+      return TRUE;
+    for (cl = t->cmdlist; cl && num; cl = cl->next)
+      num--;
+    t->curr_state = cl;
+    GET_TRIG_DEPTH(t) = MAX(1, depth);
+    GET_TRIG_LOOPS(t) = loops;
+    start_trig_wait(go, t, type, MAX(1, when));
+    waiting = t;
+    return TRUE;
+  }
+
+  value = any_one_arg(line + 5, name);
+  value = any_one_arg(value, context);
+  skip_spaces(&value);
+  if (!*name)
+    return TRUE;
+
+  if (*line == 'V')
+    add_var(&(*scp)->global_vars, name, value, atol(context));
+  else if (waiting)
+    add_var(&GET_TRIG_VARS(waiting), name, value, atol(context));
+
+  return TRUE;
+}
+
 /* find_char() helpers */
 /* Must be power of 2. */
 #define BUCKET_COUNT 64
@@ -173,6 +173,7 @@ struct script_data {
   struct trig_var_data *global_vars; /**< list of global variables   */
   ubyte purged;                      /**< script is set to be purged */
   long context;                      /**< current context for statics */
+  struct cmd_trig_index *cmd_index;  /**< command trigger keywords   */
 
   struct script_data *next;          /**< used for purged_scripts    */
 };
@@ -203,6 +204,9 @@ typedef struct char_data char_data;
 char *one_phrase(char *arg, char *first_arg);
 int is_substring(char *sub, char *string);
 int word_check(char *str, char *wordlist);
+trig_data *cmd_trig_lookup(struct script_data *sc, long type, const char *cmd, int *pos);
+void cmd_trig_index_free(struct script_data *sc);
+void cmd_trig_index_changed(void);
 
 void act_mtrigger(const char_data *ch, char *str,
 	char_data *actor, char_data *victim, obj_data *object, obj_data *target, char *arg);
@@ -300,6 +304,8 @@ struct room_data *dg_room_of_obj(struct obj_data *obj);
 bool check_flags_by_name_ar(int *array, int numflags, char *search, const char *namelist[]);
 void read_saved_vars_ascii(FILE *file, struct char_data *ch, int count);
 void save_char_vars_ascii(FILE *file, struct char_data *ch);
+void save_script_state(FILE *fp, struct script_data *sc);
+int read_script_state(void *go, int type, char *line);
 int perform_set_dg_var(struct char_data *ch, struct char_data *vict, char *val_arg);
 int trig_is_attached(struct script_data *sc, int trig_num);
 
@@ -347,6 +353,14 @@ void free_proto_script(void *thing, int type);
 void copy_proto_script(void *source, void *dest, int type);
 void delete_variables(const char *charname);
 void update_wait_events(struct room_data *to, struct room_data *from);
+long room_mob_trig_types(struct room_data *room);
+long room_obj_trig_types(struct room_data *room);
+void trig_types_add_char(struct char_data *ch, room_rnum room);
+void trig_types_remove_char(struct char_data *ch, room_rnum room);
+void trig_types_add_obj(struct obj_data *obj, room_rnum room);
+void trig_types_remove_obj(struct obj_data *obj, room_rnum room);
+void trig_types_attached(void *thing, int type);
+void trig_types_changed(void);
 
 /* from dg_comm.c */
 char *any_one_name(char *argument, char *first_arg);
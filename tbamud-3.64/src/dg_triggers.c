@@ -106,6 +106,165 @@ int word_check(char *str, char *wordlist)
     return 0;
 }
 
+/* Command trigger keyword index. Each script keeps its command triggers
+ * sorted by argument, so the triggers that answer a typed command are found
+ * by looking up each leading part of the command rather than by testing
+ * every trigger. Triggers whose argument starts with '*' answer anything and
+ * are kept in their own list. */
+struct cmd_trig_key {
+  const char *arg;          /* the trigger's argument                 */
+  int len;                  /* length of the argument                 */
+  int pos;                  /* position in the script's trigger list  */
+  trig_data *trig;
+};
+
+struct cmd_trig_index {
+  long type;                /* trigger bit the index was built for    */
+  long epoch;               /* cmd_trig_epoch when it was built       */
+  int num_keys, num_wild;
+  struct cmd_trig_key *keys;  /* sorted by argument, then position    */
+  struct cmd_trig_key *wild;  /* wildcard triggers, in list order     */
+};
+
+/* Bumped when trigger arguments are edited in place, which makes every
+ * index stale at once. */
+static long cmd_trig_epoch = 1;
+
+/* Case-insensitive comparison of two counted strings. */
+static int cmd_key_cmp(const char *a, int alen, const char *b, int blen)
+{
+  int i, diff;
+
+  for (i = 0; i < alen && i < blen; i++)
+    if ((diff = LOWER(a[i]) - LOWER(b[i])) != 0)
+      return diff;
+
+  return alen - blen;
+}
+
+static int cmd_key_sort(const void *a, const void *b)
+{
+  const struct cmd_trig_key *ka = (const struct cmd_trig_key *) a;
+  const struct cmd_trig_key *kb = (const struct cmd_trig_key *) b;
+  int diff;
+
+  if ((diff = cmd_key_cmp(ka->arg, ka->len, kb->arg, kb->len)) != 0)
+    return diff;
+  return ka->pos - kb->pos;
+}
+
+void cmd_trig_index_free(struct script_data *sc)
+{
+  if (!sc || !sc->cmd_index)
+    return;
+
+  if (sc->cmd_index->keys)
+    free(sc->cmd_index->keys);
+  if (sc->cmd_index->wild)
+    free(sc->cmd_index->wild);
+  free(sc->cmd_index);
+  sc->cmd_index = NULL;
+}
+
+void cmd_trig_index_changed(void)
+{
+  cmd_trig_epoch++;
+}
+
+static struct cmd_trig_index *cmd_trig_index_build(struct script_data *sc, long type)
+{
+  struct cmd_trig_index *idx;
+  trig_data *t;
+  int pos, count = 0;
+
+  cmd_trig_index_free(sc);
+
+  for (t = TRIGGERS(sc); t; t = t->next)
+    if (IS_SET(GET_TRIG_TYPE(t), type))
+      count++;
+
+  CREATE(idx, struct cmd_trig_index, 1);
+  idx->type = type;
+  idx->epoch = cmd_trig_epoch;
+  if (count) {
+    CREATE(idx->keys, struct cmd_trig_key, count);
+    CREATE(idx->wild, struct cmd_trig_key, count);
+  }
+
+  for (pos = 0, t = TRIGGERS(sc); t; t = t->next, pos++) {
+    struct cmd_trig_key *key;
+
+    if (!IS_SET(GET_TRIG_TYPE(t), type))
+      continue;
+
+    if (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t)) {
+      mudlog(NRM, LVL_BUILDER, TRUE, "SYSERR: Command Trigger #%d has no text argument!",
+        GET_TRIG_VNUM(t));
+      continue;
+    }
+
+    key = (*GET_TRIG_ARG(t) == '*') ? &idx->wild[idx->num_wild++] : &idx->keys[idx->num_keys++];
+    key->arg = GET_TRIG_ARG(t);
+    key->len = strlen(GET_TRIG_ARG(t));
+    key->pos = pos;
+    key->trig = t;
+  }
+
+  qsort(idx->keys, idx->num_keys, sizeof(struct cmd_trig_key), cmd_key_sort);
+
+  sc->cmd_index = idx;
+  return idx;
+}
+
+/* Returns the first command trigger of the given type that answers cmd and
+ * sits after *pos in the script's trigger list, and moves *pos onto it.
+ * Start with *pos at -1 to walk the answering triggers in list order. A
+ * trigger answers when its argument is '*' or a leading part of cmd. */
+trig_data *cmd_trig_lookup(struct script_data *sc, long type, const char *cmd, int *pos)
+{
+  struct cmd_trig_index *idx;
+  struct cmd_trig_key *best = NULL;
+  int len, cmdlen, lo, hi, mid, i;
+
+  if (!sc)
+    return NULL;
+
+  idx = sc->cmd_index;
+  if (!idx || idx->type != type || idx->epoch != cmd_trig_epoch)
+    idx = cmd_trig_index_build(sc, type);
+
+  for (i = 0; i < idx->num_wild; i++)
+    if (idx->wild[i].pos > *pos) {
+      best = &idx->wild[i];
+      break;
+    }
+
+  /* Every leading part of the command is looked up on its own. */
+  cmdlen = strlen(cmd);
+  for (len = 1; len <= cmdlen && idx->num_keys; len++) {
+    for (lo = 0, hi = idx->num_keys; lo < hi; ) {
+      mid = (lo + hi) / 2;
+      if (cmd_key_cmp(idx->keys[mid].arg, idx->keys[mid].len, cmd, len) < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    for (i = lo; i < idx->num_keys &&
+         !cmd_key_cmp(idx->keys[i].arg, idx->keys[i].len, cmd, len); i++)
+      if (idx->keys[i].pos > *pos) {
+        if (!best || idx->keys[i].pos < best->pos)
+          best = &idx->keys[i];
+        break;
+      }
+  }
+
+  if (!best)
+    return NULL;
+
+  *pos = best->pos;
+  return best->trig;
+}
+
 /*Mob triggers. */
 void random_mtrigger(char_data *ch)
 {
@@ -203,6 +362,9 @@ int greet_mtrigger(char_data *actor, int dir)
   char buf[MAX_INPUT_LENGTH];
   int intermediate, final=TRUE;
 
+  if (!(room_mob_trig_types(&world[IN_ROOM(actor)]) & (MTRIG_GREET | MTRIG_GREET_ALL)))
+    return TRUE;
+
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return TRUE;
 
@@ -295,6 +457,10 @@ int command_mtrigger(char_data *actor, char *cmd, char *argument)
   char_data *ch, *ch_next;
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
+  int pos;
+
+  if (!(room_mob_trig_types(&world[IN_ROOM(actor)]) & MTRIG_COMMAND))
+    return 0;
 
   /* prevent people we like from becoming trapped :P */
   if (!valid_dg_target(actor, 0))
@@ -305,27 +471,19 @@ int command_mtrigger(char_data *actor, char *cmd, char *argument)
 
     if (SCRIPT_CHECK(ch, MTRIG_COMMAND) && !AFF_FLAGGED(ch, AFF_CHARM) &&
        ((actor!=ch) || CONFIG_SCRIPT_PLAYERS)) {
-      for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next) {
+      pos = -1;
+      while (ch && (t = cmd_trig_lookup(SCRIPT(ch), MTRIG_COMMAND, cmd, &pos))) {
         if (!TRIGGER_CHECK(t, MTRIG_COMMAND))
           continue;
 
-        if (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t)) {
-          mudlog(NRM, LVL_BUILDER, TRUE, "SYSERR: Command Trigger #%d has no text argument!",
-            GET_TRIG_VNUM(t));
-          continue;
-        }
-
-        if (*GET_TRIG_ARG(t)=='*' ||
-            !strn_cmp(GET_TRIG_ARG(t), cmd, strlen(GET_TRIG_ARG(t)))) {
-          ADD_UID_VAR(buf, t, actor, "actor", 0);
-          skip_spaces(&argument);
-          add_var(&GET_TRIG_VARS(t), "arg", argument, 0);
-          skip_spaces(&cmd);
-          add_var(&GET_TRIG_VARS(t), "cmd", cmd, 0);
+        ADD_UID_VAR(buf, t, actor, "actor", 0);
+        skip_spaces(&argument);
+        add_var(&GET_TRIG_VARS(t), "arg", argument, 0);
+        skip_spaces(&cmd);
+        add_var(&GET_TRIG_VARS(t), "cmd", cmd, 0);
 
-          if (script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW))
-            return 1;
-        }
+        if (script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW))
+          return 1;
       }
     }
   }
@@ -339,6 +497,9 @@ void speech_mtrigger(char_data *actor, char *str)
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
 
+  if (!(room_mob_trig_types(&world[IN_ROOM(actor)]) & MTRIG_SPEECH))
+    return;
+
   for (ch = world[IN_ROOM(actor)].people; ch; ch = ch_next)
   {
     ch_next = ch->next_in_room;
@@ -557,6 +718,9 @@ int leave_mtrigger(char_data *actor, int dir)
   char_data *ch;
   char buf[MAX_INPUT_LENGTH];
 
+  if (!(room_mob_trig_types(&world[IN_ROOM(actor)]) & MTRIG_LEAVE))
+    return 1;
+
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return 1;
 
@@ -587,6 +751,9 @@ int door_mtrigger(char_data *actor, int subcmd, int dir)
   char_data *ch;
   char buf[MAX_INPUT_LENGTH];
 
+  if (!(room_mob_trig_types(&world[IN_ROOM(actor)]) & MTRIG_DOOR))
+    return 1;
+
   for (ch = world[IN_ROOM(actor)].people; ch; ch = ch->next_in_room) {
     if (!SCRIPT_CHECK(ch, MTRIG_DOOR) ||
         !AWAKE(ch) || FIGHTING(ch) || (ch == actor) ||
@@ -692,32 +859,21 @@ int cmd_otrig(obj_data *obj, char_data *actor, char *cmd,
 {
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
+  int pos = -1;
 
   if (obj && SCRIPT_CHECK(obj, OTRIG_COMMAND))
-    for (t = TRIGGERS(SCRIPT(obj)); t; t = t->next) {
-      if (!TRIGGER_CHECK(t, OTRIG_COMMAND))
-        continue;
-
-      if (IS_SET(GET_TRIG_NARG(t), type) &&
-          (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t))) {
-        mudlog(NRM, LVL_BUILDER, TRUE, "SYSERR: O-Command Trigger #%d has no text argument!",
-          GET_TRIG_VNUM(t));
+    while (obj && (t = cmd_trig_lookup(SCRIPT(obj), OTRIG_COMMAND, cmd, &pos))) {
+      if (!TRIGGER_CHECK(t, OTRIG_COMMAND) || !IS_SET(GET_TRIG_NARG(t), type))
         continue;
-      }
-
-      if (IS_SET(GET_TRIG_NARG(t), type) &&
-          (*GET_TRIG_ARG(t)=='*' ||
-          !strn_cmp(GET_TRIG_ARG(t), cmd, strlen(GET_TRIG_ARG(t))))) {
 
-        ADD_UID_VAR(buf, t, actor, "actor", 0);
-        skip_spaces(&argument);
-        add_var(&GET_TRIG_VARS(t), "arg", argument, 0);
-        skip_spaces(&cmd);
-        add_var(&GET_TRIG_VARS(t), "cmd", cmd, 0);
+      ADD_UID_VAR(buf, t, actor, "actor", 0);
+      skip_spaces(&argument);
+      add_var(&GET_TRIG_VARS(t), "arg", argument, 0);
+      skip_spaces(&cmd);
+      add_var(&GET_TRIG_VARS(t), "cmd", cmd, 0);
 
-        if (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW))
-          return 1;
-      }
+      if (script_driver(&obj, t, OBJ_TRIGGER, TRIG_NEW))
+        return 1;
     }
 
   return 0;
@@ -728,6 +884,10 @@ int command_otrigger(char_data *actor, char *cmd, char *argument)
   obj_data *obj;
   int i;
 
+  /* The actor's own things are counted in with the room's. */
+  if (!(room_obj_trig_types(&world[IN_ROOM(actor)]) & OTRIG_COMMAND))
+    return 0;
+
   /* prevent people we like from becoming trapped :P */
   if (!valid_dg_target(actor, 0))
     return 0;
@@ -905,6 +1065,9 @@ int leave_otrigger(room_data *room, char_data *actor, int dir)
   int temp, final = 1;
   obj_data *obj, *obj_next;
 
+  if (!(room_obj_trig_types(room) & OTRIG_LEAVE))
+    return 1;
+
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return 1;
 
@@ -1046,6 +1209,7 @@ int command_wtrigger(char_data *actor, char *cmd, char *argument)
   struct room_data *room;
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
+  int pos = -1;
 
   if (!actor || !SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_COMMAND))
     return 0;
@@ -1055,26 +1219,17 @@ int command_wtrigger(char_data *actor, char *cmd, char *argument)
     return 0;
 
   room = &world[IN_ROOM(actor)];
-  for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
+  while ((t = cmd_trig_lookup(SCRIPT(room), WTRIG_COMMAND, cmd, &pos))) {
     if (!TRIGGER_CHECK(t, WTRIG_COMMAND))
       continue;
 
-    if (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t)) {
-      mudlog(NRM, LVL_BUILDER, TRUE, "SYSERR: W-Command Trigger #%d has no text argument!",
-        GET_TRIG_VNUM(t));
-      continue;
-    }
-
-    if (*GET_TRIG_ARG(t)=='*' ||
-        !strn_cmp(GET_TRIG_ARG(t), cmd, strlen(GET_TRIG_ARG(t)))) {
-      ADD_UID_VAR(buf, t, actor, "actor", 0);
-      skip_spaces(&argument);
-      add_var(&GET_TRIG_VARS(t), "arg", argument, 0);
-      skip_spaces(&cmd);
-      add_var(&GET_TRIG_VARS(t), "cmd", cmd, 0);
+    ADD_UID_VAR(buf, t, actor, "actor", 0);
+    skip_spaces(&argument);
+    add_var(&GET_TRIG_VARS(t), "arg", argument, 0);
+    skip_spaces(&cmd);
+    add_var(&GET_TRIG_VARS(t), "cmd", cmd, 0);
 
-      return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
-    }
+    return script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
   }
 
   return 0;
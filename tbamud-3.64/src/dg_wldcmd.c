@@ -20,6 +20,7 @@
 #include "constants.h"
 #include "genzon.h" /* for zone_rnum real_zone_by_thing */
 #include "fight.h"  /* for die() */
+#include "asciimap.h"
 
 /* Local functions, macros, defines and structs */
 
@@ -275,6 +276,8 @@ WCMD(do_wdoor)
             break;
         }
     }
+
+    map_room_changed(real_room(rm->number));
 }
 
 WCMD(do_wteleport)
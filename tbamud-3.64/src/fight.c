@@ -29,6 +29,7 @@
 #include "quest.h"
 #include "spec_procs.h"
 #include "skills.h"
+#include "mud_event.h"
 
 
 /* locally defined global variables, used externally */
@@ -78,6 +79,7 @@ static void solo_gain(struct char_data *ch, struct char_data *victim);
 static char *replace_string(const char *str, const char *weapon_singular, const char *weapon_plural);
 static int compute_thaco(struct char_data *ch, struct char_data *vict);
 static char *getDamageMessage(struct char_data *ch, struct char_data *vict, int damage, int msgTo);
+static long mob_combat_delay(struct char_data *ch);
 
 #define MSG_TO_ROOM       0
 #define MSG_TO_ATTACKER   1
@@ -114,6 +116,8 @@ int compute_armor_class(struct char_data *ch)
 
 void update_pos(struct char_data *victim)
 {
+  msdp_changed(victim);
+
   if ((GET_HIT(victim) > 0) && (GET_POS(victim) > POS_STUNNED))
     return;
   else if (GET_HIT(victim) > 0)
@@ -160,6 +164,12 @@ void set_fighting(struct char_data *ch, struct char_data *vict)
 
   FIGHTING(ch) = vict;
   GET_POS(ch) = POS_FIGHTING;
+  msdp_changed(ch);
+
+  /* Mobiles get their own combat action event; one may still be running if
+   * the mob switched targets from inside its own action. */
+  if (IS_NPC(ch) && !char_has_mud_event(ch, eCOMBAT_ACTION))
+    NEW_EVENT(eCOMBAT_ACTION, ch, NULL, 1);
 
   if (!CONFIG_PK_ALLOWED)
     check_killer(ch, vict);
@@ -169,6 +179,7 @@ void set_fighting(struct char_data *ch, struct char_data *vict)
 void stop_fighting(struct char_data *ch)
 {
   struct char_data *temp;
+  struct mud_event_data *pMudEvent;
 
   if (ch == next_combat_list)
     next_combat_list = ch->next_fighting;
@@ -176,6 +187,12 @@ void stop_fighting(struct char_data *ch)
   REMOVE_FROM_LIST(ch, combat_list, next_fighting);
   ch->next_fighting = NULL;
   FIGHTING(ch) = NULL;
+
+  /* A running event is not queued and retires itself once it sees that the
+   * mob is no longer fighting. */
+  if ((pMudEvent = char_has_mud_event(ch, eCOMBAT_ACTION)) != NULL &&
+      event_is_queued(pMudEvent->pEvent))
+    event_cancel(pMudEvent->pEvent);
   GET_POS(ch) = POS_STANDING;
   update_pos(ch);
 }
@@ -213,9 +230,9 @@ static void make_corpse(struct char_data *ch)
   GET_OBJ_WEIGHT(corpse) = GET_WEIGHT(ch) + IS_CARRYING_W(ch);
   GET_OBJ_RENT(corpse) = 100000;
   if (IS_NPC(ch))
-    GET_OBJ_TIMER(corpse) = CONFIG_MAX_NPC_CORPSE_TIME;
+    set_obj_timer(corpse, CONFIG_MAX_NPC_CORPSE_TIME);
   else
-    GET_OBJ_TIMER(corpse) = CONFIG_MAX_PC_CORPSE_TIME;
+    set_obj_timer(corpse, CONFIG_MAX_PC_CORPSE_TIME);
 
   /* transfer character's inventory to the corpse */
   corpse->contains = ch->carrying;
@@ -765,7 +782,7 @@ static char *getDamageMessage(struct char_data *ch, struct char_data *vict, int
   char *msg = "ERROR!";
   bool ok = FALSE;
   // make sure its not zero cause we cant use "You missed".
-  int painPercentage = ((damage * 100) / GET_HIT(vict)) + 1;
+  int painPercentage = ((damage * 100) / MAX(1, GET_HIT(vict))) + 1;
 
   while((message = (struct damage_message_type *) simple_list(damageMessageList))) {
 
@@ -915,6 +932,9 @@ void perform_violence(void)
       continue;
     }
 
+    /* Others may have hurt the opponent since the last round. */
+    msdp_changed(ch);
+
     if (STUN(ch) > 0) {
       STUN(ch) -= PULSE_VIOLENCE;
       if(STUN(ch) < 0) {
@@ -950,24 +970,64 @@ void perform_violence(void)
 }
 
 /*
- * Mobile behavior
+ * Number of pulses until the mob can next take a combat action: its class
+ * cadence (halved when hasted), or, while stunned or waiting, the pulse after
+ * the violence round that brings the stun below one.
+ */
+static long mob_combat_delay(struct char_data *ch)
+{
+  long delay, rounds;
+
+  delay = mobCombatCadence(ch);
+  if (AFF_FLAGGED(ch, AFF_HASTE))
+    delay /= 2;
+  delay = MAX(1, delay);
+
+  /* The stun wears off in perform_violence(), which runs after the events
+   * of its pulse. */
+  if (STUN(ch) > 0) {
+    rounds = (STUN(ch) + PULSE_VIOLENCE - 1) / PULSE_VIOLENCE;
+    delay = MAX(delay, (PULSE_VIOLENCE - (long) (pulse % PULSE_VIOLENCE)) % PULSE_VIOLENCE +
+                (rounds - 1) * PULSE_VIOLENCE + 1);
+  }
+
+  return delay;
+}
+
+/*
+ * Mobile behavior. Each fighting mob carries an eCOMBAT_ACTION event, attached
+ * by set_fighting() and cancelled by stop_fighting(), that sleeps until the mob
+ * can next act, so only the mobs that are due get visited on a given pulse.
  */
-void performMobCombatAction(void) {
+EVENTFUNC(event_combat_action)
+{
+  struct mud_event_data *pMudEvent;
   struct char_data *ch;
 
-  for (ch = combat_list; ch; ch = next_combat_list) {
-    next_combat_list = ch->next_fighting;
+  if (event_obj == NULL)
+    return 0;
 
-    if (IS_NPC(ch)) {
+  pMudEvent = (struct mud_event_data *) event_obj;
+  ch = (struct char_data *) pMudEvent->pStruct;
 
-      if (STUN(ch) < 1 && GET_POS(ch) < POS_FIGHTING) {
-        do_stand(ch, NULL, 0, 0);
-        GET_POS(ch) = POS_FIGHTING;
-      }
+  if (!FIGHTING(ch) || MOB_FLAGGED(ch, MOB_NOTDEADYET))
+    return 0;
 
-      mobCombatAction(ch);
-    }
+  /* Stunned by something that happened while the event slept. */
+  if (STUN(ch) > 0)
+    return mob_combat_delay(ch);
+
+  if (GET_POS(ch) < POS_FIGHTING) {
+    do_stand(ch, NULL, 0, 0);
+    GET_POS(ch) = POS_FIGHTING;
   }
+
+  mobCombatAction(ch);
+
+  if (!FIGHTING(ch) || MOB_FLAGGED(ch, MOB_NOTDEADYET))
+    return 0;
+
+  return mob_combat_delay(ch);
 }
 static int maxClassAttacks[NUM_CLASSES] = {
     3,  3,  3,  4,  3,  3,  4,  3,  3,  3,  3, 3
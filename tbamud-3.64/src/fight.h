@@ -34,7 +34,6 @@ void  set_fighting(struct char_data *ch, struct char_data *victim);
 int skill_message(int dam, struct char_data *ch, struct char_data *vict,
           int attacktype);
 void  stop_fighting(struct char_data *ch);
-void performMobCombatAction(void);
 int computeNumberAttacks(struct char_data *ch);
 
 
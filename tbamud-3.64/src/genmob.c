@@ -43,6 +43,9 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
     return rnum;
   }
 
+  /* Every mobile from here up moves to the next rnum. */
+  zone_refs_changed();
+
   RECREATE(mob_proto, struct char_data, top_of_mobt + 2);
   RECREATE(mob_index, struct index_data, top_of_mobt + 2);
   top_of_mobt++;
@@ -156,6 +159,7 @@ int delete_mobile(mob_rnum refpt)
     log("SYSERR: GenOLC: delete_mobile: Invalid rnum %d.", refpt);
     return NOBODY;
   }
+  zone_refs_changed();
 
   vnum = mob_index[refpt].vnum;
   proto = &mob_proto[refpt];
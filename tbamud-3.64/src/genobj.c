@@ -38,6 +38,9 @@ obj_rnum add_object(struct obj_data *newobj, obj_vnum ovnum)
     return newobj->item_number;
   }
 
+  /* Every object from here up moves to the next rnum. */
+  zone_refs_changed();
+
   found = insert_object(newobj, ovnum);
   adjust_objects(found);
   add_to_save_list(zone_table[rznum].number, SL_OBJ);
@@ -59,6 +62,10 @@ static int update_all_objects(struct obj_data *refobj)
 
     count++;
 
+    /* Whoever is wearing it trades the old affects for the new ones. */
+    if (obj->worn_by)
+      affect_modify_obj(obj->worn_by, obj, FALSE);
+
     /* Update the existing object but save a copy for private information. */
     swap = *obj;
     *obj = *refobj;
@@ -73,7 +80,16 @@ static int update_all_objects(struct obj_data *refobj)
     obj->contains = swap.contains;
     obj->next_content = swap.next_content;
     obj->next = swap.next;
+    obj->prev = swap.prev;
     obj->sitting_here = swap.sitting_here;
+    /* The timer keeps counting down where it is on the timer wheel. */
+    obj->obj_flags.timer = swap.obj_flags.timer;
+    obj->timer_expire = swap.timer_expire;
+    obj->next_timer = swap.next_timer;
+    obj->prev_timer = swap.prev_timer;
+
+    if (obj->worn_by)
+      affect_modify_obj(obj->worn_by, obj, TRUE);
   }
 
   return count;
@@ -382,6 +398,7 @@ int delete_object(obj_rnum rnum)
 
   if (rnum == NOTHING || rnum > top_of_objt)
     return NOTHING;
+  zone_refs_changed();
 
   obj = &obj_proto[rnum];
 
@@ -539,6 +556,9 @@ bool oset_apply(struct obj_data *obj, char * argument)
   if (location == -1)
     return FALSE;
   
+  if (obj->worn_by)
+    affect_modify_obj(obj->worn_by, obj, FALSE);
+
   obj->affected[location].modifier = mod + value;
   
   /* Our modifier is set at 0, so lets just clear the apply location so that it may
@@ -547,6 +567,9 @@ bool oset_apply(struct obj_data *obj, char * argument)
     obj->affected[location].location = apply;
   else
     obj->affected[location].location = APPLY_NONE;
+
+  if (obj->worn_by)
+    affect_modify_obj(obj->worn_by, obj, TRUE);
   
   return TRUE;
 }
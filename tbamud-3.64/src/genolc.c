@@ -159,8 +159,10 @@ void free_ex_descriptions(struct extra_descr_data *head)
     next_one = thised->next;
     if (thised->keyword)
       free(thised->keyword);
-    if (thised->description)
+    if (thised->description) {
+      page_string_release(thised->description);
       free(thised->description);
+    }
     free(thised);
   }
 }
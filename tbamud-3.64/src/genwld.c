@@ -18,6 +18,7 @@
 #include "shop.h"
 #include "dg_olc.h"
 #include "mud_event.h"
+#include "asciimap.h"
 
 
 /* This function will copy the strings so be sure you free your own copies of 
@@ -32,6 +33,11 @@ room_rnum add_room(struct room_data *room)
   if (room == NULL)
     return NOWHERE;
 
+  /* The room structs are about to be copied over one another. */
+  trig_types_changed();
+  map_tiles_changed();
+  zone_refs_changed();
+
   if ((i = real_room(room->number)) != NOWHERE) {
     if (SCRIPT(&world[i]))
       extract_script(&world[i], WLD_TRIGGER);
@@ -131,6 +137,9 @@ int delete_room(room_rnum rnum)
     return FALSE;
 
   room = &world[rnum];
+  trig_types_changed();
+  map_tiles_changed();
+  zone_refs_changed();
 
   add_to_save_list(zone_table[room->zone].number, SL_WLD);
 
@@ -175,6 +175,7 @@ zone_rnum create_new_zone(zone_vnum vzone_num, room_vnum bottom, room_vnum top,
    * through top_of_zone (top_of_zone_table + 1 items) and a new one which
    * makes it top_of_zone_table + 2 elements large. */
   RECREATE(zone_table, struct zone_data, top_of_zone_table + 2);
+  zone_refs_changed();
   zone_table[top_of_zone_table + 1].number = 32000;
 
   if (vzone_num > zone_table[top_of_zone_table].number)
@@ -524,6 +525,7 @@ void add_cmd_to_list(struct reset_com **list, struct reset_com *newcmd, int pos)
   newlist[count + 1].command = 'S';
   free(*list);
   *list = newlist;
+  zone_refs_changed();
 }
 
 /* Remove a reset command from a list. Takes a pointer to the list so that it
@@ -550,6 +552,7 @@ static void remove_cmd_from_list(struct reset_com **list, int pos)
   newlist[count - 1].command = 'S';
   free(*list);
   *list = newlist;
+  zone_refs_changed();
 }
 
 /* Error check user input and then add new (blank) command. */
@@ -587,3 +590,176 @@ void delete_zone_command(struct zone_data *zone, int pos)
   remove_cmd_from_list(&zone->cmd, pos);
 }
 
+
+/* Reverse index of zone commands and script attachments. Everything that
+ * adds, removes or renumbers zone commands, prototypes, rooms or triggers
+ * calls zone_refs_changed(), and the index is built again from scratch the
+ * next time somebody asks for it. */
+static bool zone_refs_stale = TRUE;
+static struct zone_ref *zref_list[NUM_ZONE_REFS];
+static int *zref_start[NUM_ZONE_REFS];
+static int zref_targets[NUM_ZONE_REFS];
+
+/* The references found so far while building, in the order they were met. */
+static struct zone_ref *zref_found;
+static int *zref_found_kind, *zref_found_target;
+static int zref_num_found, zref_max_found;
+
+void zone_refs_changed(void)
+{
+  zone_refs_stale = TRUE;
+}
+
+/* A prototype updated in place keeps its rnum, so the index only goes stale
+ * if the editor changed which triggers are attached to it. */
+void zone_refs_script_edited(struct trig_proto_list *old, struct trig_proto_list *edited)
+{
+  for (; old && edited; old = old->next, edited = edited->next)
+    if (old->vnum != edited->vnum)
+      break;
+
+  if (old || edited)
+    zone_refs_stale = TRUE;
+}
+
+static void note_zone_ref(int kind, int target, struct zone_ref *ref)
+{
+  if (target < 0 || target >= zref_targets[kind])
+    return;
+
+  if (zref_num_found == zref_max_found) {
+    zref_max_found = zref_max_found ? zref_max_found * 2 : 256;
+    RECREATE(zref_found, struct zone_ref, zref_max_found);
+    RECREATE(zref_found_kind, int, zref_max_found);
+    RECREATE(zref_found_target, int, zref_max_found);
+  }
+  zref_found[zref_num_found] = *ref;
+  zref_found_kind[zref_num_found] = kind;
+  zref_found_target[zref_num_found] = target;
+  zref_num_found++;
+}
+
+static void note_script_refs(struct trig_proto_list *tpl, struct zone_ref *ref)
+{
+  for (; tpl; tpl = tpl->next)
+    note_zone_ref(ZONE_REF_TRIG, real_trigger(tpl->vnum), ref);
+}
+
+static void build_zone_refs(void)
+{
+  struct zone_ref ref;
+  struct reset_com *c;
+  zone_rnum zone;
+  int i, kind, *start;
+
+  zref_targets[ZONE_REF_MOB] = top_of_mobt + 1;
+  zref_targets[ZONE_REF_OBJ] = top_of_objt + 1;
+  zref_targets[ZONE_REF_TRIG] = top_of_trigt;
+  zref_num_found = 0;
+
+  /* Walk the commands the way a reset would, remembering which room, mob and
+   * object each one works on. */
+  for (zone = 0; zone <= top_of_zone_table; zone++) {
+    ref.zone = zone;
+    ref.room = ref.mob = ref.obj = 0;
+    for (ref.cmd_no = 0; (c = &zone_table[zone].cmd[ref.cmd_no])->command != 'S'; ref.cmd_no++) {
+      ref.command = c->command;
+      ref.type = 0;
+      switch (c->command) {
+      case 'M':
+        ref.room = c->arg3;
+        ref.mob = c->arg1;
+        note_zone_ref(ZONE_REF_MOB, c->arg1, &ref);
+        break;
+      case 'O':
+        ref.room = c->arg3;
+        ref.obj = c->arg1;
+        note_zone_ref(ZONE_REF_OBJ, c->arg1, &ref);
+        break;
+      case 'P':
+      case 'G':
+      case 'E':
+        ref.obj = c->arg1;
+        note_zone_ref(ZONE_REF_OBJ, c->arg1, &ref);
+        break;
+      case 'R':
+        ref.room = c->arg1;
+        note_zone_ref(ZONE_REF_OBJ, c->arg2, &ref);
+        break;
+      case 'T':
+        ref.type = c->arg1;
+        note_zone_ref(ZONE_REF_TRIG, c->arg2, &ref);
+        break;
+      }
+    }
+  }
+
+  /* Then the scripts attached to prototypes and rooms. */
+  ref.zone = NOWHERE;
+  ref.cmd_no = -1;
+  ref.command = 0;
+  ref.room = ref.mob = ref.obj = 0;
+  ref.type = MOB_TRIGGER;
+  for (ref.mob = 0; ref.mob <= top_of_mobt; ref.mob++)
+    note_script_refs(mob_proto[ref.mob].proto_script, &ref);
+  ref.mob = 0;
+  ref.type = OBJ_TRIGGER;
+  for (ref.obj = 0; ref.obj <= top_of_objt; ref.obj++)
+    note_script_refs(obj_proto[ref.obj].proto_script, &ref);
+  ref.obj = 0;
+  ref.type = WLD_TRIGGER;
+  for (ref.room = 0; ref.room <= top_of_world; ref.room++)
+    note_script_refs(world[ref.room].proto_script, &ref);
+
+  /* Sort them by what they refer to, keeping the order they were found in.
+   * zref_start[kind][n] ends up as the first reference to rnum n. */
+  for (kind = 0; kind < NUM_ZONE_REFS; kind++) {
+    if (zref_start[kind])
+      free(zref_start[kind]);
+    CREATE(zref_start[kind], int, zref_targets[kind] + 1);
+  }
+
+  for (i = 0; i < zref_num_found; i++)
+    zref_start[zref_found_kind[i]][zref_found_target[i] + 1]++;
+
+  for (kind = 0; kind < NUM_ZONE_REFS; kind++) {
+    start = zref_start[kind];
+    for (i = 0; i < zref_targets[kind]; i++)
+      start[i + 1] += start[i];
+    if (zref_list[kind])
+      free(zref_list[kind]);
+    CREATE(zref_list[kind], struct zone_ref, MAX(start[zref_targets[kind]], 1));
+  }
+
+  for (i = 0; i < zref_num_found; i++) {
+    start = zref_start[zref_found_kind[i]];
+    zref_list[zref_found_kind[i]][start[zref_found_target[i]]++] = zref_found[i];
+  }
+
+  /* Filling moved each start along to the next one's; put them back. */
+  for (kind = 0; kind < NUM_ZONE_REFS; kind++) {
+    start = zref_start[kind];
+    for (i = zref_targets[kind]; i > 0; i--)
+      start[i] = start[i - 1];
+    start[0] = 0;
+  }
+
+  zone_refs_stale = FALSE;
+}
+
+/* Finds every zone command and script attachment that refers to rnum, which
+ * is a mob, object or trigger rnum depending on kind. Returns how many there
+ * are and points refs at the first of them. */
+int find_zone_refs(int kind, int rnum, struct zone_ref **refs)
+{
+  if (zone_refs_stale)
+    build_zone_refs();
+
+  if (kind < 0 || kind >= NUM_ZONE_REFS || rnum < 0 || rnum >= zref_targets[kind]) {
+    *refs = NULL;
+    return 0;
+  }
+
+  *refs = zref_list[kind] + zref_start[kind][rnum];
+  return zref_start[kind][rnum + 1] - zref_start[kind][rnum];
+}
@@ -12,6 +12,25 @@
 #ifndef _GENZON_H_
 #define _GENZON_H_
 
+/* What find_zone_refs() can be asked about. */
+#define ZONE_REF_MOB    0
+#define ZONE_REF_OBJ    1
+#define ZONE_REF_TRIG   2
+#define NUM_ZONE_REFS   3
+
+/** A zone command that refers to a mob, object or trigger, or a trigger
+ * attached to a prototype or room. */
+struct zone_ref
+{
+  zone_rnum zone;  /**< Zone of the command, or NOWHERE for an attached script */
+  int cmd_no;      /**< Position in the zone's command list, or -1 */
+  char command;    /**< The command letter, or 0 for an attached script */
+  int type;        /**< MOB_TRIGGER, OBJ_TRIGGER or WLD_TRIGGER for triggers */
+  room_rnum room;  /**< Room the command (or attached script) is in */
+  mob_rnum mob;    /**< Mob last loaded before the command, or script owner */
+  obj_rnum obj;    /**< Object last loaded before the command, or script owner */
+};
+
 zone_rnum create_new_zone(zone_vnum vzone_num, room_vnum bottom, room_vnum top, const char **error);
 void remove_room_zone_commands(zone_rnum zone, room_rnum room_num);
 int save_zone(zone_rnum zone_num);
@@ -21,5 +40,8 @@ int new_command(struct zone_data *zone, int pos);
 void delete_zone_command(struct zone_data *zone, int pos);
 zone_rnum real_zone_by_thing(room_vnum vznum);
 void create_world_index(int znum, const char *type);
+void zone_refs_changed(void);
+void zone_refs_script_edited(struct trig_proto_list *old, struct trig_proto_list *edited);
+int find_zone_refs(int kind, int rnum, struct zone_ref **refs);
 
 #endif /* _GENZON_H_ */
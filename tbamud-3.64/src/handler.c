@@ -31,7 +31,6 @@ static int extractions_pending = 0;
 /* local file scope functions */
 static int apply_ac(struct char_data *ch, int eq_pos);
 static void update_object(struct obj_data *obj, int use);
-static void affect_modify_ar(struct char_data * ch, byte loc, sbyte mod, int bitv[], bool add);
 
 char *fname(const char *namelist)
 {
@@ -192,76 +191,151 @@ void aff_apply_modify(struct char_data *ch, byte loc, sbyte mod, char *msg)
   } /* switch */
 }
 
-static void affect_modify_ar(struct char_data * ch, byte loc, sbyte mod, int bitv[], bool add)
+/* Counts the AFF_ flags in bitv on or off the character. A flag is only
+ * cleared once nothing the character has on or is affected by still sets it. */
+static void affect_modify_flags(struct char_data *ch, int bitv[], bool add)
 {
-  int i , j;
+  int i, j, bit;
 
-  if (add) {
-    for(i = 0; i < AF_ARRAY_MAX; i++)
-      for(j = 0; j < 32; j++)
-        if(IS_SET_AR(bitv, (i*32)+j))
-          SET_BIT_AR(AFF_FLAGS(ch), (i*32)+j);
-  } else {
-    for(i = 0; i < AF_ARRAY_MAX; i++)
-      for(j = 0; j < 32; j++)
-        if(IS_SET_AR(bitv, (i*32)+j))
-          REMOVE_BIT_AR(AFF_FLAGS(ch), (i*32)+j);
+  for (i = 0; i < AF_ARRAY_MAX; i++) {
+    if (!bitv[i])
+      continue;
+    for (j = 0; j < 32; j++) {
+      bit = (i*32)+j;
+      if (!IS_SET_AR(bitv, bit))
+        continue;
+      if (add) {
+        if (ch->aff_sums.flags[bit] < 255)
+          ch->aff_sums.flags[bit]++;
+        SET_BIT_AR(AFF_FLAGS(ch), bit);
+      } else if (ch->aff_sums.flags[bit] > 1)
+        ch->aff_sums.flags[bit]--;
+      else {
+        ch->aff_sums.flags[bit] = 0;
+        REMOVE_BIT_AR(AFF_FLAGS(ch), bit);
+      }
+    }
+  }
+}
+
+/* Adds one apply to, or takes it off, the character's running totals. The
+ * ability scores are left for affect_total() to work out from the totals;
+ * everything else is applied to the character straight away. */
+static void affect_modify_apply(struct char_data *ch, byte loc, sbyte mod, bool add)
+{
+  if (!add)
     mod = -mod;
+
+  if (loc >= 0 && loc < NUM_APPLIES)
+    ch->aff_sums.apply[(int)loc] += mod;
+
+  switch (loc) {
+  case APPLY_STR:
+  case APPLY_DEX:
+  case APPLY_INT:
+  case APPLY_WIS:
+  case APPLY_CON:
+  case APPLY_CHA:
+    break;
+  default:
+    aff_apply_modify(ch, loc, mod, "affect_modify_apply");
+    break;
   }
+}
 
-  aff_apply_modify(ch, loc, mod, "affect_modify_ar");
+static void affect_modify_ar(struct char_data * ch, byte loc, sbyte mod, int bitv[], bool add)
+{
+  affect_modify_flags(ch, bitv, add);
+  affect_modify_apply(ch, loc, mod, add);
 }
 
-/* This updates a character by subtracting everything he is affected by
- * restoring original abilities, and then affecting all again. */
-void affect_total(struct char_data *ch)
+/* Puts on or takes off all the affects of a worn object. Used by equip_char()
+ * and unequip_char(), and by anything that changes an object while it is
+ * being worn. */
+void affect_modify_obj(struct char_data *ch, struct obj_data *obj, bool add)
 {
-  struct affected_type *af;
-  int i, j;
+  int j;
 
-  for (i = 0; i < NUM_WEARS; i++) {
-    if (GET_EQ(ch, i))
-      for (j = 0; j < MAX_OBJ_AFFECT; j++)
-	affect_modify_ar(ch, GET_EQ(ch, i)->affected[j].location,
-		      GET_EQ(ch, i)->affected[j].modifier,
-		      GET_OBJ_AFFECT(GET_EQ(ch, i)), FALSE);
-  }
+  affect_modify_flags(ch, GET_OBJ_AFFECT(obj), add);
+  for (j = 0; j < MAX_OBJ_AFFECT; j++)
+    affect_modify_apply(ch, obj->affected[j].location,
+		  obj->affected[j].modifier, add);
+  affect_total(ch);
+}
 
-  for (af = ch->affected; af; af = af->next)
-    affect_modify_ar(ch, af->location, af->modifier, af->bitvector, FALSE);
+/* This works out a character's current abilities from the original ones and
+ * the running totals of everything he is affected by. */
+void affect_total(struct char_data *ch)
+{
+  int i, max, str;
 
-  ch->aff_abils = ch->real_abils;
+  msdp_changed(ch);
 
-  for (i = 0; i < NUM_WEARS; i++) {
-    if (GET_EQ(ch, i))
-      for (j = 0; j < MAX_OBJ_AFFECT; j++)
-	affect_modify_ar(ch, GET_EQ(ch, i)->affected[j].location,
-		      GET_EQ(ch, i)->affected[j].modifier,
-		      GET_OBJ_AFFECT(GET_EQ(ch, i)), TRUE);
-  }
+  /* Something may have cleared a flag that an affect still grants. */
+  for (i = 0; i < AF_ARRAY_MAX * 32; i++)
+    if (ch->aff_sums.flags[i])
+      SET_BIT_AR(AFF_FLAGS(ch), i);
 
-  for (af = ch->affected; af; af = af->next)
-    affect_modify_ar(ch, af->location, af->modifier, af->bitvector, TRUE);
+  ch->aff_abils = ch->real_abils;
 
   /* Make certain values are between 0..25, not < 0 and not > 25! */
-  i = (IS_NPC(ch) || GET_LEVEL(ch) >= LVL_GRGOD) ? 25 : 18;
+  max = (IS_NPC(ch) || GET_LEVEL(ch) >= LVL_GRGOD) ? 25 : 18;
 
-  GET_DEX(ch) = MAX(0, MIN(GET_DEX(ch), i));
-  GET_INT(ch) = MAX(0, MIN(GET_INT(ch), i));
-  GET_WIS(ch) = MAX(0, MIN(GET_WIS(ch), i));
-  GET_CON(ch) = MAX(0, MIN(GET_CON(ch), i));
-  GET_CHA(ch) = MAX(0, MIN(GET_CHA(ch), i));
-  GET_STR(ch) = MAX(0, GET_STR(ch));
+  GET_DEX(ch) = MAX(0, MIN(ch->real_abils.dex + ch->aff_sums.apply[APPLY_DEX], max));
+  GET_INT(ch) = MAX(0, MIN(ch->real_abils.intel + ch->aff_sums.apply[APPLY_INT], max));
+  GET_WIS(ch) = MAX(0, MIN(ch->real_abils.wis + ch->aff_sums.apply[APPLY_WIS], max));
+  GET_CON(ch) = MAX(0, MIN(ch->real_abils.con + ch->aff_sums.apply[APPLY_CON], max));
+  GET_CHA(ch) = MAX(0, MIN(ch->real_abils.cha + ch->aff_sums.apply[APPLY_CHA], max));
+  str = MAX(0, ch->real_abils.str + ch->aff_sums.apply[APPLY_STR]);
 
   if (IS_NPC(ch)) {
-    GET_STR(ch) = MIN(GET_STR(ch), i);
+    str = MIN(str, max);
   } else {
-    if (GET_STR(ch) > 18) {
-      i = GET_ADD(ch) + ((GET_STR(ch) - 18) * 10);
+    if (str > 18) {
+      i = GET_ADD(ch) + ((str - 18) * 10);
       GET_ADD(ch) = MIN(i, 100);
-      GET_STR(ch) = 18;
+      str = 18;
     }
   }
+  GET_STR(ch) = str;
+}
+
+/* Adds up from scratch everything a character is affected by, the way
+ * affect_total() used to on every change, and checks the running totals
+ * against it. Only called when built with AFFECT_DEBUG. */
+void affect_check(struct char_data *ch)
+{
+  struct affect_sum_data sum;
+  struct affected_type *af;
+  struct obj_data *obj;
+  int i, j, k;
+
+  memset(&sum, 0, sizeof(sum));
+
+  for (i = 0; i < NUM_WEARS; i++) {
+    if (!(obj = GET_EQ(ch, i)))
+      continue;
+    for (k = 0; k < AF_ARRAY_MAX * 32; k++)
+      if (IS_SET_AR(GET_OBJ_AFFECT(obj), k))
+        sum.flags[k]++;
+    for (j = 0; j < MAX_OBJ_AFFECT; j++)
+      if (obj->affected[j].location >= 0 && obj->affected[j].location < NUM_APPLIES)
+        sum.apply[(int)obj->affected[j].location] += obj->affected[j].modifier;
+  }
+
+  for (af = ch->affected; af; af = af->next) {
+    for (k = 0; k < AF_ARRAY_MAX * 32; k++)
+      if (IS_SET_AR(af->bitvector, k))
+        sum.flags[k]++;
+    if (af->location >= 0 && af->location < NUM_APPLIES)
+      sum.apply[(int)af->location] += af->modifier;
+  }
+
+  if (memcmp(&sum, &ch->aff_sums, sizeof(sum))) {
+    log("SYSERR: Affect totals for %s are out of step, recounting.", GET_NAME(ch));
+    ch->aff_sums = sum;
+    affect_total(ch);
+  }
 }
 
 /* Insert an affect_type in a char_data structure. Automatically sets
@@ -278,6 +352,9 @@ void affect_to_char(struct char_data *ch, struct affected_type *af)
 
   affect_modify_ar(ch, af->location, af->modifier, af->bitvector, TRUE);
   affect_total(ch);
+#ifdef AFFECT_DEBUG
+  affect_check(ch);
+#endif
 }
 
 /* Remove an affected_type structure from a char (called when duration reaches
@@ -296,6 +373,9 @@ void affect_remove(struct char_data *ch, struct affected_type *af)
   REMOVE_FROM_LIST(af, ch->affected, next);
   free(af);
   affect_total(ch);
+#ifdef AFFECT_DEBUG
+  affect_check(ch);
+#endif
 }
 
 /* Call affect_remove with every affect from the spell "type" */
@@ -371,6 +451,7 @@ void char_from_room(struct char_data *ch)
       if (GET_OBJ_VAL(GET_EQ(ch, WEAR_LIGHT), 2))	/* Light is ON */
 	world[IN_ROOM(ch)].light--;
 
+  trig_types_remove_char(ch, IN_ROOM(ch));
   REMOVE_FROM_LIST(ch, world[IN_ROOM(ch)].people, next_in_room);
   IN_ROOM(ch) = NOWHERE;
   ch->next_in_room = NULL;
@@ -386,6 +467,8 @@ void char_to_room(struct char_data *ch, room_rnum room)
     ch->next_in_room = world[room].people;
     world[room].people = ch;
     IN_ROOM(ch) = room;
+    trig_types_add_char(ch, room);
+    msdp_changed(ch);
 
     autoquest_trigger_check(ch, 0, 0, AQ_ROOM_FIND);
     autoquest_trigger_check(ch, 0, 0, AQ_MOB_FIND);
@@ -413,6 +496,7 @@ void obj_to_char(struct obj_data *object, struct char_data *ch)
     IN_ROOM(object) = NOWHERE;
     IS_CARRYING_W(ch) += GET_OBJ_WEIGHT(object);
     IS_CARRYING_N(ch)++;
+    trig_types_add_obj(object, IN_ROOM(ch));
 
     autoquest_trigger_check(ch, NULL, object, AQ_OBJ_FIND);
 
@@ -432,6 +516,7 @@ void obj_from_char(struct obj_data *object)
     log("SYSERR: NULL object passed to obj_from_char.");
     return;
   }
+  trig_types_remove_obj(object, IN_ROOM(object->carried_by));
   REMOVE_FROM_LIST(object, object->carried_by->carrying, next_content);
 
   /* set flag for crash-save system, but not on mobs! */
@@ -489,8 +574,6 @@ int invalid_align(struct char_data *ch, struct obj_data *obj)
 
 void equip_char(struct char_data *ch, struct obj_data *obj, int pos)
 {
-  int j;
-
   if (pos < 0 || pos >= NUM_WEARS) {
     core_dump();
     return;
@@ -520,6 +603,7 @@ void equip_char(struct char_data *ch, struct obj_data *obj, int pos)
   GET_EQ(ch, pos) = obj;
   obj->worn_by = ch;
   obj->worn_on = pos;
+  trig_types_add_obj(obj, IN_ROOM(ch));
 
   if (GET_OBJ_TYPE(obj) == ITEM_ARMOR)
     GET_AC(ch) -= apply_ac(ch, pos);
@@ -531,17 +615,14 @@ void equip_char(struct char_data *ch, struct obj_data *obj, int pos)
   } else
     log("SYSERR: IN_ROOM(ch) = NOWHERE when equipping char %s.", GET_NAME(ch));
 
-  for (j = 0; j < MAX_OBJ_AFFECT; j++)
-    affect_modify_ar(ch, obj->affected[j].location,
-		  obj->affected[j].modifier,
-		  GET_OBJ_AFFECT(obj), TRUE);
-
-  affect_total(ch);
+  affect_modify_obj(ch, obj, TRUE);
+#ifdef AFFECT_DEBUG
+  affect_check(ch);
+#endif
 }
 
 struct obj_data *unequip_char(struct char_data *ch, int pos)
 {
-  int j;
   struct obj_data *obj;
 
   if ((pos < 0 || pos >= NUM_WEARS) || GET_EQ(ch, pos) == NULL) {
@@ -550,6 +631,7 @@ struct obj_data *unequip_char(struct char_data *ch, int pos)
   }
 
   obj = GET_EQ(ch, pos);
+  trig_types_remove_obj(obj, IN_ROOM(ch));
   obj->worn_by = NULL;
   obj->worn_on = -1;
 
@@ -565,12 +647,10 @@ struct obj_data *unequip_char(struct char_data *ch, int pos)
 
   GET_EQ(ch, pos) = NULL;
 
-  for (j = 0; j < MAX_OBJ_AFFECT; j++)
-    affect_modify_ar(ch, obj->affected[j].location,
-		  obj->affected[j].modifier,
-		  GET_OBJ_AFFECT(obj), FALSE);
-
-  affect_total(ch);
+  affect_modify_obj(ch, obj, FALSE);
+#ifdef AFFECT_DEBUG
+  affect_check(ch);
+#endif
 
   return (obj);
 }
@@ -666,6 +746,7 @@ void obj_to_room(struct obj_data *object, room_rnum room)
     world[room].contents = object;
     IN_ROOM(object) = room;
     object->carried_by = NULL;
+    trig_types_add_obj(object, room);
     if (ROOM_FLAGGED(room, ROOM_HOUSE))
       SET_BIT_AR(ROOM_FLAGS(room), ROOM_HOUSE_CRASH);
   }
@@ -692,6 +773,7 @@ void obj_from_room(struct obj_data *object)
     }
   }
 
+  trig_types_remove_obj(object, IN_ROOM(object));
   REMOVE_FROM_LIST(object, world[IN_ROOM(object)].contents, next_content);
 
   if (ROOM_FLAGGED(IN_ROOM(object), ROOM_HOUSE))
@@ -769,7 +851,6 @@ void object_list_new_owner(struct obj_data *list, struct char_data *ch)
 void extract_obj(struct obj_data *obj)
 {
   struct char_data *ch, *next = NULL;
-  struct obj_data *temp;
 
   if (obj->worn_by != NULL)
     if (unequip_char(obj->worn_by, obj->worn_on) != obj)
@@ -796,7 +877,14 @@ void extract_obj(struct obj_data *obj)
   while (obj->contains)
     extract_obj(obj->contains);
 
-  REMOVE_FROM_LIST(obj, object_list, next);
+  if (obj->prev)
+    obj->prev->next = obj->next;
+  else
+    object_list = obj->next;
+  if (obj->next)
+    obj->next->prev = obj->prev;
+
+  obj_timer_cancel(obj);
 
   if (GET_OBJ_RNUM(obj) != NOTHING)
     (obj_index[GET_OBJ_RNUM(obj)].number)--;
@@ -825,7 +913,7 @@ static void update_object(struct obj_data *obj, int use)
 {
   /* dont update objects with a timer trigger */
   if (!SCRIPT_CHECK(obj, OTRIG_TIMER) && (GET_OBJ_TIMER(obj) > 0))
-    GET_OBJ_TIMER(obj) -= use;
+    set_obj_timer(obj, GET_OBJ_TIMER(obj) - use);
   if (obj->contains)
     update_object(obj->contains, use);
   if (obj->next_content)
@@ -1329,18 +1417,20 @@ int generic_find(char *arg, bitvector_t bitvector, struct char_data *ch,
 		     struct char_data **tar_ch, struct obj_data **tar_obj)
 {
   int i, found, number;
-  char name_val[MAX_INPUT_LENGTH];
-  char *name = name_val;
+  char name[MAX_INPUT_LENGTH];
+  struct arg_list args;
+  struct arg_span *word;
 
   *tar_ch = NULL;
   *tar_obj = NULL;
 
-  one_argument(arg, name);
+  split_args(arg, &args);
 
-  if (!*name)
+  if (!(word = arg_nth(&args, 0)))
     return (0);
-  if (!(number = get_number(&name)))
+  if (!(number = word->number))
     return (0);
+  arg_name_copy(word, name, sizeof(name));
 
   if (IS_SET(bitvector, FIND_CHAR_ROOM)) {	/* Find person in room */
     if ((*tar_ch = get_char_room_vis(ch, name, &number)) != NULL)
@@ -14,6 +14,8 @@
 
 /* handling the affected-structures */
 void	affect_total(struct char_data *ch);
+void	affect_check(struct char_data *ch);
+void	affect_modify_obj(struct char_data *ch, struct obj_data *obj, bool add);
 void	affect_to_char(struct char_data *ch, struct affected_type *af);
 void	affect_remove(struct char_data *ch, struct affected_type *af);
 void	affect_from_char(struct char_data *ch, int type);
@@ -0,0 +1,385 @@
+/**************************************************************************
+*  File: help_index.c                                      Part of tbaMUD *
+*  Usage: Inverted word index over the help entries.                      *
+*                                                                         *
+*  All rights reserved.  See license for complete information.            *
+*                                                                         *
+*  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+**************************************************************************/
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "utils.h"
+#include "db.h"
+#include "help_index.h"
+
+/* Words on the keyword line of an entry count for more than words in its
+ * body. A word's weight in one entry is capped so that long entries which
+ * keep repeating a word do not drown out everything else. */
+#define HELP_KEYWORD_WEIGHT  10
+#define HELP_MAX_WEIGHT      20
+
+/* How a query word matched an index word; also the score multiplier. */
+#define HELP_MATCH_FUZZY     1
+#define HELP_MATCH_PREFIX    2
+#define HELP_MATCH_EXACT     3
+
+/** One entry a word appears in. */
+struct help_posting {
+  int row;     /**< help_table row of the entry (its duplicate == 0 row) */
+  int weight;  /**< How strongly the word belongs to the entry */
+};
+
+/** One distinct word of the index, kept sorted by word. */
+struct help_term {
+  char *word;  /**< Points into help_words */
+  int first;   /**< First of its postings in help_postings[] */
+  int count;   /**< Number of postings */
+};
+
+/** A word occurrence collected while building the index. */
+struct help_token {
+  size_t word; /**< Offset into the build word pool */
+  int row;
+  int weight;
+};
+
+static struct help_term *help_terms = NULL;
+static int num_help_terms = 0;
+static struct help_posting *help_postings = NULL;
+static char *help_words = NULL;
+
+/* Search scratch space, one slot per help_table row, all zero between
+ * searches. */
+static int *help_score = NULL;
+static int *help_matched = NULL;
+static int *help_touched = NULL;
+
+/* Word pool used by help_token_compare() while building. */
+static const char *help_pool = NULL;
+
+static const char *help_stop_words[] = {
+  "a", "an", "and", "are", "as", "at", "be", "by", "can", "for", "from", "if",
+  "in", "is", "it", "of", "on", "or", "see", "that", "the", "this", "to",
+  "will", "with", "you", "your", "\n"
+};
+
+/* local functions */
+static const char *help_next_word(const char *p, char *word, const char **start);
+static bool help_stop_word(const char *word);
+static int help_token_compare(const void *a, const void *b);
+static int help_term_lower_bound(const char *word);
+static int help_word_distance(const char *s1, const char *s2, int limit);
+static void help_score_term(int term, int kind, int query, int level, int *num_touched);
+static int help_count_bits(int bits);
+static int help_result_compare(const void *a, const void *b);
+
+/* Copies the next word at p into word (lowercased, cut to HELP_WORD_LENGTH)
+ * and returns the position just past it, or NULL at the end of the text.
+ * Colour codes are skipped. If start is given it is set to where the word
+ * begins. */
+static const char *help_next_word(const char *p, char *word, const char **start)
+{
+  int len = 0;
+
+  for (;;) {
+    if (!*p)
+      return NULL;
+    if (*p == '\t') {
+      if (*++p == '[')
+        while (*p && *p != ']')
+          p++;
+      if (*p)
+        p++;
+      continue;
+    }
+    if (isalnum((unsigned char) *p))
+      break;
+    p++;
+  }
+
+  if (start)
+    *start = p;
+
+  for (; isalnum((unsigned char) *p); p++)
+    if (len < HELP_WORD_LENGTH)
+      word[len++] = LOWER(*p);
+  word[len] = '\0';
+
+  return p;
+}
+
+static bool help_stop_word(const char *word)
+{
+  int i;
+
+  for (i = 0; *help_stop_words[i] != '\n'; i++)
+    if (!strcmp(word, help_stop_words[i]))
+      return TRUE;
+
+  return FALSE;
+}
+
+static int help_token_compare(const void *a, const void *b)
+{
+  const struct help_token *a1 = (const struct help_token *) a;
+  const struct help_token *b1 = (const struct help_token *) b;
+  int chk;
+
+  if ((chk = strcmp(help_pool + a1->word, help_pool + b1->word)) != 0)
+    return chk;
+
+  return (a1->row - b1->row);
+}
+
+/** Builds the index from help_table. Called by index_boot() once the help
+ * table has been loaded and sorted, which includes every hedit save. */
+void help_index_build(void)
+{
+  struct help_token *tokens = NULL;
+  char word[HELP_WORD_LENGTH + 1], *pool = NULL;
+  const char *p, *start, *keyend;
+  size_t num_tokens = 0, max_tokens = 0, pool_len = 0, pool_max = 0, words_len = 0, len, j;
+  int i, t, n, num_postings = 0;
+  bool new_word;
+
+  help_index_free();
+
+  for (i = 0; i < top_of_helpt; i++) {
+    if (help_table[i].duplicate || !help_table[i].entry)
+      continue;
+
+    /* The first line of an entry holds its keywords. */
+    keyend = strchr(help_table[i].entry, '\n');
+
+    for (p = help_table[i].entry; (p = help_next_word(p, word, &start)) != NULL; ) {
+      if ((!keyend || start > keyend) && (!word[1] || help_stop_word(word)))
+        continue;
+
+      if (num_tokens == max_tokens) {
+        max_tokens = MAX(1024, max_tokens * 2);
+        RECREATE(tokens, struct help_token, max_tokens);
+      }
+      len = strlen(word) + 1;
+      if (pool_len + len > pool_max) {
+        pool_max = MAX(8192, pool_max * 2);
+        RECREATE(pool, char, pool_max);
+      }
+      strcpy(pool + pool_len, word);	/* strcpy: OK (size checked above) */
+
+      tokens[num_tokens].word = pool_len;
+      tokens[num_tokens].row = i;
+      tokens[num_tokens].weight = (keyend && start < keyend) ? HELP_KEYWORD_WEIGHT : 1;
+      num_tokens++;
+      pool_len += len;
+    }
+  }
+
+  if (!num_tokens)
+    return;
+
+  help_pool = pool;
+  qsort(tokens, num_tokens, sizeof(struct help_token), help_token_compare);
+
+  /* Count the distinct words and (word, entry) pairs... */
+  for (j = 0; j < num_tokens; j++) {
+    new_word = (j == 0 || strcmp(pool + tokens[j].word, pool + tokens[j - 1].word));
+    if (new_word) {
+      num_help_terms++;
+      words_len += strlen(pool + tokens[j].word) + 1;
+    }
+    if (new_word || tokens[j].row != tokens[j - 1].row)
+      num_postings++;
+  }
+
+  CREATE(help_terms, struct help_term, num_help_terms);
+  CREATE(help_postings, struct help_posting, num_postings);
+  CREATE(help_words, char, words_len);
+
+  /* ...then fill them in. */
+  for (j = 0, t = -1, n = -1, len = 0; j < num_tokens; j++) {
+    new_word = (j == 0 || strcmp(pool + tokens[j].word, pool + tokens[j - 1].word));
+    if (new_word) {
+      t++;
+      help_terms[t].word = help_words + len;
+      strcpy(help_terms[t].word, pool + tokens[j].word);	/* strcpy: OK (counted above) */
+      len += strlen(help_terms[t].word) + 1;
+      help_terms[t].first = n + 1;
+    }
+    if (new_word || tokens[j].row != tokens[j - 1].row) {
+      n++;
+      help_postings[n].row = tokens[j].row;
+      help_terms[t].count++;
+    }
+    help_postings[n].weight = MIN(HELP_MAX_WEIGHT, help_postings[n].weight + tokens[j].weight);
+  }
+
+  free(tokens);
+  free(pool);
+  help_pool = NULL;
+
+  CREATE(help_score, int, top_of_helpt);
+  CREATE(help_matched, int, top_of_helpt);
+  CREATE(help_touched, int, top_of_helpt);
+
+  log("   %d words, %d references in help index.", num_help_terms, num_postings);
+}
+
+/** Frees the index. Called by free_help_table(). */
+void help_index_free(void)
+{
+  if (help_terms)
+    free(help_terms);
+  if (help_postings)
+    free(help_postings);
+  if (help_words)
+    free(help_words);
+  if (help_score)
+    free(help_score);
+  if (help_matched)
+    free(help_matched);
+  if (help_touched)
+    free(help_touched);
+
+  help_terms = NULL;
+  help_postings = NULL;
+  help_words = NULL;
+  help_score = help_matched = help_touched = NULL;
+  num_help_terms = 0;
+}
+
+/* Index of the first term not less than word. */
+static int help_term_lower_bound(const char *word)
+{
+  int bot = 0, top = num_help_terms, mid;
+
+  while (bot < top) {
+    mid = (bot + top) / 2;
+    if (strcmp(help_terms[mid].word, word) < 0)
+      bot = mid + 1;
+    else
+      top = mid;
+  }
+  return bot;
+}
+
+/* Edit distance between two index words, giving up with limit + 1 as soon
+ * as it cannot come in under limit. */
+static int help_word_distance(const char *s1, const char *s2, int limit)
+{
+  int prev[HELP_WORD_LENGTH + 1], cur[HELP_WORD_LENGTH + 1];
+  int len1 = strlen(s1), len2 = strlen(s2), i, j, best;
+
+  for (j = 0; j <= len2; j++)
+    prev[j] = j;
+
+  for (i = 1; i <= len1; i++) {
+    cur[0] = best = i;
+    for (j = 1; j <= len2; j++) {
+      cur[j] = MIN(prev[j] + 1, MIN(cur[j - 1] + 1,
+                   prev[j - 1] + (s1[i - 1] != s2[j - 1])));
+      best = MIN(best, cur[j]);
+    }
+    if (best > limit)
+      return (limit + 1);
+    memcpy(prev, cur, sizeof(int) * (len2 + 1));
+  }
+
+  return prev[len2];
+}
+
+/* Credits every entry the term appears in to query word number query. */
+static void help_score_term(int term, int kind, int query, int level, int *num_touched)
+{
+  struct help_posting *post;
+  int i;
+
+  for (i = 0; i < help_terms[term].count; i++) {
+    post = help_postings + help_terms[term].first + i;
+    if (help_table[post->row].min_level > level)
+      continue;
+    if (!help_score[post->row])
+      help_touched[(*num_touched)++] = post->row;
+    help_score[post->row] += kind * post->weight;
+    help_matched[post->row] |= (1 << query);
+  }
+}
+
+static int help_count_bits(int bits)
+{
+  int count;
+
+  for (count = 0; bits; bits &= bits - 1)
+    count++;
+
+  return count;
+}
+
+/* Entries matching more of the query words first, then by score. */
+static int help_result_compare(const void *a, const void *b)
+{
+  int r1 = *(const int *) a, r2 = *(const int *) b, chk;
+
+  if ((chk = help_count_bits(help_matched[r2]) - help_count_bits(help_matched[r1])) != 0)
+    return chk;
+  if ((chk = help_score[r2] - help_score[r1]) != 0)
+    return chk;
+
+  return (r1 - r2);
+}
+
+/** Ranks the help entries readable at level against the words in terms.
+ * Each word matches index words exactly, as a prefix, or, when neither
+ * finds anything, within a small edit distance.
+ * @param terms The words to look for.
+ * @param level Level of the reader; entries above it are left out.
+ * @param rows Filled with the help_table rows of the best entries.
+ * @param max_rows Size of rows.
+ * @retval int Number of rows filled in. */
+int help_index_search(const char *terms, int level, int *rows, int max_rows)
+{
+  char query[HELP_MAX_QUERY_WORDS][HELP_WORD_LENGTH + 1], first[2];
+  const char *p = terms;
+  int num_query = 0, num_touched = 0, found, limit, len, i, t;
+
+  if (!help_terms || max_rows < 1)
+    return 0;
+
+  while (num_query < HELP_MAX_QUERY_WORDS && (p = help_next_word(p, query[num_query], NULL)) != NULL)
+    if (!help_stop_word(query[num_query]))
+      num_query++;
+
+  for (i = 0; i < num_query; i++) {
+    len = strlen(query[i]);
+
+    for (found = 0, t = help_term_lower_bound(query[i]);
+         t < num_help_terms && !strncmp(help_terms[t].word, query[i], len); t++, found++)
+      help_score_term(t, help_terms[t].word[len] ? HELP_MATCH_PREFIX : HELP_MATCH_EXACT,
+                      i, level, &num_touched);
+
+    if (found || len < 3)
+      continue;
+
+    /* Nothing starts with it; try the words sharing its first letter. */
+    limit = (len > 5 ? 2 : 1);
+    first[0] = *query[i];
+    first[1] = '\0';
+    for (t = help_term_lower_bound(first); t < num_help_terms && *help_terms[t].word == *first; t++)
+      if (abs((int) strlen(help_terms[t].word) - len) <= limit &&
+          help_word_distance(help_terms[t].word, query[i], limit) <= limit)
+        help_score_term(t, HELP_MATCH_FUZZY, i, level, &num_touched);
+  }
+
+  qsort(help_touched, num_touched, sizeof(int), help_result_compare);
+
+  for (i = 0; i < num_touched; i++) {
+    if (i < max_rows)
+      rows[i] = help_touched[i];
+    help_score[help_touched[i]] = 0;
+    help_matched[help_touched[i]] = 0;
+  }
+
+  return MIN(num_touched, max_rows);
+}
@@ -0,0 +1,27 @@
+/**
+* @file help_index.h
+* Inverted word index over the help entries, used by 'help search' and for
+* the suggestions given when a help lookup fails.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _HELP_INDEX_H_
+#define _HELP_INDEX_H_
+
+/** Number of entries 'help search' shows. */
+#define HELP_SEARCH_RESULTS   10
+/** Longest word that is indexed; longer words are cut. */
+#define HELP_WORD_LENGTH      24
+/** Query words beyond this many are ignored. */
+#define HELP_MAX_QUERY_WORDS  8
+
+void help_index_build(void);
+void help_index_free(void);
+int help_index_search(const char *terms, int level, int *rows, int max_rows);
+
+#endif /* _HELP_INDEX_H_ */
@@ -25,7 +25,6 @@ static struct house_control_rec house_control[MAX_HOUSES];
 static int num_of_houses = 0;
 
 /* local functions */
-static int House_get_filename(room_vnum vnum, char *filename, size_t maxlen);
 static int House_load(room_vnum vnum);
 static void House_restore_weight(struct obj_data *obj);
 static void House_delete_file(room_vnum vnum);
@@ -43,7 +42,7 @@ static struct obj_data *Obj_from_store(struct obj_file_elem object, int *locatio
 
 /* First, the basics: finding the filename; loading/saving objects */
 /* Return a filename given a house vnum */
-static int House_get_filename(room_vnum vnum, char *filename, size_t maxlen)
+int House_get_filename(room_vnum vnum, char *filename, size_t maxlen)
 {
   if (vnum == NOWHERE)
     return (0);
@@ -67,7 +66,7 @@ static int House_load(room_vnum vnum)
   if (!(fl = fopen(filename, "r")))	/* no file found */
     return (0);
 
-	loaded = objsave_parse_objects(fl);
+	loaded = objsave_parse_file(fl);
 
 	for (current = loaded; current != NULL; current = current->next)
     obj_to_room(current->obj, rnum);
@@ -177,7 +176,7 @@ static void House_listrent(struct char_data *ch, room_vnum vnum)
   *buf = '\0';
 	len = snprintf(buf, sizeof(buf), "filename: %s\r\n", filename);
 
-	loaded = objsave_parse_objects(fl);
+	loaded = objsave_parse_file(fl);
 
 	for (current = loaded; current != NULL; current = current->next)
 	  len += snprintf(buf+len, sizeof(buf)-len, " [%5d] (%5dau) %s\r\n",
@@ -193,7 +192,7 @@ static void House_listrent(struct char_data *ch, room_vnum vnum)
 		free(current);
 	}
 
-	page_string(ch->desc,buf,0);
+	page_string(ch->desc,buf,TRUE);
   fclose(fl);
 }
 
@@ -747,7 +746,7 @@ static struct obj_data *Obj_from_store(struct obj_file_elem object, int *locatio
   for(taeller = 0; taeller < EF_ARRAY_MAX; taeller++)
     GET_OBJ_EXTRA(obj)[taeller] = object.extra_flags[taeller];
   GET_OBJ_WEIGHT(obj) = object.weight;
-  GET_OBJ_TIMER(obj) = object.timer;
+  set_obj_timer(obj, object.timer);
   for(taeller = 0; taeller < AF_ARRAY_MAX; taeller++)
     GET_OBJ_AFFECT(obj)[taeller] = object.bitvector[taeller];
 
@@ -43,6 +43,7 @@ struct house_control_rec {
 /* Functions in house.c made externally available */
 /* Utility Functions */
 void	House_boot(void);
+int	House_get_filename(room_vnum vnum, char *filename, size_t maxlen);
 void	House_save_all(void);
 int	House_can_enter(struct char_data *ch, room_vnum house);
 void	House_crashsave(room_vnum vnum);
@@ -484,6 +484,7 @@ void command_interpreter(struct char_data *ch, char *argument)
   char arg[MAX_INPUT_LENGTH];
 
   REMOVE_BIT_AR(AFF_FLAGS(ch), AFF_HIDE);
+  msdp_changed(ch);
 
   /* just drop to next line for hitting CR */
   skip_spaces(&argument);
@@ -690,7 +691,7 @@ static void perform_complex_alias(struct txt_q *input_q, char *orig, struct alia
 
   /* initialize */
   write_point = buf;
-  temp_queue.head = temp_queue.tail = NULL;
+  temp_queue.first = temp_queue.count = temp_queue.peak = 0;
 
   /* now parse the alias */
   for (temp = a->replacement; *temp; temp++) {
@@ -718,12 +719,7 @@ static void perform_complex_alias(struct txt_q *input_q, char *orig, struct alia
   write_to_q(buf, &temp_queue, 1);
 
   /* push our temp_queue on to the _front_ of the input queue */
-  if (input_q->head == NULL)
-    *input_q = temp_queue;
-  else {
-    temp_queue.tail->next = input_q->head;
-    input_q->head = temp_queue.head;
-  }
+  write_to_q_front(input_q, &temp_queue);
 }
 
 /* Given a character and a string, perform alias replacement on it.
@@ -986,6 +982,158 @@ void case_chop(char *string, char *arg1, char *arg2)
   strcpy(arg2, temp);
 }
 
+/* Word spans. split_args() goes over a command line once and notes where
+ * each word starts and ends, whether it is a fill word and the number of any
+ * "n.name" form, instead of copying each word out into a buffer of its own as
+ * one_argument() and friends do. Handlers can then look at the words as often
+ * as they like, and copy out with arg_copy() only those that other code needs
+ * as strings. */
+
+/* Is the len long word at word one of the words in list? */
+static int span_in_list(const char *word, size_t len, const char **list)
+{
+  int i;
+
+  for (i = 0; **(list + i) != '\n'; i++)
+    if (!strn_cmp(word, list[i], len) && !list[i][len])
+      return (i);
+
+  return (-1);
+}
+
+/** Splits line into words, without copying them. Fill words are kept, but
+ * marked; arg_nth() passes over them as one_argument() would. Words past
+ * MAX_ARG_SPANS are left in args->rest.
+ * @param line The command line. It must outlive args.
+ * @param args Where to put the words.
+ * @retval int The number of words found. */
+int split_args(char *line, struct arg_list *args)
+{
+  struct arg_span *a;
+  char *dot, *p;
+
+  args->count = 0;
+
+  for (skip_spaces(&line); *line && args->count < MAX_ARG_SPANS; skip_spaces(&line)) {
+    /* A tab stops skip_spaces(), and ends the words as for any_one_arg(). */
+    if (isspace(*line))
+      break;
+
+    a = &args->arg[args->count++];
+    a->word = line;
+    while (*line && !isspace(*line))
+      line++;
+    a->len = line - a->word;
+    a->fill = (span_in_list(a->word, a->len, fill) >= 0);
+
+    /* As get_number(): "2.sword" is the second sword, "x.sword" is none. */
+    a->name = a->word;
+    a->name_len = a->len;
+    a->number = 1;
+    if ((dot = memchr(a->word, '.', a->len)) != NULL) {
+      a->name = dot + 1;
+      a->name_len = a->len - (a->name - a->word);
+      for (a->number = 0, p = a->word; p < dot; p++) {
+        if (!isdigit(*p)) {
+          a->number = 0;
+          break;
+        }
+        a->number = a->number * 10 + (*p - '0');
+      }
+    }
+  }
+
+  args->rest = line;
+  return (args->count);
+}
+
+/** Returns the nth word of args that is not a fill word, counting from 0, or
+ * NULL if there is none. Word n is what n + 1 calls of one_argument() would
+ * have left in their buffer. */
+struct arg_span *arg_nth(struct arg_list *args, int n)
+{
+  int i;
+
+  for (i = 0; i < args->count; i++)
+    if (!args->arg[i].fill && n-- == 0)
+      return (&args->arg[i]);
+
+  return (NULL);
+}
+
+/** Returns the nth word of args, fill words included, or NULL. */
+struct arg_span *any_arg_nth(struct arg_list *args, int n)
+{
+  return (n >= 0 && n < args->count ? &args->arg[n] : NULL);
+}
+
+/** Returns the rest of the line after a word, with the spaces skipped; what
+ * half_chop() would have copied into its second buffer. */
+char *arg_after(struct arg_span *a)
+{
+  char *rest = a->word + a->len;
+
+  skip_spaces(&rest);
+  return (rest);
+}
+
+/** Is the word word, regardless of case? */
+int arg_is(const struct arg_span *a, const char *word)
+{
+  return (!strn_cmp(a->word, word, a->len) && !word[a->len]);
+}
+
+/** Is the word an abbreviation of word, as is_abbrev()? */
+int arg_is_abbrev(const struct arg_span *a, const char *word)
+{
+  return (a->len && !strn_cmp(a->word, word, a->len));
+}
+
+/** As search_block(), for a word, without lowering its case in the line. */
+int arg_search(const struct arg_span *a, const char **list, int exact)
+{
+  int i;
+
+  if (!a->len || *a->word == '!')
+    return (-1);
+
+  if (exact)
+    return (span_in_list(a->word, a->len, list));
+
+  for (i = 0; **(list + i) != '\n'; i++)
+    if (!strn_cmp(a->word, list[i], a->len))
+      return (i);
+
+  return (-1);
+}
+
+/** Copies a word into buf in lower case, as one_argument() would have, for
+ * code that wants it as a string.
+ * @retval char * buf. */
+char *arg_copy(const struct arg_span *a, char *buf, size_t size)
+{
+  size_t i;
+
+  for (i = 0; i < a->len && i + 1 < size; i++)
+    buf[i] = LOWER(a->word[i]);
+  buf[i] = '\0';
+
+  return (buf);
+}
+
+/** As arg_copy(), for the name after any "n." in front of the word; what
+ * get_number() would have left. */
+char *arg_name_copy(const struct arg_span *a, char *buf, size_t size)
+{
+  size_t i;
+
+  for (i = 0; i < a->name_len && i + 1 < size; i++)
+    buf[i] = LOWER(a->name[i]);
+  buf[i] = '\0';
+
+  return (buf);
+}
+
 /* Used in specprocs, mostly.  (Exactly) matches "command" to cmd number */
 int find_command(const char *command)
 {
@@ -1172,6 +1320,8 @@ static int perform_dupe_check(struct descriptor_data *d)
   REMOVE_BIT_AR(PLR_FLAGS(d->character), PLR_WRITING);
   STATE(d) = CON_PLAYING;
   MXPSendTag( d, "<VERSION>" );
+  msdp_changed(d->character);
+  mssp_players_changed();
 
   switch (mode) {
   case RECON:
@@ -1213,7 +1363,8 @@ static bool perform_new_char_dupe_check(struct descriptor_data *d)
     if (k == d)
       continue;
 
-   if (k->character == NULL)
+    /* Someone still at the name prompt has a character but no name yet. */
+    if (k->character == NULL || GET_NAME(k->character) == NULL)
       continue;
 
     /* Do the player names match? */
@@ -1334,7 +1485,8 @@ EVENTFUNC(get_protocols)
  
   len += snprintf(buf + len, MAX_STRING_LENGTH - len,   "\tO[\toMXP\tO] \tw%s\tn | ", d->pProtocol->bMXP ? "Yes" : "No");
   len += snprintf(buf + len, MAX_STRING_LENGTH - len,   "\tO[\toMSDP\tO] \tw%s\tn | ", d->pProtocol->bMSDP ? "Yes" : "No");
-  len += snprintf(buf + len, MAX_STRING_LENGTH - len,   "\tO[\toATCP\tO] \tw%s\tn\r\n\r\n", d->pProtocol->bATCP ? "Yes" : "No");
+  len += snprintf(buf + len, MAX_STRING_LENGTH - len,   "\tO[\toATCP\tO] \tw%s\tn | ", d->pProtocol->bATCP ? "Yes" : "No");
+  len += snprintf(buf + len, MAX_STRING_LENGTH - len,   "\tO[\toGMCP\tO] \tw%s\tn\r\n\r\n", d->pProtocol->bGMCP ? "Yes" : "No");
    
   write_to_output(d, buf, 0);
     
@@ -1471,7 +1623,7 @@ void nanny(struct descriptor_data *d, char *arg)
 
   case CON_NAME_CNFRM:		/* wait for conf. of new name    */
     if (UPPER(*arg) == 'Y') {
-      if (isbanned(d->host) >= BAN_NEW) {
+      if (isbanned(d->host, d->host_addr) >= BAN_NEW) {
 	mudlog(NRM, LVL_GOD, TRUE, "Request for new char %s denied from [%s] (siteban)", GET_PC_NAME(d->character), d->host);
 	write_to_output(d, "Sorry, new characters are not allowed from your site!\r\n");
 	STATE(d) = CON_CLOSE;
@@ -1532,7 +1684,7 @@ void nanny(struct descriptor_data *d, char *arg)
       GET_BAD_PWS(d->character) = 0;
       d->bad_pws = 0;
 
-      if (isbanned(d->host) == BAN_SELECT &&
+      if (isbanned(d->host, d->host_addr) == BAN_SELECT &&
 	  !PLR_FLAGGED(d->character, PLR_SITEOK)) {
 	write_to_output(d, "Sorry, this char has not been cleared for login from your site!\r\n");
 	STATE(d) = CON_CLOSE;
@@ -1757,6 +1909,8 @@ void nanny(struct descriptor_data *d, char *arg)
 
       STATE(d) = CON_PLAYING;
       MXPSendTag( d, "<VERSION>" );
+      msdp_changed(d->character);
+      mssp_players_changed();
       if (GET_LEVEL(d->character) == 0) {
 	do_start(d->character);
 	send_to_char(d->character, "%s", CONFIG_START_MESSG);
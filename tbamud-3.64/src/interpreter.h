@@ -46,6 +46,37 @@ int enter_player_game (struct descriptor_data *d);
 ACMD(do_alias);
 
 
+/** A word of a command line, pointing into the line rather than copied out
+ * of it. Filled in by split_args(). */
+struct arg_span {
+  char *word;        /**< The word as typed; not terminated. */
+  size_t len;        /**< Length of word. */
+  char *name;        /**< The word after any "n." in front of it. */
+  size_t name_len;   /**< Length of name. */
+  int number;        /**< n of "n.name"; 1 without one, 0 if n is no number. */
+  bool fill;         /**< TRUE for fill words, which arg_nth() passes over. */
+};
+
+/** The most words split_args() splits off a line. */
+#define MAX_ARG_SPANS 16
+
+/** A command line split into words by split_args(). */
+struct arg_list {
+  struct arg_span arg[MAX_ARG_SPANS]; /**< The words, fill words included. */
+  int count;                          /**< How many words there are. */
+  char *rest;                         /**< The line after the last word. */
+};
+
+int split_args(char *line, struct arg_list *args);
+struct arg_span *arg_nth(struct arg_list *args, int n);
+struct arg_span *any_arg_nth(struct arg_list *args, int n);
+char *arg_after(struct arg_span *a);
+int arg_is(const struct arg_span *a, const char *word);
+int arg_is_abbrev(const struct arg_span *a, const char *word);
+int arg_search(const struct arg_span *a, const char **list, int exact);
+char *arg_copy(const struct arg_span *a, char *buf, size_t size);
+char *arg_name_copy(const struct arg_span *a, char *buf, size_t size);
+
 /* for compatibility with 2.20: */
 #define argument_interpreter(a, b, c) two_arguments(a, b, c)
 
@@ -26,6 +26,21 @@
 /* local file scope function prototypes */
 static int graf(int grafage, int p0, int p1, int p2, int p3, int p4, int p5, int p6);
 static void check_idling(struct char_data *ch);
+static struct obj_data **obj_timer_head(struct obj_data *obj);
+static void obj_timer_expire(struct obj_data *j);
+
+/* Object timers. An object with a running timer sits in a hashed timing wheel
+ * slot chosen by the mud hour it runs out on, so point_update() only visits
+ * the slot for the current hour instead of the whole object_list. Timers
+ * longer than the wheel simply stay put for extra laps. */
+#define OBJ_TIMER_WHEEL_SIZE 128
+/* timer_expire of objects pulled off the wheel that are about to run out */
+#define OBJ_TIMER_DUE        (-1)
+
+static struct obj_data *obj_timer_wheel[OBJ_TIMER_WHEEL_SIZE];
+static struct obj_data *obj_timer_due = NULL;
+/* Mud hours ticked by point_update() since boot. */
+static long obj_timer_hour = 0;
 
 
 /* When age < 15 return the value p0
@@ -231,6 +246,7 @@ void gain_exp(struct char_data *ch, int gain)
     GET_EXP(ch) += gain;
     return;
   }
+  msdp_changed(ch);
   if (gain > 0) {
     if ((IS_HAPPYHOUR) && (IS_HAPPYEXP))
       gain += (int)((float)gain * ((float)HAPPY_EXP / (float)(100)));
@@ -277,6 +293,7 @@ void gain_exp_regardless(struct char_data *ch, int gain)
   GET_EXP(ch) += gain;
   if (GET_EXP(ch) < 0)
     GET_EXP(ch) = 0;
+  msdp_changed(ch);
 
   if (!IS_NPC(ch)) {
     while (GET_LEVEL(ch) < LVL_IMPL &&
@@ -378,7 +395,7 @@ static void check_idling(struct char_data *ch)
 void point_update(void)
 {
   struct char_data *i, *next_char;
-  struct obj_data *j, *next_thing, *jj, *next_thing2;
+  struct obj_data *j, *next_thing;
 
   /* characters */
   for (i = character_list; i; i = next_char) {
@@ -392,6 +409,7 @@ void point_update(void)
       GET_HIT(i) = MIN(GET_HIT(i) + hit_gain(i), GET_MAX_HIT(i));
       GET_MANA(i) = MIN(GET_MANA(i) + mana_gain(i), GET_MAX_MANA(i));
       GET_MOVE(i) = MIN(GET_MOVE(i) + move_gain(i), GET_MAX_MOVE(i));
+      msdp_changed(i);
       if (AFF_FLAGGED(i, AFF_POISON))
 	if (damage(i, i, 2, SPELL_POISON) == -1)
 	  continue;	/* Oops, they died. -gg 6/24/98 */
@@ -412,51 +430,25 @@ void point_update(void)
     }
   }
 
-  /* objects */
-  for (j = object_list; j; j = next_thing) {
-    next_thing = j->next;	/* Next in object list */
-
-    /* If this is a corpse */
-    if (IS_CORPSE(j)) {
-      /* timer count down */
-      if (GET_OBJ_TIMER(j) > 0)
-	GET_OBJ_TIMER(j)--;
-
-      if (!GET_OBJ_TIMER(j)) {
-
-	if (j->carried_by)
-	  act("$p decays in your hands.", FALSE, j->carried_by, j, 0, TO_CHAR);
-	else if ((IN_ROOM(j) != NOWHERE) && (world[IN_ROOM(j)].people)) {
-	  act("A quivering horde of maggots consumes $p.",
-	      TRUE, world[IN_ROOM(j)].people, j, 0, TO_ROOM);
-	  act("A quivering horde of maggots consumes $p.",
-	      TRUE, world[IN_ROOM(j)].people, j, 0, TO_CHAR);
-	}
-	for (jj = j->contains; jj; jj = next_thing2) {
-	  next_thing2 = jj->next_content;	/* Next in inventory */
-	  obj_from_obj(jj);
-
-	  if (j->in_obj)
-	    obj_to_obj(jj, j->in_obj);
-	  else if (j->carried_by)
-	    obj_to_room(jj, IN_ROOM(j->carried_by));
-	  else if (IN_ROOM(j) != NOWHERE)
-	    obj_to_room(jj, IN_ROOM(j));
-	  else
-	    core_dump();
-	}
-	extract_obj(j);
-      }
-    }
-    /* If the timer is set, count it down and at 0, try the trigger
-     * note to .rej hand-patchers: make this last in your point-update() */
-    else if (GET_OBJ_TIMER(j)>0) {
-      GET_OBJ_TIMER(j)--;
-      if (!GET_OBJ_TIMER(j))
-        timer_otrigger(j);
-    }
+  /* objects: pull everything running out this hour off its wheel slot first,
+   * since expiring one object may extract others. */
+  obj_timer_hour++;
+  for (j = obj_timer_wheel[obj_timer_hour % OBJ_TIMER_WHEEL_SIZE]; j; j = next_thing) {
+    next_thing = j->next_timer;
+
+    if (j->timer_expire != obj_timer_hour)
+      continue;
+    obj_timer_cancel(j);
+    j->timer_expire = OBJ_TIMER_DUE;
+    j->next_timer = obj_timer_due;
+    if (obj_timer_due)
+      obj_timer_due->prev_timer = j;
+    obj_timer_due = j;
   }
 
+  while (obj_timer_due)
+    obj_timer_expire(obj_timer_due);
+
   /* Take 1 from the happy-hour tick counter, and end happy-hour if zero */
        if (HAPPY_TIME > 1)  HAPPY_TIME--;
   else if (HAPPY_TIME == 1)   /* Last tick - set everything back to zero */
@@ -469,6 +461,116 @@ void point_update(void)
   }
 }
 
+/* Run out the timer of j: corpses rot away, anything else gets its timer
+ * trigger fired. */
+static void obj_timer_expire(struct obj_data *j)
+{
+  struct obj_data *jj, *next_thing2;
+
+  obj_timer_cancel(j);
+  j->obj_flags.timer = 0;
+
+  if (!IS_CORPSE(j)) {
+    timer_otrigger(j);
+    return;
+  }
+
+  if (j->carried_by)
+    act("$p decays in your hands.", FALSE, j->carried_by, j, 0, TO_CHAR);
+  else if ((IN_ROOM(j) != NOWHERE) && (world[IN_ROOM(j)].people)) {
+    act("A quivering horde of maggots consumes $p.",
+        TRUE, world[IN_ROOM(j)].people, j, 0, TO_ROOM);
+    act("A quivering horde of maggots consumes $p.",
+        TRUE, world[IN_ROOM(j)].people, j, 0, TO_CHAR);
+  }
+  for (jj = j->contains; jj; jj = next_thing2) {
+    next_thing2 = jj->next_content;	/* Next in inventory */
+    obj_from_obj(jj);
+
+    if (j->in_obj)
+      obj_to_obj(jj, j->in_obj);
+    else if (j->carried_by)
+      obj_to_room(jj, IN_ROOM(j->carried_by));
+    else if (IN_ROOM(j) != NOWHERE)
+      obj_to_room(jj, IN_ROOM(j));
+    else
+      core_dump();
+  }
+  extract_obj(j);
+}
+
+static struct obj_data **obj_timer_head(struct obj_data *obj)
+{
+  if (obj->timer_expire == OBJ_TIMER_DUE)
+    return &obj_timer_due;
+
+  return &obj_timer_wheel[obj->timer_expire % OBJ_TIMER_WHEEL_SIZE];
+}
+
+/** Hours left before the timer of obj runs out.
+ * @param obj The object.
+ * @retval int Hours left; for an object that is not scheduled this is just
+ * the value stored in obj_flags.timer. */
+int obj_timer_left(struct obj_data *obj)
+{
+  if (obj->timer_expire == OBJ_TIMER_DUE)
+    return 0;
+  if (obj->timer_expire)
+    return (obj->timer_expire - obj_timer_hour);
+
+  return (obj->obj_flags.timer);
+}
+
+/** Sets the timer of a live object and (re)schedules it on the timer wheel.
+ * Corpses are always scheduled and rot on the next tick once their timer is
+ * used up; other objects only run while their timer is positive.
+ * @param obj The object, which must be in object_list.
+ * @param hours New timer, in mud hours. */
+void set_obj_timer(struct obj_data *obj, int hours)
+{
+  struct obj_data **head;
+
+  obj_timer_cancel(obj);
+  obj->obj_flags.timer = hours;
+
+  if (hours < 1) {
+    if (!IS_CORPSE(obj))
+      return;
+    hours = 1;
+  }
+
+  obj->timer_expire = obj_timer_hour + hours;
+  head = obj_timer_head(obj);
+  obj->prev_timer = NULL;
+  obj->next_timer = *head;
+  if (*head)
+    (*head)->prev_timer = obj;
+  *head = obj;
+}
+
+/** Takes obj off the timer wheel, keeping the hours it had left in
+ * obj_flags.timer. Safe to call on objects that are not scheduled.
+ * @param obj The object. */
+void obj_timer_cancel(struct obj_data *obj)
+{
+  struct obj_data **head;
+
+  if (!obj->timer_expire)
+    return;
+
+  head = obj_timer_head(obj);
+  if (obj->prev_timer)
+    obj->prev_timer->next_timer = obj->next_timer;
+  else
+    *head = obj->next_timer;
+  if (obj->next_timer)
+    obj->next_timer->prev_timer = obj->prev_timer;
+
+  obj->obj_flags.timer = obj_timer_left(obj);
+  obj->timer_expire = 0;
+  obj->next_timer = obj->prev_timer = NULL;
+}
+
 /* Note: amt may be negative */
 int increase_gold(struct char_data *ch, int amt)
 {
@@ -485,6 +587,7 @@ int increase_gold(struct char_data *ch, int amt)
     /* Validate to prevent overflow */
     if (GET_GOLD(ch) < curr_gold) GET_GOLD(ch) = MAX_GOLD;
   }
+  msdp_changed(ch);
   if (GET_GOLD(ch) == MAX_GOLD)
     send_to_char(ch, "%sYou have reached the maximum gold!\r\n%sYou must spend it or bank it before you can gain any more.\r\n", QBRED, QNRM);
 
@@ -296,7 +296,8 @@ void medit_save_internally(struct descriptor_data *d)
   struct descriptor_data *dsc;
   struct char_data *mob;
 
-  i = (real_mobile(OLC_NUM(d)) == NOBODY);
+  if (!(i = ((new_rnum = real_mobile(OLC_NUM(d))) == NOBODY)))
+    zone_refs_script_edited(mob_proto[new_rnum].proto_script, OLC_SCRIPT(d));
 
   if ((new_rnum = add_mobile(OLC_MOB(d), OLC_NUM(d))) == NOBODY) {
     log("medit_save_internally: add_mobile failed.");
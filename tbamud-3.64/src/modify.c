@@ -28,8 +28,9 @@
 #include "ibt.h"
 
 /* local (file scope) function prototpyes  */
-static char *next_page(char *str, struct char_data *ch);
-static int count_pages(char *str, struct char_data *ch);
+static void index_lines(struct descriptor_data *d);
+static int page_lines(struct char_data *ch);
+static void page_string_done(struct descriptor_data *d);
 static void playing_string_cleanup(struct descriptor_data *d, int action);
 static void exdesc_string_cleanup(struct descriptor_data *d, int action);
 
@@ -391,75 +392,90 @@ ACMD(do_skillset)
   send_to_char(ch, "You change %s's %s to %d.\r\n", GET_NAME(vict), spell_info[skill].name, value);
 }
 
-/* By Michael Buselli. Traverse down the string until the begining of the next
- * page has been reached.  Return NULL if this is the last page of the string. */
-static char *next_page(char *str, struct char_data *ch)
+/* Based on Michael Buselli's next_page().  Walk the text once, noting where
+ * each line on the player's screen starts, long lines wrapping at their
+ * screen width.  Pages are then just runs of these lines. */
+static void index_lines(struct descriptor_data *d)
 {
-  int col = 1, line = 1, count, pw;
+  const char *str = d->showstr_text;
+  int col = 1, count, pw, size = 64;
 
-  pw = (GET_SCREEN_WIDTH(ch) >= 40 && GET_SCREEN_WIDTH(ch) <= 250) ? GET_SCREEN_WIDTH(ch) : PAGE_WIDTH;
+  pw = (GET_SCREEN_WIDTH(d->character) >= 40 && GET_SCREEN_WIDTH(d->character) <= 250) ? GET_SCREEN_WIDTH(d->character) : PAGE_WIDTH;
 
-  for (;; str++) {
-    /* If end of string, return NULL. */
-    if (*str == '\0')
-      return (NULL);
-
-    /* If we're at the start of the next page, return this fact. */
-    else if (line > (GET_PAGE_LENGTH(ch) - (PRF_FLAGGED(ch, PRF_COMPACT) ? 1 : 2)))
-      return (str);
+  CREATE(d->showstr_lines, int, size);
+  d->showstr_lines[0] = 0;
+  d->showstr_nlines = 1;
 
+  for (; *str; str++) {
     /* Check for the beginning of an ANSI color code block. */
-    else if (*str == '\x1B')  /* Jump to the end of the ANSI code, or max 9 chars */
-      for (count=0; *str != 'm' && count < 9; count++)
+    if (*str == '\x1B') { /* Jump to the end of the ANSI code, or max 9 chars */
+      for (count=0; str[1] && *str != 'm' && count < 9; count++)
         str++;
+      continue;
+    }
 
-    else if (*str == '\t') {
-      if (*(str + 1) != '\t')
+    if (*str == '\t') {
+      if (*(str + 1) != '\t' && *(str + 1))
         str++;
+      continue;
     }
 
-    /* Check for everything else. */
-    else {
-      /* Carriage return puts us in column one. */
-      if (*str == '\r')
-        col = 1;
-      /* Newline puts us on the next line. */
-      else if (*str == '\n')
-        line++;
-
-      /* We need to check here and see if we are over the page width, and if
-       * so, compensate by going to the begining of the next line. */
-      else if (col++ > pw) {
-        col = 1;
-        line++;
-      }
+    /* Carriage return puts us in column one. */
+    if (*str == '\r') {
+      col = 1;
+      continue;
+    }
+
+    /* Newline puts us on the next line.  So does going over the page width:
+     * compensate by going to the begining of the next line. */
+    if (*str != '\n' && col++ <= pw)
+      continue;
+    if (*str != '\n')
+      col = 1;
+
+    /* A line break at the very end does not start another line. */
+    if (!str[1])
+      break;
+    if (d->showstr_nlines == size) {
+      size *= 2;
+      RECREATE(d->showstr_lines, int, size);
     }
+    d->showstr_lines[d->showstr_nlines++] = str + 1 - d->showstr_text;
   }
 }
 
-/* Function that returns the number of pages in the string. */
-static int count_pages(char *str, struct char_data *ch)
+/* Lines of text that fit on one page for this player. */
+static int page_lines(struct char_data *ch)
 {
-  int pages;
-
-  for (pages = 1; (str = next_page(str, ch)); pages++);
-    return (pages);
+  return (MAX(1, GET_PAGE_LENGTH(ch) - (PRF_FLAGGED(ch, PRF_COMPACT) ? 1 : 2)));
 }
 
-/* This function assigns all the pointers for showstr_vector for the
- * page_string function, after showstr_vector has been allocated and
- * showstr_count set. */
-void paginate_string(char *str, struct descriptor_data *d)
+/* Stop paging and let go of the text. */
+static void page_string_done(struct descriptor_data *d)
 {
-  int i;
-
-  if (d->showstr_count)
-    *(d->showstr_vector) = str;
+  if (d->showstr_lines)
+    free(d->showstr_lines);
+  d->showstr_lines = NULL;
+  d->showstr_nlines = 0;
+  d->showstr_count = 0;
+  d->showstr_text = NULL;
+  if (d->showstr_head) {
+    free(d->showstr_head);
+    d->showstr_head = NULL;
+  }
+}
 
-  for (i = 1; i < d->showstr_count && str; i++)
-    str = d->showstr_vector[i] = next_page(str, d->character);
+/* Strings that stay around, like help entries and the text files, are paged
+ * in place rather than copied.  Call this before such a string is freed or
+ * changed: anyone still reading it is given a copy of their own to finish
+ * with. */
+void page_string_release(const char *str)
+{
+  struct descriptor_data *d;
 
-  d->showstr_page = 0;
+  for (d = descriptor_list; d; d = d->next)
+    if (d->showstr_count && d->showstr_text == str && !d->showstr_head)
+      d->showstr_text = d->showstr_head = strdup(str);
 }
 
 /* The call that gets the paging ball rolling... */
@@ -475,85 +491,109 @@ void page_string(struct descriptor_data *d, char *str, int keep_internal)
 
    if ((GET_PAGE_LENGTH(d->character) < 5 || GET_PAGE_LENGTH(d->character) > 254))
     GET_PAGE_LENGTH(d->character) = PAGE_LENGTH;
-  d->showstr_count = count_pages(str, d->character);
-  CREATE(d->showstr_vector, char *, d->showstr_count);
 
-  if (keep_internal) {
-    d->showstr_head = strdup(str);
-    paginate_string(d->showstr_head, d);
-  } else
-    paginate_string(str, d);
+  /* Anything still being paged is dropped for the new text. */
+  page_string_done(d);
+
+  if (keep_internal)
+    d->showstr_text = d->showstr_head = strdup(str);
+  else
+    d->showstr_text = str;
+
+  index_lines(d);
+  d->showstr_top = 0;
+  d->showstr_count = (d->showstr_nlines + page_lines(d->character) - 1) / page_lines(d->character);
+  d->showstr_page = 0;
 
   show_string(d, actbuf);
 }
 
-/* The call that displays the next page. */
+/* The call that displays the next page.  The page goes straight from the
+ * paged text to the player's output, and nothing is scanned but the line
+ * index. */
 void show_string(struct descriptor_data *d, char *input)
 {
-  char buffer[MAX_STRING_LENGTH], buf[MAX_INPUT_LENGTH];
-  int diff;
+  char buf[MAX_INPUT_LENGTH];
+  const char *start, *found;
+  const char *tail = "\r\n";
+  int len = page_lines(d->character), diff, lo, hi, mid;
 
+  skip_spaces(&input);
   any_one_arg(input, buf);
 
   /* Q is for quit. :) */
   if (LOWER(*buf) == 'q') {
-    free(d->showstr_vector);
-    d->showstr_vector = NULL;
-    d->showstr_count = 0;
-    if (d->showstr_head) {
-      free(d->showstr_head);
-      d->showstr_head = NULL;
-    }
+    page_string_done(d);
     return;
   }
-  /* Back up one page internally so we can display it again. */
+  /* Show the page on screen again. */
   else if (LOWER(*buf) == 'r')
-    d->showstr_page = MAX(0, d->showstr_page - 1);
+    ;
 
-  /* Back up two pages internally so we can display the correct page here. */
+  /* Back up one page. */
   else if (LOWER(*buf) == 'b')
-    d->showstr_page = MAX(0, d->showstr_page - 2);
+    d->showstr_top = MAX(0, d->showstr_top - len);
 
   /* Type the number of the page and you are there! */
   else if (isdigit(*buf))
-    d->showstr_page = MAX(0, MIN(atoi(buf) - 1, d->showstr_count - 1));
+    d->showstr_top = MAX(0, MIN(atoi(buf) - 1, d->showstr_count - 1)) * len;
+
+  /* L <number> starts the page at that line. */
+  else if (LOWER(*buf) == 'l' && isdigit(*(input + 1 + strspn(input + 1, " "))))
+    d->showstr_top = MAX(0, MIN(atoi(input + 1) - 1, d->showstr_nlines - 1));
+
+  /* /<text> finds the next line after the top of this page with the text. */
+  else if (*input == '/' && *(input + 1)) {
+    if (d->showstr_top + 1 >= d->showstr_nlines ||
+        !(found = str_str((char *)d->showstr_text + d->showstr_lines[d->showstr_top + 1], input + 1))) {
+      send_to_char(d->character, "Not found.\r\n");
+      return;
+    }
+    /* Find the line the text is on. */
+    for (lo = d->showstr_top + 1, hi = d->showstr_nlines - 1; lo < hi; ) {
+      mid = (lo + hi + 1) / 2;
+      if (d->showstr_lines[mid] <= found - d->showstr_text)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+    d->showstr_top = lo;
+  }
 
+  /* Anything else gets the list of commands; RETURN moves on to the next
+   * page. */
   else if (*buf) {
-    send_to_char(d->character, "Valid commands while paging are RETURN, Q, R, B, or a numeric value.\r\n");
+    send_to_char(d->character, "Valid commands while paging are RETURN, Q, R, B, a page number, L <line number> or /<text to find>.\r\n");
     return;
-  }
+  } else if (d->showstr_page)
+    d->showstr_top += len;
+
+  d->showstr_count = (d->showstr_nlines + len - 1) / len;
+  d->showstr_page = d->showstr_top / len + 1;
+  start = d->showstr_text + d->showstr_lines[d->showstr_top];
+
   /* If we're displaying the last page, just send it to the character, and
-   * then free up the space we used. Also send a \tn - to make color stop
+   * then let go of the text. Also send a \tn - to make color stop
    * bleeding. - Welcor */
-  if (d->showstr_page + 1 >= d->showstr_count) {
-    send_to_char(d->character, "%s\tn", d->showstr_vector[d->showstr_page]);
-    free(d->showstr_vector);
-    d->showstr_vector = NULL;
-    d->showstr_count = 0;
-    if (d->showstr_head) {
-      free(d->showstr_head);
-      d->showstr_head = NULL;
-    }
+  if (d->showstr_top + len >= d->showstr_nlines) {
+    send_to_char(d->character, "%s\tn", start);
+    page_string_done(d);
+    return;
   }
+
   /* Or if we have more to show.... */
-  else {
-    diff = d->showstr_vector[d->showstr_page + 1] - d->showstr_vector[d->showstr_page];
-    if (diff > MAX_STRING_LENGTH - 3) /* 3=\r\n\0 */
-      diff = MAX_STRING_LENGTH - 3;
-    strncpy(buffer, d->showstr_vector[d->showstr_page], diff);	/* strncpy: OK (size truncated above) */
-    /* Fix for prompt overwriting last line in compact mode by Peter Ajamian */
-    if (buffer[diff - 2] == '\r' && buffer[diff - 1]=='\n')
-      buffer[diff] = '\0';
-    else if (buffer[diff - 2] == '\n' && buffer[diff - 1] == '\r')
-      /* This is backwards.  Fix it. */
-      strcpy(buffer + diff - 2, "\r\n");	/* strcpy: OK (size checked) */
-    else if (buffer[diff - 1] == '\r' || buffer[diff - 1] == '\n')
-      /* Just one of \r\n.  Overwrite it. */
-      strcpy(buffer + diff - 1, "\r\n");	/* strcpy: OK (size checked) */
-    else
-      /* Tack \r\n onto the end to fix bug with prompt overwriting last line. */
-      strcpy(buffer + diff, "\r\n");	/* strcpy: OK (size checked) */
-    send_to_char(d->character, "%s", buffer);
-    d->showstr_page++;
-  }
+  diff = d->showstr_lines[d->showstr_top + len] - d->showstr_lines[d->showstr_top];
+  if (diff > MAX_STRING_LENGTH - 3) /* 3=\r\n\0 */
+    diff = MAX_STRING_LENGTH - 3;
+  /* Fix for prompt overwriting last line in compact mode by Peter Ajamian */
+  if (diff >= 2 && start[diff - 2] == '\r' && start[diff - 1]=='\n')
+    tail = "";
+  else if (diff >= 2 && start[diff - 2] == '\n' && start[diff - 1] == '\r')
+    /* This is backwards.  Fix it. */
+    diff -= 2;
+  else if (start[diff - 1] == '\r' || start[diff - 1] == '\n')
+    /* Just one of \r\n.  Overwrite it. */
+    diff -= 1;
+  /* Otherwise tack \r\n onto the end to fix bug with prompt overwriting last line. */
+  send_to_char(d->character, "%.*s%s", diff, start, tail);
 }
@@ -24,7 +24,7 @@ void show_string(struct descriptor_data *d, char *input);
 void smash_tilde(char *str);
 void parse_at(char *str);
 void parse_tab(char *str);
-void paginate_string(char *str, struct descriptor_data *d);
+void page_string_release(const char *str);
 /** @todo should this really be in modify.c? */
 ACMD(do_skillset);
 /* Following function prototypes moved here from comm.h */
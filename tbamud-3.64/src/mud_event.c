@@ -24,7 +24,8 @@ struct mud_event_list mud_event_index[] = {
   { "Null"         , NULL           , -1          },  /* eNULL */
   { "Protocol"     , get_protocols  , EVENT_DESC  },  /* ePROTOCOLS */
   { "Whirlwind"    , event_whirlwind, EVENT_CHAR  },  /* eWHIRLWIND */
-  { "Spell:Darkness",event_countdown, EVENT_ROOM  }   /* eSPL_DARKNESS */
+  { "Spell:Darkness",event_countdown, EVENT_ROOM  },  /* eSPL_DARKNESS */
+  { "Combat Action", event_combat_action, EVENT_CHAR } /* eCOMBAT_ACTION */
 };
 
 /* init_events() is the ideal function for starting global events. This
@@ -183,51 +184,47 @@ void free_mud_event(struct mud_event_data *pMudEvent)
   free(pMudEvent);
 }
 
+/* Walks the item chain directly rather than using simple_list(), so that it
+ * is safe to call from within another simple_list() loop (set_fighting() and
+ * stop_fighting() are reached from the group loop in perform_violence()). */
 struct mud_event_data * char_has_mud_event(struct char_data * ch, event_id iId)
 {
+  struct item_data * pItem;
   struct event * pEvent;
   struct mud_event_data * pMudEvent;
-  bool found = FALSE;
 
   if (ch->events == NULL)
     return NULL;
 
-  if (ch->events->iSize == 0)
-    return NULL;
-
-  clear_simple_list();  
-
-  while ((pEvent = (struct event *) simple_list(ch->events)) != NULL) {
+  for (pItem = ch->events->pFirstItem; pItem; pItem = pItem->pNextItem) {
+    pEvent = (struct event *) pItem->pContent;
     if (!pEvent->isMudEvent)
       continue;
-     pMudEvent = (struct mud_event_data * ) pEvent->event_obj;
-    if (pMudEvent->iId == iId) {
-     found = TRUE;
-     break;
-    }
+    pMudEvent = (struct mud_event_data * ) pEvent->event_obj;
+    if (pMudEvent->iId == iId)
+      return (pMudEvent);
   }
 
-  if (found)
-    return (pMudEvent);
-  
   return NULL;
-} 
+}
 
+/* event_cancel() removes the current item (and frees the list along with the
+ * last one), so grab the next item first. An event whose function is running
+ * right now is not queued; it is left for event_process() to retire. */
 void clear_char_event_list(struct char_data * ch)
 {
+  struct item_data * pItem, * pNextItem;
   struct event * pEvent;
-    
+
   if (ch->events == NULL)
     return;
-    
-  if (ch->events->iSize == 0)
-    return;
-    
-  clear_simple_list();  
 
-  while ((pEvent = (struct event *) simple_list(ch->events)) != NULL) {
-    event_cancel(pEvent);
-  } 
+  for (pItem = ch->events->pFirstItem; pItem; pItem = pNextItem) {
+    pNextItem = pItem->pNextItem;
+    pEvent = (struct event *) pItem->pContent;
+    if (event_is_queued(pEvent))
+      event_cancel(pEvent);
+  }
 }
 
 /* change_event_duration contributed by Ripley */
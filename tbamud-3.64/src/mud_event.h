@@ -27,6 +27,8 @@ typedef enum {
     ePROTOCOLS, /* The Protocol Detection Event */
     eWHIRLWIND, /* The Whirlwind Attack */
     eSPL_DARKNESS, /* Darkness Spell */
+    eCOMBAT_ACTION, /* Mobile combat behaviour */
+    NUM_MUD_EVENTS  /* Keep last; the number of entries in mud_event_index[] */
 } event_id;
 
 struct mud_event_list {
@@ -57,5 +59,6 @@ void clear_char_event_list(struct char_data * ch);
 EVENTFUNC(event_countdown);
 EVENTFUNC(get_protocols);
 EVENTFUNC(event_whirlwind);
+EVENTFUNC(event_combat_action);
 
 #endif /* _MUD_EVENT_H_ */
@@ -23,6 +23,7 @@
 #include "improved-edit.h"
 #include "constants.h"
 #include "dg_scripts.h"
+#include "asciimap.h"
 
 /* Local, filescope function prototypes */
 /* Utility function for buildwalk */
@@ -285,6 +286,9 @@ ACMD(do_dig)
     W_EXIT(rrnum, rev_dir[dir])->to_room = IN_ROOM(ch);
     add_to_save_list(zone_table[world[rrnum].zone].number, SL_WLD);
   }
+
+  map_room_changed(IN_ROOM(ch));
+  map_room_changed(rrnum);
 }
 
 /* BuildWalk - OasisOLC Extension by D. Tyler Barnes. */
@@ -22,6 +22,7 @@
 #include "config.h"
 #include "modify.h"
 #include "genolc.h" /* for strip_cr and sprintascii */
+#include "house.h"
 
 /* these factors should be unique integers */
 #define RENT_FACTOR    1
@@ -30,6 +31,15 @@
 #define LOC_INVENTORY  0
 #define MAX_BAG_ROWS   5
 
+/* How many rent files the boot-time sweep checks each pulse. */
+#define RENT_SWEEP_FILES 10
+
+/* Initial buffer size when reading object records into memory. */
+#define RENT_READ_CHUNK  16384
+
+/* local file scope variables */
+static int rent_sweep_next = -1;   /* next player_table entry; -1 when idle */
+
 /* local functions */
 static int Crash_save(struct obj_data *obj, FILE *fp, int location);
 static void Crash_extract_norent_eq(struct char_data *ch);
@@ -48,6 +58,7 @@ static void Crash_calculate_rent(struct obj_data *obj, int *cost);
 static void Crash_cryosave(struct char_data *ch, int cost);
 static int Crash_load_objs(struct char_data *ch);
 static int handle_obj(struct obj_data *obj, struct char_data *ch, int locate, struct obj_data **cont_rows);
+static int Crash_benchmark_file(const char *filename, bool rent_header, long *bytes, long *usecs);
 static int objsave_write_rentcode(FILE *fl, int rentcode, int cost_per_day, struct char_data *ch);
 
 /* Writes one object record to FILE.  Old name: Obj_to_store() */
@@ -386,13 +397,41 @@ int Crash_clean_file(char *name)
   return FALSE;
 }
 
+/* Rather than opening every rent file at boot, update_obj_file() only starts
+ * a sweep that Crash_sweep_rent_files() carries on a few files at a time from
+ * the heartbeat. Anyone who logs in or is looked up with Crash_listrent() before
+ * the sweep reaches them has their own file checked first. If nobody is
+ * connected, the game loop carries on with the sweep, a batch at a time, until
+ * it is done or someone connects. */
 void update_obj_file(void)
 {
-  int i;
+  rent_sweep_next = 0;
+}
 
-  for (i = 0; i <= top_of_p_table; i++)
-    if (*player_table[i].name)
-      Crash_clean_file(player_table[i].name);
+/* TRUE if the sweep has yet to reach this player's file. */
+static bool Crash_sweep_pending(const char *name)
+{
+  return (rent_sweep_next >= 0 && get_ptable_by_name(name) >= rent_sweep_next);
+}
+
+/* Returns TRUE while there are still files left to check. */
+bool Crash_sweep_rent_files(void)
+{
+  int n;
+
+  if (rent_sweep_next < 0)
+    return FALSE;
+
+  for (n = 0; n < RENT_SWEEP_FILES && rent_sweep_next <= top_of_p_table; n++, rent_sweep_next++)
+    if (*player_table[rent_sweep_next].name)
+      Crash_clean_file(player_table[rent_sweep_next].name);
+
+  if (rent_sweep_next > top_of_p_table) {
+    rent_sweep_next = -1;
+    log("Done checking crash and rent files.");
+    return FALSE;
+  }
+  return TRUE;
 }
 
 void Crash_listrent(struct char_data *ch, char *name)
@@ -405,6 +444,9 @@ void Crash_listrent(struct char_data *ch, char *name)
   if (!get_filename(filename, sizeof(filename), CRASH_FILE, name))
     return;
 
+  if (Crash_sweep_pending(name))
+    Crash_clean_file(name);
+
   if (!(fl = fopen(filename, "r"))) {
     send_to_char(ch, "%s has no rent file.\r\n", name);
     return;
@@ -442,7 +484,7 @@ void Crash_listrent(struct char_data *ch, char *name)
     break;
   }
 
-	loaded = objsave_parse_objects(fl);
+	loaded = objsave_parse_file(fl);
 
 	for (current = loaded; current != NULL; current=current->next)
 	  len += snprintf(buf+len, sizeof(buf)-len, "[%5d] (%5dau) %-20s\r\n",
@@ -458,7 +500,7 @@ void Crash_listrent(struct char_data *ch, char *name)
 		free(current);
 	}
 
-  page_string(ch->desc,buf,0);
+  page_string(ch->desc,buf,TRUE);
   fclose(fl);
 }
 
@@ -468,6 +510,9 @@ void Crash_listrent(struct char_data *ch, char *name)
  *  2 - rented equipment lost (no $) */
 int Crash_load(struct char_data *ch)
 {
+  if (Crash_sweep_pending(GET_NAME(ch)))
+    Crash_clean_file(GET_NAME(ch));
+
   return (Crash_load_objs(ch));
 }
 
@@ -993,207 +1038,328 @@ void Crash_save_all(void)
   }
 }
 
-/* Parses the object records stored in fl, and returns the first object in a
- * linked list, which also handles location if worn. This list can then be
- * handled by house code, listrent code, autoeq code, etc. */
-obj_save_data *objsave_parse_objects(FILE *fl)
+/* Rent and house files are read into memory and parsed in place: a line is
+ * cut off where it ends, tags are matched on their four characters and the
+ * numbers are converted directly, rather than copying every line through
+ * get_line(), tag_argument() and sscanf(). */
+
+/* Returns the next line of text and moves *pos past it, or NULL at the end.
+ * The line ending is cut off in place. */
+static char *rent_next_line(char **pos)
 {
-  obj_save_data *head, *current, *tempsave;
-  char f1[128], f2[128], f3[128], f4[128], line[READ_SIZE];
-  int t[4],i, nr;
-  struct obj_data *temp;
+  char *line = *pos, *end;
 
-  CREATE(current, obj_save_data, 1);
-  head = current;
-  current->locate = 0;
+  if (!*line)
+    return NULL;
 
-  temp = NULL;
-  while (TRUE) {
-    char tag[6];
-    int num;
+  if ((end = strchr(line, '\n')) != NULL)
+    *pos = end + 1;
+  else
+    *pos = end = line + strlen(line);
 
-    /* if the file is done, wrap it all up */
-    if(get_line(fl, line) == FALSE || (*line == '$' && line[1] == '~')) {
-      if (temp == NULL && current->obj == NULL) {
-        /* Remove current from list. */
-        tempsave = head;
-        if (tempsave == current) {
-          free(current);
-          head = NULL;
-        } else {
-          while (tempsave) {
-            if (tempsave->next == current)
-              tempsave->next = NULL;
-            tempsave = tempsave->next;
-          }
-          free(current);
-        }
-      }
-    else if (temp != NULL && current->obj == NULL)
-      current->obj = temp;
-    else if (temp == NULL && current->obj != NULL) {
-      /* Do nothing. */
-  } else if (temp != NULL && current->obj != NULL) {
-      if (temp != current->obj)
-        log("inconsistent object pointers in objsave_parse_objects: %p/%p", temp, current->obj);
-    }
+  while (end > line && end[-1] == '\r')
+    end--;
+  *end = '\0';
 
-    break;
+  return line;
+}
+
+/* Reads a number from *pos and moves past it. Missing numbers read as 0. */
+static long rent_number(char **pos)
+{
+  char *p = *pos;
+  long num = 0;
+  bool neg = FALSE;
+
+  while (*p == ' ' || *p == '\t')
+    p++;
+  if (*p == '-') {
+    neg = TRUE;
+    p++;
   }
+  while (*p >= '0' && *p <= '9')
+    num = num * 10 + (*p++ - '0');
+
+  *pos = p;
+  return (neg ? -num : num);
+}
+
+/* Reads a flag word from *pos, numeric or letters as asciiflag_conv() takes
+ * them, and moves past it. */
+static bitvector_t rent_flags(char **pos)
+{
+  char *p = *pos, *word;
+
+  while (*p == ' ' || *p == '\t')
+    p++;
+  if ((*p >= '0' && *p <= '9') || *p == '-') {
+    *pos = p;
+    return ((bitvector_t) rent_number(pos));
+  }
+
+  for (word = p; *p && *p != ' ' && *p != '\t'; p++)
+    ;
+  if (*p)
+    *p++ = '\0';
+  *pos = p;
+
+  return (asciiflag_conv(word));
+}
+
+/* The in-memory counterpart of fread_string(). A string that runs past the
+ * end of the text or is too long is logged and cut short, instead of taking
+ * the game down over one damaged rent file. */
+static char *rent_string(char **pos, const char *error)
+{
+  char buf[MAX_STRING_LENGTH], *line;
+  size_t len = 0, n;
+  bool done = FALSE, warned = FALSE;
+
+  *buf = '\0';
+  while (!done) {
+    if ((line = rent_next_line(pos)) == NULL) {
+      log("SYSERR: rent_string: format error at or near %s", error);
+      break;
+    }
+    n = strlen(line);
+    if (n > 0 && line[n - 1] == '~') {
+      line[--n] = '\0';
+      done = TRUE;
+    }
+    if (len + n + 3 > sizeof(buf)) {
+      if (!warned)
+        log("SYSERR: rent_string: string too large at or near %s", error);
+      warned = TRUE;
+      continue;
+    }
+    memcpy(buf + len, line, n);
+    len += n;
+    if (!done) {
+      buf[len++] = '\r';
+      buf[len++] = '\n';
+    }
+    buf[len] = '\0';
+  }
+
+  parse_at(buf);
+  return (*buf ? strdup(buf) : NULL);
+}
+
+/* Parses the object records in text up to its end or a "$~" line. text is
+ * modified as it is parsed. Consecutive records of one vnum, such as a stack
+ * of potions, are looked up once and loaded with read_object() by rnum. */
+static obj_save_data *objsave_parse_text(char *text)
+{
+  obj_save_data *head = NULL, **tail = &head, *current = NULL;
+  struct obj_data *temp = NULL;
+  obj_vnum last_vnum = NOTHING;
+  obj_rnum rnum = NOTHING;
+  char *pos = text, *line, *arg, error[40];
+  int i, nr;
+
+  while ((line = rent_next_line(&pos)) != NULL) {
+    /* Blank lines and '*' comments are skipped, as get_line() did. */
+    if (!*line || *line == '*')
+      continue;
+
+    /* if the file is done, wrap it all up */
+    if (*line == '$' && line[1] == '~')
+      break;
 
     /* if it's a new record, wrap up the old one, and make space for a new one */
     if (*line == '#') {
       /* check for false alarm. */
-      if (sscanf(line, "#%d", &nr) == 1) {
-        /* If we attempt to load an object with a legal VNUM 0-65534, that
-         * does not exist, skip it. If the object has a VNUM of NOTHING or
-         * 65535, then we assume it doesn't exist on purpose. (Custom Item,
-         * Coins, Corpse, etc...) */
-        if (real_object(nr) == NOTHING && nr != NOTHING) {
-            log("SYSERR: Prevented loading of non-existant item #%d.", nr);
-            continue;
-          }
-          
-        if (temp) {
-          current->obj = temp;
-          CREATE(current->next, obj_save_data, 1);
-          current=current->next;
-
-          current->locate = 0;
-          temp = NULL;
-        }
-      } else
+      arg = line + 1;
+      if (!((*arg >= '0' && *arg <= '9') || *arg == '-'))
         continue;
-        
-      /* we have the number, check it, load obj. */
+      nr = rent_number(&arg);
+
+      temp = NULL;
       if (nr == NOTHING) {   /* then it is unique */
         temp = create_obj();
-        temp->item_number=NOTHING;
+        temp->item_number = NOTHING;
       } else if (nr < 0) {
         continue;
       } else {
-        if(real_object(nr) != NOTHING) {
-          temp=read_object(nr,VIRTUAL);
-	/* Go read next line - nothing more to see here. */
-        } else {
-          log("Nonexistent object %d found in rent file.", nr);
+        if (nr != last_vnum) {
+          last_vnum = nr;
+          rnum = real_object(nr);
+        }
+        /* If we attempt to load an object with a legal VNUM 0-65534, that
+         * does not exist, skip it and everything recorded for it. If the
+         * object has a VNUM of NOTHING or 65535, then we assume it doesn't
+         * exist on purpose. (Custom Item, Coins, Corpse, etc...) */
+        if (rnum == NOTHING) {
+          log("SYSERR: Prevented loading of non-existant item #%d.", nr);
+          continue;
         }
+        temp = read_object(rnum, REAL);
       }
+
+      CREATE(current, obj_save_data, 1);
+      current->obj = temp;
+      *tail = current;
+      tail = &current->next;
       /* go read next line - nothing more to see here. */
       continue;
     }
 
     /* If "temp" is NULL, we are most likely progressing through
-     * a non-existant object, so just keep continuing till we find 
+     * a non-existant object, so just keep continuing till we find
      * the next object */
     if (temp == NULL)
       continue;
 
-    tag_argument(line, tag);
-    num = atoi(line);
+    /* The tag is the first four characters, followed by ':' and spaces. */
+    for (arg = line, i = 0; i < 4 && *arg; i++)
+      arg++;
+    while (*arg == ':' || *arg == ' ')
+      arg++;
 
-    switch(*tag) {
+    switch (*line) {
     case 'A':
-      if (!strcmp(tag, "ADes")) {
-        char error[40];
+      if (!strncmp(line, "ADes", 4)) {
         snprintf(error, sizeof(error)-1, "rent(Ades):%s", temp->name);
-        temp->action_description = fread_string(fl, error);
-      } else if (!strcmp(tag, "Aff ")) {
-        sscanf(line, "%d %d %d", &t[0], &t[1], &t[2]);
-        if (t[0] < MAX_OBJ_AFFECT) {
-          temp->affected[t[0]].location = t[1];
-          temp->affected[t[0]].modifier = t[2];
+        temp->action_description = rent_string(&pos, error);
+      } else if (!strncmp(line, "Aff ", 4)) {
+        i = rent_number(&arg);
+        if (i >= 0 && i < MAX_OBJ_AFFECT) {
+          temp->affected[i].location = rent_number(&arg);
+          temp->affected[i].modifier = rent_number(&arg);
         }
       }
       break;
     case 'C':
-      if (!strcmp(tag, "Cost"))
-        GET_OBJ_COST(temp) = num;
+      if (!strncmp(line, "Cost", 4))
+        GET_OBJ_COST(temp) = rent_number(&arg);
       break;
     case 'D':
-      if (!strcmp(tag, "Desc"))
-        temp->description = strdup(line);
+      if (!strncmp(line, "Desc", 4))
+        temp->description = strdup(arg);
       break;
     case 'E':
-      if(!strcmp(tag, "EDes")) {
+      if (!strncmp(line, "EDes", 4)) {
         struct extra_descr_data *new_desc;
-        char error[40];
         snprintf(error, sizeof(error)-1, "rent(Edes): %s", temp->name);
         if (temp->item_number != NOTHING && /* Regular object */
             temp->ex_description &&   /* with ex_desc == prototype */
-            (temp->ex_description == obj_proto[real_object(temp->item_number)].ex_description))
+            (temp->ex_description == obj_proto[GET_OBJ_RNUM(temp)].ex_description))
           temp->ex_description = NULL;
         CREATE(new_desc, struct extra_descr_data, 1);
-        new_desc->keyword = fread_string(fl, error);
-        new_desc->description = fread_string(fl, error);
+        new_desc->keyword = rent_string(&pos, error);
+        new_desc->description = rent_string(&pos, error);
         new_desc->next = temp->ex_description;
         temp->ex_description = new_desc;
       }
       break;
     case 'F':
-      if (!strcmp(tag, "Flag")) {
-        sscanf(line, "%s %s %s %s", f1, f2, f3, f4);
-        GET_OBJ_EXTRA(temp)[0] = asciiflag_conv(f1);
-        GET_OBJ_EXTRA(temp)[1] = asciiflag_conv(f2);
-        GET_OBJ_EXTRA(temp)[2] = asciiflag_conv(f3);
-        GET_OBJ_EXTRA(temp)[3] = asciiflag_conv(f4);
-      }
+      if (!strncmp(line, "Flag", 4))
+        for (i = 0; i < EF_ARRAY_MAX; i++)
+          GET_OBJ_EXTRA(temp)[i] = rent_flags(&arg);
       break;
     case 'L':
-      if(!strcmp(tag, "Loc "))
-        current->locate = num;
+      if (!strncmp(line, "Loc ", 4))
+        current->locate = rent_number(&arg);
       break;
     case 'N':
-      if (!strcmp(tag, "Name"))
-        temp->name = strdup(line);
+      if (!strncmp(line, "Name", 4))
+        temp->name = strdup(arg);
       break;
     case 'P':
-      if (!strcmp(tag, "Perm")) {
-        sscanf(line, "%s %s %s %s", f1, f2, f3, f4);
-        GET_OBJ_PERM(temp)[0] = asciiflag_conv(f1);
-        GET_OBJ_PERM(temp)[1] = asciiflag_conv(f2);
-        GET_OBJ_PERM(temp)[2] = asciiflag_conv(f3);
-        GET_OBJ_PERM(temp)[3] = asciiflag_conv(f4);
-      }
+      if (!strncmp(line, "Perm", 4))
+        for (i = 0; i < AF_ARRAY_MAX; i++)
+          GET_OBJ_PERM(temp)[i] = rent_flags(&arg);
       break;
     case 'R':
-      if (!strcmp(tag, "Rent"))
-        GET_OBJ_RENT(temp) = num;
+      if (!strncmp(line, "Rent", 4))
+        GET_OBJ_RENT(temp) = rent_number(&arg);
       break;
     case 'S':
-      if (!strcmp(tag, "Shrt"))
-        temp->short_description = strdup(line);
+      if (!strncmp(line, "Shrt", 4))
+        temp->short_description = strdup(arg);
       break;
     case 'T':
-      if (!strcmp(tag, "Type"))
-        GET_OBJ_TYPE(temp) = num;
+      if (!strncmp(line, "Type", 4))
+        GET_OBJ_TYPE(temp) = rent_number(&arg);
       break;
     case 'W':
-      if (!strcmp(tag, "Wear")) {
-        sscanf(line, "%s %s %s %s", f1, f2, f3, f4);
-        GET_OBJ_WEAR(temp)[0] = asciiflag_conv(f1);
-        GET_OBJ_WEAR(temp)[1] = asciiflag_conv(f2);
-        GET_OBJ_WEAR(temp)[2] = asciiflag_conv(f3);
-        GET_OBJ_WEAR(temp)[3] = asciiflag_conv(f4);
-      }
-      else if (!strcmp(tag, "Wght"))
-        GET_OBJ_WEIGHT(temp) = num;
+      if (!strncmp(line, "Wear", 4))
+        for (i = 0; i < TW_ARRAY_MAX; i++)
+          GET_OBJ_WEAR(temp)[i] = rent_flags(&arg);
+      else if (!strncmp(line, "Wght", 4))
+        GET_OBJ_WEIGHT(temp) = rent_number(&arg);
       break;
     case 'V':
-      if (!strcmp(tag, "Vals")) {
-        sscanf(line, "%d %d %d %d", &t[0], &t[1], &t[2], &t[3]);
+      if (!strncmp(line, "Vals", 4))
         for (i = 0; i < NUM_OBJ_VAL_POSITIONS; i++)
-          GET_OBJ_VAL(temp, i) = t[i];
-      }
+          GET_OBJ_VAL(temp, i) = rent_number(&arg);
       break;
     default:
-      log("Unknown tag in rentfile: %s", tag);
+      log("Unknown tag in rentfile: %.4s", line);
     }
   }
 
   return head;
 }
 
+/* Parses the object records stored in fl, and returns the first object in a
+ * linked list, which also handles location if worn. This list can then be
+ * handled by house code, listrent code, autoeq code, etc. Only the records up
+ * to and including the "$~" line are read, so that fl is left at whatever
+ * follows them. */
+obj_save_data *objsave_parse_objects(FILE *fl)
+{
+  obj_save_data *head;
+  char *text;
+  size_t size = RENT_READ_CHUNK, len = 0, start;
+
+  CREATE(text, char, size);
+  for (;;) {
+    /* Gather one whole line, however long. */
+    start = len;
+    do {
+      if (size - len < READ_SIZE) {
+        size *= 2;
+        RECREATE(text, char, size);
+      }
+      if (!fgets(text + len, size - len, fl))
+        break;
+      len += strlen(text + len);
+    } while (len > start && text[len - 1] != '\n');
+    text[len] = '\0';
+
+    if (len == start || (text[start] == '$' && text[start + 1] == '~'))
+      break;
+  }
+
+  head = objsave_parse_text(text);
+  free(text);
+  return head;
+}
+
+/* As objsave_parse_objects(), for callers that own the whole of fl: the rest
+ * of the file is read with as few reads as its size allows. */
+obj_save_data *objsave_parse_file(FILE *fl)
+{
+  obj_save_data *head;
+  char *text;
+  size_t size = RENT_READ_CHUNK, len = 0, n;
+
+  CREATE(text, char, size + 1);
+  while ((n = fread(text + len, 1, size - len, fl)) > 0) {
+    len += n;
+    if (len == size) {
+      size *= 2;
+      RECREATE(text, char, size + 1);
+    }
+  }
+  text[len] = '\0';
+
+  head = objsave_parse_text(text);
+  free(text);
+  return head;
+}
+
 static int Crash_load_objs(struct char_data *ch) {
   FILE *fl;
   char filename[MAX_STRING_LENGTH];
@@ -1268,7 +1434,7 @@ static int Crash_load_objs(struct char_data *ch) {
     break;
   }
 
-	loaded = objsave_parse_objects(fl);
+	loaded = objsave_parse_file(fl);
 	for (current = loaded; current != NULL; current=current->next)
 	  num_objs += handle_obj(current->obj, ch, current->locate, cont_row);
 
@@ -1387,3 +1553,77 @@ static int handle_obj(struct obj_data *temp, struct char_data *ch, int locate, s
   return TRUE;
 }
 
+
+/* Opens filename and parses its object records as a login or House_boot()
+ * would, adding the time taken to *usecs. Returns the number of objects. */
+static int Crash_benchmark_file(const char *filename, bool rent_header, long *bytes, long *usecs)
+{
+  FILE *fl;
+  char line[READ_SIZE];
+  struct timeval start, end;
+  obj_save_data *loaded, *current;
+  int num = 0;
+
+  gettimeofday(&start, (struct timezone *) 0);
+  if (!(fl = fopen(filename, "r")))
+    return (-1);
+  if (!rent_header || get_line(fl, line))
+    loaded = objsave_parse_file(fl);
+  else
+    loaded = NULL;
+  *bytes += ftell(fl);
+  fclose(fl);
+  gettimeofday(&end, (struct timezone *) 0);
+  *usecs += (end.tv_sec - start.tv_sec) * 1000000L + (end.tv_usec - start.tv_usec);
+
+  while (loaded != NULL) {
+    current = loaded;
+    loaded = loaded->next;
+    extract_obj(current->obj);
+    free(current);
+    num++;
+  }
+  return (num);
+}
+
+/* Loads every player's rent file and every house file passes times and logs
+ * the time taken, for the -b command line option. Run it against a library
+ * holding the files to be measured; the world must already be booted. Each
+ * object is extracted again once its file has been timed. */
+void Crash_benchmark(int passes)
+{
+  char filename[MAX_STRING_LENGTH];
+  long bytes = 0, usecs = 0;
+  int pass, i, n, files = 0, objs = 0;
+  room_rnum r;
+
+  build_player_index();
+  log("Rent benchmark: %d pass%s over %d players and %d rooms.", passes,
+      passes == 1 ? "" : "es", top_of_p_table + 1, top_of_world + 1);
+
+  for (pass = 0; pass < passes; pass++) {
+    for (i = 0; i <= top_of_p_table; i++) {
+      if (!*player_table[i].name ||
+          !get_filename(filename, sizeof(filename), CRASH_FILE, player_table[i].name))
+        continue;
+      if ((n = Crash_benchmark_file(filename, TRUE, &bytes, &usecs)) < 0)
+        continue;
+      files++;
+      objs += n;
+    }
+    for (r = 0; r <= top_of_world; r++) {
+      if (!House_get_filename(GET_ROOM_VNUM(r), filename, sizeof(filename)))
+        continue;
+      if ((n = Crash_benchmark_file(filename, FALSE, &bytes, &usecs)) < 0)
+        continue;
+      files++;
+      objs += n;
+    }
+  }
+
+  log("Rent benchmark: %d files, %d objects, %ld bytes in %ld.%03ld ms (%ld ms per pass, %ld ns per object).",
+      files, objs, bytes, usecs / 1000, usecs % 1000, usecs / 1000 / MAX(passes, 1),
+      objs ? (long) (usecs * 1000.0 / objs) : 0L);
+
+  free_player_index();
+}
@@ -256,7 +256,8 @@ void oedit_save_internally(struct descriptor_data *d)
   struct descriptor_data *dsc;
   struct obj_data *obj;
 
-  i = (real_object(OLC_NUM(d)) == NOTHING);
+  if (!(i = ((robj_num = real_object(OLC_NUM(d))) == NOTHING)))
+    zone_refs_script_edited(obj_proto[robj_num].proto_script, OLC_SCRIPT(d));
 
   if ((robj_num = add_object(OLC_OBJ(d), OLC_NUM(d))) == NOTHING) {
     log("oedit_save_internally: add_object failed.");
@@ -960,7 +961,7 @@ void oedit_parse(struct descriptor_data *d, char *arg)
     break;
 
   case OEDIT_TIMER:
-    GET_OBJ_TIMER(OLC_OBJ(d)) = LIMIT(atoi(arg), 0, MAX_OBJ_TIMER);
+    OLC_OBJ(d)->obj_flags.timer = LIMIT(atoi(arg), 0, MAX_OBJ_TIMER);
     break;
 
   case OEDIT_LEVEL:
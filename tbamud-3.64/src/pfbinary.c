@@ -0,0 +1,581 @@
+/**************************************************************************
+*  File: pfbinary.c                                        Part of tbaMUD *
+*  Usage: Reading and writing binary player files.                        *
+*                                                                         *
+*  All rights reserved.  See license for complete information.            *
+*                                                                         *
+*  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+**************************************************************************/
+
+/* This file is also linked into the plrtobin and rebuildIndex utilities, so it
+ * must not use anything from the rest of the game: no log(), no CREATE(). */
+
+#include "conf.h"
+#include "sysdep.h"
+#include "structs.h"
+#include "pfdefaults.h"
+#include "pfbinary.h"
+
+#define PFB_NULL_STRING  0xFFFFFFFFUL
+
+/** The payload being written. */
+struct pfb_buf {
+  unsigned char *data;
+  size_t len;
+  size_t size;
+};
+
+/** The payload being read. Once an entry runs past the end, bad is set and
+ * every further read returns zero, so the decoder only checks at the end. */
+struct pfb_cursor {
+  const unsigned char *pos;
+  const unsigned char *end;
+  int bad;
+};
+
+static void *pfb_realloc(void *ptr, size_t size)
+{
+  if (!(ptr = realloc(ptr, size))) {
+    perror("SYSERR: pfbinary realloc failure");
+    abort();
+  }
+  return ptr;
+}
+
+static char *pfb_strdup(const char *str)
+{
+  size_t len;
+
+  if (!str)
+    return NULL;
+  len = strlen(str) + 1;
+  return memcpy(pfb_realloc(NULL, len), str, len);
+}
+
+/* Make room for one more entry in one of the image's lists. */
+static void *pfb_grow(void *list, int *max, int num, size_t size)
+{
+  if (num < *max)
+    return list;
+  *max = *max ? *max * 2 : 8;
+  return pfb_realloc(list, *max * size);
+}
+
+static unsigned long pfb_adler32(const unsigned char *data, size_t len)
+{
+  unsigned long a = 1, b = 0;
+  size_t n;
+
+  /* 5552 is the most bytes that can be summed before b can overflow 32 bits. */
+  while (len > 0) {
+    n = len < 5552 ? len : 5552;
+    len -= n;
+    while (n--) {
+      a += *data++;
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+  }
+  return (b << 16) | a;
+}
+
+static void put_bytes(struct pfb_buf *buf, const void *src, size_t n)
+{
+  if (buf->len + n > buf->size) {
+    buf->size = buf->size * 2 > buf->len + n ? buf->size * 2 : buf->len + n;
+    buf->data = pfb_realloc(buf->data, buf->size);
+  }
+  memcpy(buf->data + buf->len, src, n);
+  buf->len += n;
+}
+
+static void put_u32(struct pfb_buf *buf, unsigned long v)
+{
+  unsigned char b[4];
+
+  b[0] = v & 0xFF;
+  b[1] = (v >> 8) & 0xFF;
+  b[2] = (v >> 16) & 0xFF;
+  b[3] = (v >> 24) & 0xFF;
+  put_bytes(buf, b, 4);
+}
+
+static void put_int(struct pfb_buf *buf, int v)
+{
+  put_u32(buf, (unsigned long)(unsigned int)v);
+}
+
+static void put_i64(struct pfb_buf *buf, long long v)
+{
+  unsigned long long u = (unsigned long long)v;
+
+  put_u32(buf, (unsigned long)(u & 0xFFFFFFFFUL));
+  put_u32(buf, (unsigned long)(u >> 32));
+}
+
+static void put_str(struct pfb_buf *buf, const char *str)
+{
+  size_t len;
+
+  if (!str) {
+    put_u32(buf, PFB_NULL_STRING);
+    return;
+  }
+  len = strlen(str);
+  put_u32(buf, len);
+  put_bytes(buf, str, len);
+}
+
+static unsigned long get_u32(struct pfb_cursor *cur)
+{
+  const unsigned char *b = cur->pos;
+
+  if (cur->bad || cur->end - cur->pos < 4) {
+    cur->bad = 1;
+    return 0;
+  }
+  cur->pos += 4;
+  return (unsigned long)b[0] | ((unsigned long)b[1] << 8) |
+         ((unsigned long)b[2] << 16) | ((unsigned long)b[3] << 24);
+}
+
+static int get_int(struct pfb_cursor *cur)
+{
+  unsigned long v = get_u32(cur);
+
+  return v & 0x80000000UL ? -(int)(0xFFFFFFFFUL - v) - 1 : (int)v;
+}
+
+static long long get_i64(struct pfb_cursor *cur)
+{
+  unsigned long long u = get_u32(cur);
+
+  u |= (unsigned long long)get_u32(cur) << 32;
+  return (long long)u;
+}
+
+static char *get_str(struct pfb_cursor *cur)
+{
+  unsigned long len = get_u32(cur);
+  char *str;
+
+  if (cur->bad || len == PFB_NULL_STRING)
+    return NULL;
+  if (len > (unsigned long)(cur->end - cur->pos)) {
+    cur->bad = 1;
+    return NULL;
+  }
+  str = pfb_realloc(NULL, len + 1);
+  memcpy(str, cur->pos, len);
+  str[len] = '\0';
+  cur->pos += len;
+  return str;
+}
+
+/* Read a list count, refusing any that could not fit in what is left of the
+ * payload so that a damaged count cannot make us allocate a huge list. */
+static int get_count(struct pfb_cursor *cur, size_t min_entry)
+{
+  unsigned long count = get_u32(cur);
+
+  if (count > (unsigned long)(cur->end - cur->pos) / min_entry) {
+    cur->bad = 1;
+    return 0;
+  }
+  return (int)count;
+}
+
+void pfb_init_image(struct pfile_image *img)
+{
+  int i;
+
+  memset(img, 0, sizeof(*img));
+
+  img->field[PFB_SEX] = PFDEF_SEX;
+  img->field[PFB_CLASS] = PFDEF_CLASS;
+  img->field[PFB_RACE] = PFDEF_RACE;
+  img->field[PFB_SUBRACE] = PFDEF_SUBRACE;
+  img->field[PFB_LEVEL] = PFDEF_LEVEL;
+  img->field[PFB_LAST_MOTD] = PFDEF_LASTMOTD;
+  img->field[PFB_LAST_NEWS] = PFDEF_LASTNEWS;
+  img->field[PFB_HEIGHT] = PFDEF_HEIGHT;
+  img->field[PFB_WEIGHT] = PFDEF_WEIGHT;
+  img->field[PFB_ALIGNMENT] = PFDEF_ALIGNMENT;
+  for (i = 0; i < PFB_FLAG_WORDS; i++) {
+    img->field[PFB_PLR_FLAGS + i] = PFDEF_PLRFLAGS;
+    img->field[PFB_AFF_FLAGS + i] = PFDEF_AFFFLAGS;
+    img->field[PFB_PRF_FLAGS + i] = PFDEF_PREFFLAGS;
+  }
+  for (i = 0; i < PFB_NUM_SAVES; i++)
+    img->field[PFB_SAVE + i] = PFDEF_SAVETHROW;
+  img->field[PFB_WIMP_LEV] = PFDEF_WIMPLEV;
+  img->field[PFB_FREEZE_LEV] = PFDEF_FREEZELEV;
+  img->field[PFB_INVIS_LEV] = PFDEF_INVISLEV;
+  img->field[PFB_LOADROOM] = PFDEF_LOADROOM;
+  img->field[PFB_BAD_PWS] = PFDEF_BADPWS;
+  img->field[PFB_PRACTICES] = PFDEF_PRACTICES;
+  img->field[PFB_HUNGER] = PFDEF_HUNGER;
+  img->field[PFB_THIRST] = PFDEF_THIRST;
+  img->field[PFB_DRUNK] = PFDEF_DRUNK;
+  img->field[PFB_HIT] = PFDEF_HIT;
+  img->field[PFB_MAX_HIT] = PFDEF_MAXHIT;
+  img->field[PFB_MANA] = PFDEF_MANA;
+  img->field[PFB_MAX_MANA] = PFDEF_MAXMANA;
+  img->field[PFB_MOVE] = PFDEF_MOVE;
+  img->field[PFB_MAX_MOVE] = PFDEF_MAXMOVE;
+  img->field[PFB_STR] = PFDEF_STR;
+  img->field[PFB_STR_ADD] = PFDEF_STRADD;
+  img->field[PFB_INT] = PFDEF_INT;
+  img->field[PFB_WIS] = PFDEF_WIS;
+  img->field[PFB_DEX] = PFDEF_DEX;
+  img->field[PFB_CON] = PFDEF_CON;
+  img->field[PFB_CHA] = PFDEF_CHA;
+  img->field[PFB_AC] = PFDEF_AC;
+  img->field[PFB_GOLD] = PFDEF_GOLD;
+  img->field[PFB_BANK_GOLD] = PFDEF_BANK;
+  img->field[PFB_EXP] = PFDEF_EXP;
+  img->field[PFB_HITROLL] = PFDEF_HITROLL;
+  img->field[PFB_DAMROLL] = PFDEF_DAMROLL;
+  img->field[PFB_OLC_ZONE] = PFDEF_OLC;
+  img->field[PFB_PAGE_LENGTH] = PFDEF_PAGELENGTH;
+  img->field[PFB_SCREEN_WIDTH] = PFDEF_SCREENWIDTH;
+  img->field[PFB_QUESTPOINTS] = PFDEF_QUESTPOINTS;
+  img->field[PFB_QUEST_COUNTER] = PFDEF_QUESTCOUNT;
+  img->field[PFB_CURR_QUEST] = PFDEF_CURRQUEST;
+}
+
+void pfb_free_image(struct pfile_image *img)
+{
+  int i;
+
+  for (i = 0; i < NUM_PFB_STRINGS; i++)
+    if (img->str[i])
+      free(img->str[i]);
+  for (i = 0; i < img->num_aliases; i++) {
+    free(img->aliases[i].alias);
+    free(img->aliases[i].replacement);
+  }
+  for (i = 0; i < img->num_vars; i++) {
+    free(img->vars[i].name);
+    free(img->vars[i].value);
+  }
+  if (img->skills)
+    free(img->skills);
+  if (img->affects)
+    free(img->affects);
+  if (img->quests)
+    free(img->quests);
+  if (img->triggers)
+    free(img->triggers);
+  if (img->aliases)
+    free(img->aliases);
+  if (img->vars)
+    free(img->vars);
+  pfb_init_image(img);
+}
+
+void pfb_set_string(struct pfile_image *img, int which, const char *str)
+{
+  if (img->str[which])
+    free(img->str[which]);
+  img->str[which] = pfb_strdup(str);
+}
+
+void pfb_add_skill(struct pfile_image *img, int num, int level)
+{
+  img->skills = pfb_grow(img->skills, &img->max_skills, img->num_skills, sizeof(struct pfb_skill));
+  img->skills[img->num_skills].num = num;
+  img->skills[img->num_skills++].level = level;
+}
+
+void pfb_add_affect(struct pfile_image *img, const struct pfb_affect *af)
+{
+  img->affects = pfb_grow(img->affects, &img->max_affects, img->num_affects, sizeof(struct pfb_affect));
+  img->affects[img->num_affects++] = *af;
+}
+
+void pfb_add_quest(struct pfile_image *img, int vnum)
+{
+  img->quests = pfb_grow(img->quests, &img->max_quests, img->num_quests, sizeof(int));
+  img->quests[img->num_quests++] = vnum;
+}
+
+void pfb_add_trigger(struct pfile_image *img, int vnum)
+{
+  img->triggers = pfb_grow(img->triggers, &img->max_triggers, img->num_triggers, sizeof(int));
+  img->triggers[img->num_triggers++] = vnum;
+}
+
+void pfb_add_alias(struct pfile_image *img, const char *alias, const char *replacement, int type)
+{
+  struct pfb_alias *a;
+
+  img->aliases = pfb_grow(img->aliases, &img->max_aliases, img->num_aliases, sizeof(struct pfb_alias));
+  a = &img->aliases[img->num_aliases++];
+  a->alias = pfb_strdup(alias);
+  a->replacement = pfb_strdup(replacement);
+  a->type = type;
+}
+
+void pfb_add_var(struct pfile_image *img, const char *name, long context, const char *value)
+{
+  struct pfb_var *v;
+
+  img->vars = pfb_grow(img->vars, &img->max_vars, img->num_vars, sizeof(struct pfb_var));
+  v = &img->vars[img->num_vars++];
+  v->name = pfb_strdup(name);
+  v->context = context;
+  v->value = pfb_strdup(value);
+}
+
+static void encode_image(struct pfb_buf *buf, const struct pfile_image *img)
+{
+  int i, j;
+
+  put_u32(buf, NUM_PFB_FIELDS);
+  for (i = 0; i < NUM_PFB_FIELDS; i++)
+    put_i64(buf, img->field[i]);
+
+  put_u32(buf, NUM_PFB_STRINGS);
+  for (i = 0; i < NUM_PFB_STRINGS; i++)
+    put_str(buf, img->str[i]);
+
+  put_u32(buf, img->num_skills);
+  for (i = 0; i < img->num_skills; i++) {
+    put_int(buf, img->skills[i].num);
+    put_int(buf, img->skills[i].level);
+  }
+
+  put_u32(buf, img->num_affects);
+  for (i = 0; i < img->num_affects; i++) {
+    put_int(buf, img->affects[i].spell);
+    put_int(buf, img->affects[i].duration);
+    put_int(buf, img->affects[i].modifier);
+    put_int(buf, img->affects[i].location);
+    for (j = 0; j < PFB_FLAG_WORDS; j++)
+      put_int(buf, img->affects[i].bitvector[j]);
+  }
+
+  put_u32(buf, img->num_quests);
+  for (i = 0; i < img->num_quests; i++)
+    put_int(buf, img->quests[i]);
+
+  put_u32(buf, img->num_triggers);
+  for (i = 0; i < img->num_triggers; i++)
+    put_int(buf, img->triggers[i]);
+
+  put_u32(buf, img->num_aliases);
+  for (i = 0; i < img->num_aliases; i++) {
+    put_str(buf, img->aliases[i].alias);
+    put_str(buf, img->aliases[i].replacement);
+    put_int(buf, img->aliases[i].type);
+  }
+
+  put_u32(buf, img->num_vars);
+  for (i = 0; i < img->num_vars; i++) {
+    put_str(buf, img->vars[i].name);
+    put_i64(buf, img->vars[i].context);
+    put_str(buf, img->vars[i].value);
+  }
+}
+
+/* Returns FALSE if the payload ran out or a count was impossible. */
+static int decode_image(struct pfb_cursor *cur, struct pfile_image *img)
+{
+  struct pfb_affect af;
+  long long v;
+  char *s, *s2;
+  int i, j, n, num;
+
+  n = get_count(cur, 8);
+  for (i = 0; i < n; i++) {
+    v = get_i64(cur);
+    if (i < NUM_PFB_FIELDS)
+      img->field[i] = v;
+  }
+
+  n = get_count(cur, 4);
+  for (i = 0; i < n; i++) {
+    s = get_str(cur);
+    if (i < NUM_PFB_STRINGS)
+      img->str[i] = s;
+    else if (s)
+      free(s);
+  }
+
+  n = get_count(cur, 8);
+  for (i = 0; i < n; i++) {
+    num = get_int(cur);
+    pfb_add_skill(img, num, get_int(cur));
+  }
+
+  n = get_count(cur, 32);
+  for (i = 0; i < n; i++) {
+    af.spell = get_int(cur);
+    af.duration = get_int(cur);
+    af.modifier = get_int(cur);
+    af.location = get_int(cur);
+    for (j = 0; j < PFB_FLAG_WORDS; j++)
+      af.bitvector[j] = get_int(cur);
+    pfb_add_affect(img, &af);
+  }
+
+  n = get_count(cur, 4);
+  for (i = 0; i < n; i++)
+    pfb_add_quest(img, get_int(cur));
+
+  n = get_count(cur, 4);
+  for (i = 0; i < n; i++)
+    pfb_add_trigger(img, get_int(cur));
+
+  n = get_count(cur, 12);
+  for (i = 0; i < n && !cur->bad; i++) {
+    s = get_str(cur);
+    s2 = get_str(cur);
+    if (s && s2)
+      pfb_add_alias(img, s, s2, get_int(cur));
+    else
+      get_int(cur);
+    if (s)
+      free(s);
+    if (s2)
+      free(s2);
+  }
+
+  n = get_count(cur, 16);
+  for (i = 0; i < n && !cur->bad; i++) {
+    s = get_str(cur);
+    v = get_i64(cur);
+    s2 = get_str(cur);
+    if (s && s2)
+      pfb_add_var(img, s, (long)v, s2);
+    if (s)
+      free(s);
+    if (s2)
+      free(s2);
+  }
+
+  return !cur->bad;
+}
+
+/* The file is written beside the old one and renamed over it, so a crash
+ * part way through leaves the previous save intact rather than a file that
+ * fails its checksum. */
+int pfb_write(const char *filename, const struct pfile_image *img)
+{
+  struct pfb_buf buf;
+  char tmpname[PATH_MAX];
+  unsigned long sum;
+  size_t total;
+  FILE *fl;
+  int ok;
+
+  buf.data = NULL;
+  buf.len = buf.size = 0;
+
+  /* The header goes first; its length and checksum are filled in below. */
+  put_bytes(&buf, PFB_MAGIC, 4);
+  put_u32(&buf, PFB_VERSION);
+  put_u32(&buf, 0);
+  put_u32(&buf, 0);
+  encode_image(&buf, img);
+
+  total = buf.len;
+  sum = pfb_adler32(buf.data + PFB_HEADER_SIZE, total - PFB_HEADER_SIZE);
+  buf.len = 8;
+  put_u32(&buf, total - PFB_HEADER_SIZE);
+  put_u32(&buf, sum);
+  buf.len = total;
+
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+  if (!(fl = fopen(tmpname, "wb"))) {
+    free(buf.data);
+    return PFB_ERR_IO;
+  }
+  ok = fwrite(buf.data, 1, buf.len, fl) == buf.len;
+  ok = (fclose(fl) == 0) && ok;
+  free(buf.data);
+
+  if (!ok || rename(tmpname, filename)) {
+    remove(tmpname);
+    return PFB_ERR_IO;
+  }
+  return PFB_OK;
+}
+
+/* Reads and checks a whole binary player file into img, which need not be
+ * initialized. On failure img is left empty, with the defaults. */
+int pfb_read(const char *filename, struct pfile_image *img)
+{
+  unsigned char header[PFB_HEADER_SIZE], *payload;
+  struct pfb_cursor cur;
+  unsigned long version, len, sum;
+  FILE *fl;
+
+  pfb_init_image(img);
+
+  if (!(fl = fopen(filename, "rb")))
+    return errno == ENOENT ? PFB_ERR_NOFILE : PFB_ERR_IO;
+
+  if (fread(header, 1, PFB_HEADER_SIZE, fl) != PFB_HEADER_SIZE ||
+      memcmp(header, PFB_MAGIC, 4)) {
+    fclose(fl);
+    return PFB_ERR_MAGIC;
+  }
+
+  cur.pos = header + 4;
+  cur.end = header + PFB_HEADER_SIZE;
+  cur.bad = 0;
+  version = get_u32(&cur);
+  len = get_u32(&cur);
+  sum = get_u32(&cur);
+
+  if (version > PFB_VERSION) {
+    fclose(fl);
+    return PFB_ERR_VERSION;
+  }
+  if (len > PFB_MAX_PAYLOAD) {
+    fclose(fl);
+    return PFB_ERR_CORRUPT;
+  }
+
+  payload = pfb_realloc(NULL, len ? len : 1);
+  if (fread(payload, 1, len, fl) != len) {
+    fclose(fl);
+    free(payload);
+    return PFB_ERR_CORRUPT;
+  }
+  fclose(fl);
+
+  if (pfb_adler32(payload, len) != sum) {
+    free(payload);
+    return PFB_ERR_CHECKSUM;
+  }
+
+  cur.pos = payload;
+  cur.end = payload + len;
+  cur.bad = 0;
+  if (!decode_image(&cur, img)) {
+    free(payload);
+    pfb_free_image(img);
+    return PFB_ERR_CORRUPT;
+  }
+  free(payload);
+  return PFB_OK;
+}
+
+const char *pfb_strerror(int err)
+{
+  switch (err) {
+  case PFB_OK:           return "no error";
+  case PFB_ERR_NOFILE:   return "no such file";
+  case PFB_ERR_IO:       return strerror(errno);
+  case PFB_ERR_MAGIC:    return "not a binary player file";
+  case PFB_ERR_VERSION:  return "written by a newer version";
+  case PFB_ERR_CHECKSUM: return "checksum mismatch";
+  case PFB_ERR_CORRUPT:  return "truncated or corrupt";
+  default:               return "unknown error";
+  }
+}
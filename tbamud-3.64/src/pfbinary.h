@@ -0,0 +1,130 @@
+/**
+* @file pfbinary.h
+* Binary player file format. A player file image is written as one checksummed
+* block and read back with two reads, instead of a line per field as the ASCII
+* player files are. Shared by the game and the plrtobin utility.
+*
+* Part of the core tbaMUD source code distribution, which is a derivative
+* of, and continuation of, CircleMUD.
+*
+* All rights reserved.  See license for complete information.
+* Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University
+* CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.
+*/
+#ifndef _PFBINARY_H_
+#define _PFBINARY_H_
+
+/* A binary player file is a 16 byte header followed by the payload:
+ *
+ *   "TBPF"  version  payload length  Adler-32 of the payload
+ *
+ * All numbers are little endian. The payload holds the fixed fields as a
+ * count followed by that many 64 bit values, the strings as a count followed
+ * by length prefixed strings (length 0xFFFFFFFF for a NULL string), and then
+ * the skill, affect, quest, trigger, alias and variable lists, each a count
+ * followed by its entries. Fields and strings are only ever added at the end
+ * of their enums; a file with fewer of them loads with the defaults for the
+ * rest, so adding one does not need a new version. */
+#define PFB_MAGIC        "TBPF"
+#define PFB_VERSION      1
+#define PFB_HEADER_SIZE  16
+/** Largest payload accepted, so a damaged header cannot ask for gigabytes. */
+#define PFB_MAX_PAYLOAD  (4 * 1024 * 1024)
+/** Words saved for each of the player, affect and preference flag arrays. */
+#define PFB_FLAG_WORDS   4
+/** Saving throws saved. */
+#define PFB_NUM_SAVES    5
+
+/* Results of pfb_read() and pfb_write(). */
+#define PFB_OK            0
+#define PFB_ERR_NOFILE    1  /**< The file does not exist */
+#define PFB_ERR_IO        2  /**< Read, write or rename failed */
+#define PFB_ERR_MAGIC     3  /**< Not a binary player file */
+#define PFB_ERR_VERSION   4  /**< Written by a newer version */
+#define PFB_ERR_CHECKSUM  5  /**< Payload does not match its checksum */
+#define PFB_ERR_CORRUPT   6  /**< Payload is truncated or malformed */
+
+/** The fixed fields, in file order. Append only. */
+enum pfb_field {
+  PFB_SEX, PFB_CLASS, PFB_RACE, PFB_SUBRACE, PFB_LEVEL,
+  PFB_IDNUM, PFB_BIRTH, PFB_PLAYED, PFB_LOGON, PFB_LAST_MOTD, PFB_LAST_NEWS,
+  PFB_HEIGHT, PFB_WEIGHT, PFB_ALIGNMENT,
+  PFB_PLR_FLAGS, PFB_PLR_FLAGS_1, PFB_PLR_FLAGS_2, PFB_PLR_FLAGS_3,
+  PFB_AFF_FLAGS, PFB_AFF_FLAGS_1, PFB_AFF_FLAGS_2, PFB_AFF_FLAGS_3,
+  PFB_PRF_FLAGS, PFB_PRF_FLAGS_1, PFB_PRF_FLAGS_2, PFB_PRF_FLAGS_3,
+  PFB_SAVE, PFB_SAVE_1, PFB_SAVE_2, PFB_SAVE_3, PFB_SAVE_4,
+  PFB_WIMP_LEV, PFB_FREEZE_LEV, PFB_INVIS_LEV, PFB_LOADROOM,
+  PFB_BAD_PWS, PFB_PRACTICES, PFB_HUNGER, PFB_THIRST, PFB_DRUNK,
+  PFB_HIT, PFB_MAX_HIT, PFB_MANA, PFB_MAX_MANA, PFB_MOVE, PFB_MAX_MOVE,
+  PFB_STR, PFB_STR_ADD, PFB_INT, PFB_WIS, PFB_DEX, PFB_CON, PFB_CHA,
+  PFB_AC, PFB_GOLD, PFB_BANK_GOLD, PFB_EXP, PFB_HITROLL, PFB_DAMROLL,
+  PFB_OLC_ZONE, PFB_PAGE_LENGTH, PFB_SCREEN_WIDTH,
+  PFB_QUESTPOINTS, PFB_QUEST_COUNTER, PFB_CURR_QUEST,
+  NUM_PFB_FIELDS
+};
+
+/** The strings, in file order. Append only. */
+enum pfb_string {
+  PFB_NAME, PFB_PASSWD, PFB_TITLE, PFB_DESC, PFB_POOFIN, PFB_POOFOUT, PFB_HOST,
+  NUM_PFB_STRINGS
+};
+
+struct pfb_skill {
+  int num;
+  int level;
+};
+
+struct pfb_affect {
+  int spell;
+  int duration;
+  int modifier;
+  int location;
+  int bitvector[PFB_FLAG_WORDS];
+};
+
+struct pfb_alias {
+  char *alias;
+  char *replacement; /**< As kept in memory, with its leading space */
+  int type;
+};
+
+struct pfb_var {
+  char *name;
+  long context;
+  char *value;
+};
+
+/** Everything a player file holds, independent of struct char_data so that
+ * the utilities can use it without the rest of the game. */
+struct pfile_image {
+  long long field[NUM_PFB_FIELDS];
+  char *str[NUM_PFB_STRINGS];
+
+  struct pfb_skill *skills;
+  int num_skills, max_skills;
+  struct pfb_affect *affects;
+  int num_affects, max_affects;
+  int *quests;
+  int num_quests, max_quests;
+  int *triggers;
+  int num_triggers, max_triggers;
+  struct pfb_alias *aliases;
+  int num_aliases, max_aliases;
+  struct pfb_var *vars;
+  int num_vars, max_vars;
+};
+
+void pfb_init_image(struct pfile_image *img);
+void pfb_free_image(struct pfile_image *img);
+void pfb_set_string(struct pfile_image *img, int which, const char *str);
+void pfb_add_skill(struct pfile_image *img, int num, int level);
+void pfb_add_affect(struct pfile_image *img, const struct pfb_affect *af);
+void pfb_add_quest(struct pfile_image *img, int vnum);
+void pfb_add_trigger(struct pfile_image *img, int vnum);
+void pfb_add_alias(struct pfile_image *img, const char *alias, const char *replacement, int type);
+void pfb_add_var(struct pfile_image *img, const char *name, long context, const char *value);
+int pfb_write(const char *filename, const struct pfile_image *img);
+int pfb_read(const char *filename, struct pfile_image *img);
+const char *pfb_strerror(int err);
+
+#endif /* _PFBINARY_H_ */
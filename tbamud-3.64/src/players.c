@@ -22,6 +22,7 @@
 #include "config.h" /* for pclean_criteria[] */
 #include "dg_scripts.h" /* To enable saving of player variables to disk */
 #include "quest.h"
+#include "pfbinary.h"
 
 #define LOAD_HIT	0
 #define LOAD_MANA	1
@@ -52,6 +53,10 @@ static void load_quests(FILE *fl, struct char_data *ch);
 static void load_HMVS(struct char_data *ch, const char *line, int mode);
 static void write_aliases_ascii(FILE *file, struct char_data *ch);
 static void read_aliases_ascii(FILE *file, struct char_data *ch, int count);
+static bool read_pfile_binary(const char *name, struct pfile_image *img);
+static void load_char_binary(struct char_data *ch, struct pfile_image *img);
+static bool write_pfile_binary(const char *filename, struct char_data *ch, struct affected_type *tmp_aff);
+static void write_pfile_ascii(FILE *fl, struct char_data *ch, struct affected_type *tmp_aff);
 
 /* New version to build player index for ASCII Player Files. Generate index
  * table for the player file. */
@@ -239,7 +244,9 @@ char *get_name_by_id(long id)
 int load_char(const char *name, struct char_data *ch)
 {
   int id, i;
-  FILE *fl;
+  FILE *fl = NULL;
+  struct pfile_image img;
+  bool binary;
   char filename[40];
   char buf[128], buf2[128], line[MAX_INPUT_LENGTH + 1], tag[6];
   char f1[128], f2[128], f3[128], f4[128];
@@ -249,11 +256,14 @@ int load_char(const char *name, struct char_data *ch)
   if ((id = get_ptable_by_name(name)) < 0)
     return (-1);
   else {
-    if (!get_filename(filename, sizeof(filename), PLR_FILE, player_table[id].name))
-      return (-1);
-    if (!(fl = fopen(filename, "r"))) {
-      mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Couldn't open player file %s", filename);
-      return (-1);
+    /* A binary player file is preferred; the ASCII one is the fallback. */
+    if (!(binary = read_pfile_binary(player_table[id].name, &img))) {
+      if (!get_filename(filename, sizeof(filename), PLR_FILE, player_table[id].name))
+        return (-1);
+      if (!(fl = fopen(filename, "r"))) {
+        mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Couldn't open player file %s", filename);
+        return (-1);
+      }
     }
 
     /* Character initializations. Necessary to keep some things straight. */
@@ -318,7 +328,10 @@ int load_char(const char *name, struct char_data *ch)
     for (i = 0; i < PR_ARRAY_MAX; i++)
       PRF_FLAGS(ch)[i] = PFDEF_PREFFLAGS;
 
-    while (get_line(fl, line)) {
+    if (binary) {
+      load_char_binary(ch, &img);
+      pfb_free_image(&img);
+    } else while (get_line(fl, line)) {
       tag_argument(line, tag);
 
       switch (*tag) {
@@ -498,20 +511,21 @@ int load_char(const char *name, struct char_data *ch)
     GET_COND(ch, THIRST) = -1;
     GET_COND(ch, DRUNK) = -1;
   }
-  fclose(fl);
+  if (fl)
+    fclose(fl);
   return(id);
 }
 
 /* Write the vital data of a player to the player file. */
-/* This is the ASCII Player Files save routine. */
+/* The file is ASCII, or binary if binary_pfiles is set in the config. */
 void save_char(struct char_data * ch)
 {
-  FILE *fl;
-  char filename[40], buf[MAX_STRING_LENGTH], bits[127], bits2[127], bits3[127], bits4[127];
+  FILE *fl = NULL;
+  char filename[40];
   int i, j, id, save_index = FALSE;
   struct affected_type *aff, tmp_aff[MAX_AFFECT];
   struct obj_data *char_eq[NUM_WEARS];
-  trig_data *t;
+  bool saved;
 
   if (IS_NPC(ch) || GET_PFILEPOS(ch) < 0)
     return;
@@ -534,9 +548,11 @@ void save_char(struct char_data * ch)
     }
   }
 
-  if (!get_filename(filename, sizeof(filename), PLR_FILE, GET_NAME(ch)))
+  if (!get_filename(filename, sizeof(filename),
+        CONFIG_BINARY_PFILES ? PLR_BIN_FILE : PLR_FILE, GET_NAME(ch)))
     return;
-  if (!(fl = fopen(filename, "w"))) {
+  /* The binary file is written in one go once the affects are off, below. */
+  if (!CONFIG_BINARY_PFILES && !(fl = fopen(filename, "w"))) {
     mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Couldn't open player file %s for write", filename);
     return;
   }
@@ -578,6 +594,79 @@ void save_char(struct char_data * ch)
   ch->aff_abils = ch->real_abils;
   /* end char_to_store code */
 
+  if (CONFIG_BINARY_PFILES)
+    saved = write_pfile_binary(filename, ch, tmp_aff);
+  else {
+    write_pfile_ascii(fl, ch, tmp_aff);
+    fclose(fl);
+    saved = TRUE;
+  }
+
+  /* Keep only the file just written, so that a stale copy in the other format
+   * is never loaded in its place. */
+  if (saved && get_filename(filename, sizeof(filename),
+        CONFIG_BINARY_PFILES ? PLR_FILE : PLR_BIN_FILE, GET_NAME(ch)))
+    remove(filename);
+
+  /* More char_to_store code to add spell and eq affections back in. */
+  for (i = 0; i < MAX_AFFECT; i++) {
+    if (tmp_aff[i].spell)
+      affect_to_char(ch, &tmp_aff[i]);
+  }
+
+  for (i = 0; i < NUM_WEARS; i++) {
+    if (char_eq[i])
+#ifndef NO_EXTRANEOUS_TRIGGERS
+        if (wear_otrigger(char_eq[i], ch, i))
+#endif
+    equip_char(ch, char_eq[i], i);
+#ifndef NO_EXTRANEOUS_TRIGGERS
+          else
+          obj_to_char(char_eq[i], ch);
+#endif
+  }
+  /* end char_to_store code */
+
+  if ((id = get_ptable_by_name(GET_NAME(ch))) < 0)
+    return;
+
+  /* update the player in the player index */
+  if (player_table[id].level != GET_LEVEL(ch)) {
+    save_index = TRUE;
+    player_table[id].level = GET_LEVEL(ch);
+  }
+  if (player_table[id].last != ch->player.time.logon) {
+    save_index = TRUE;
+    player_table[id].last = ch->player.time.logon;
+  }
+  i = player_table[id].flags;
+  if (PLR_FLAGGED(ch, PLR_DELETED))
+    SET_BIT(player_table[id].flags, PINDEX_DELETED);
+  else
+    REMOVE_BIT(player_table[id].flags, PINDEX_DELETED);
+  if (PLR_FLAGGED(ch, PLR_NODELETE) || PLR_FLAGGED(ch, PLR_CRYO))
+    SET_BIT(player_table[id].flags, PINDEX_NODELETE);
+  else
+    REMOVE_BIT(player_table[id].flags, PINDEX_NODELETE);
+
+  if (PLR_FLAGGED(ch, PLR_FROZEN) || PLR_FLAGGED(ch, PLR_NOWIZLIST))
+    SET_BIT(player_table[id].flags, PINDEX_NOWIZLIST);
+  else
+    REMOVE_BIT(player_table[id].flags, PINDEX_NOWIZLIST);
+
+  if (player_table[id].flags != i || save_index)
+    save_player_index();
+}
+
+/* Writes the ASCII player file, one tagged line per field that differs from
+ * its default. tmp_aff holds the affects, already taken off the character. */
+static void write_pfile_ascii(FILE *fl, struct char_data *ch, struct affected_type *tmp_aff)
+{
+  char buf[MAX_STRING_LENGTH], bits[127], bits2[127], bits3[127], bits4[127];
+  struct affected_type *aff;
+  trig_data *t;
+  int i;
+
   if (GET_NAME(ch))				fprintf(fl, "Name: %s\n", GET_NAME(ch));
   if (GET_PASSWD(ch))				fprintf(fl, "Pass: %s\n", GET_PASSWD(ch));
   if (GET_TITLE(ch))				fprintf(fl, "Titl: %s\n", GET_TITLE(ch));
@@ -707,57 +796,6 @@ void save_char(struct char_data * ch)
 
   write_aliases_ascii(fl, ch);
   save_char_vars_ascii(fl, ch);
-
-  fclose(fl);
-
-  /* More char_to_store code to add spell and eq affections back in. */
-  for (i = 0; i < MAX_AFFECT; i++) {
-    if (tmp_aff[i].spell)
-      affect_to_char(ch, &tmp_aff[i]);
-  }
-
-  for (i = 0; i < NUM_WEARS; i++) {
-    if (char_eq[i])
-#ifndef NO_EXTRANEOUS_TRIGGERS
-        if (wear_otrigger(char_eq[i], ch, i))
-#endif
-    equip_char(ch, char_eq[i], i);
-#ifndef NO_EXTRANEOUS_TRIGGERS
-          else
-          obj_to_char(char_eq[i], ch);
-#endif
-  }
-  /* end char_to_store code */
-
-  if ((id = get_ptable_by_name(GET_NAME(ch))) < 0)
-    return;
-
-  /* update the player in the player index */
-  if (player_table[id].level != GET_LEVEL(ch)) {
-    save_index = TRUE;
-    player_table[id].level = GET_LEVEL(ch);
-  }
-  if (player_table[id].last != ch->player.time.logon) {
-    save_index = TRUE;
-    player_table[id].last = ch->player.time.logon;
-  }
-  i = player_table[id].flags;
-  if (PLR_FLAGGED(ch, PLR_DELETED))
-    SET_BIT(player_table[id].flags, PINDEX_DELETED);
-  else
-    REMOVE_BIT(player_table[id].flags, PINDEX_DELETED);
-  if (PLR_FLAGGED(ch, PLR_NODELETE) || PLR_FLAGGED(ch, PLR_CRYO))
-    SET_BIT(player_table[id].flags, PINDEX_NODELETE);
-  else
-    REMOVE_BIT(player_table[id].flags, PINDEX_NODELETE);
-
-  if (PLR_FLAGGED(ch, PLR_FROZEN) || PLR_FLAGGED(ch, PLR_NOWIZLIST))
-    SET_BIT(player_table[id].flags, PINDEX_NOWIZLIST);
-  else
-    REMOVE_BIT(player_table[id].flags, PINDEX_NOWIZLIST);
-
-  if (player_table[id].flags != i || save_index)
-    save_player_index();
 }
 
 /* Separate a 4-character id tag from the data it precedes */
@@ -989,3 +1027,282 @@ static void read_aliases_ascii(FILE *file, struct char_data *ch, int count)
     }
   }
 }
+
+/* Binary player files. The character is copied to or from a pfile_image and
+ * pfbinary.c does the rest; see pfbinary.h for the format. */
+
+/* Reads the binary player file of name into img. Returns FALSE, with img
+ * empty, if there is none or it is damaged, and the ASCII file is used. */
+static bool read_pfile_binary(const char *name, struct pfile_image *img)
+{
+  char filename[40];
+  int err;
+
+  if (!get_filename(filename, sizeof(filename), PLR_BIN_FILE, name))
+    return FALSE;
+  if ((err = pfb_read(filename, img)) == PFB_OK)
+    return TRUE;
+  if (err != PFB_ERR_NOFILE)
+    mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Bad binary player file %s (%s), trying ASCII", filename, pfb_strerror(err));
+  return FALSE;
+}
+
+/* Hands a string over from the image, which then no longer frees it. */
+static char *take_pfile_string(struct pfile_image *img, int which)
+{
+  char *str = img->str[which];
+
+  img->str[which] = NULL;
+  return str;
+}
+
+static void load_char_binary(struct char_data *ch, struct pfile_image *img)
+{
+  long long *f = img->field;
+  struct affected_type af;
+  struct alias_data *alias, **tail;
+  struct pfb_alias *pa;
+  trig_data *t;
+  trig_rnum t_rnum;
+  char *str;
+  int i, j;
+
+  GET_SEX(ch) = f[PFB_SEX];
+  GET_CLASS(ch) = f[PFB_CLASS];
+  GET_RACE(ch) = f[PFB_RACE];
+  GET_SUBRACE(ch) = f[PFB_SUBRACE];
+  GET_LEVEL(ch) = f[PFB_LEVEL];
+  GET_IDNUM(ch) = f[PFB_IDNUM];
+  ch->player.time.birth = f[PFB_BIRTH];
+  ch->player.time.played = f[PFB_PLAYED];
+  ch->player.time.logon = f[PFB_LOGON];
+  GET_LAST_MOTD(ch) = f[PFB_LAST_MOTD];
+  GET_LAST_NEWS(ch) = f[PFB_LAST_NEWS];
+  GET_HEIGHT(ch) = f[PFB_HEIGHT];
+  GET_WEIGHT(ch) = f[PFB_WEIGHT];
+  GET_ALIGNMENT(ch) = f[PFB_ALIGNMENT];
+  for (i = 0; i < PFB_FLAG_WORDS; i++)
+    PLR_FLAGS(ch)[i] = f[PFB_PLR_FLAGS + i];
+  for (i = 0; i < PFB_FLAG_WORDS; i++)
+    AFF_FLAGS(ch)[i] = f[PFB_AFF_FLAGS + i];
+  for (i = 0; i < PFB_FLAG_WORDS; i++)
+    PRF_FLAGS(ch)[i] = f[PFB_PRF_FLAGS + i];
+  for (i = 0; i < PFB_NUM_SAVES; i++)
+    GET_SAVE(ch, i) = f[PFB_SAVE + i];
+  GET_WIMP_LEV(ch) = f[PFB_WIMP_LEV];
+  GET_FREEZE_LEV(ch) = f[PFB_FREEZE_LEV];
+  GET_INVIS_LEV(ch) = f[PFB_INVIS_LEV];
+  GET_LOADROOM(ch) = f[PFB_LOADROOM];
+  GET_BAD_PWS(ch) = f[PFB_BAD_PWS];
+  GET_PRACTICES(ch) = f[PFB_PRACTICES];
+  GET_COND(ch, HUNGER) = f[PFB_HUNGER];
+  GET_COND(ch, THIRST) = f[PFB_THIRST];
+  GET_COND(ch, DRUNK) = f[PFB_DRUNK];
+  GET_HIT(ch) = f[PFB_HIT];
+  GET_MAX_HIT(ch) = f[PFB_MAX_HIT];
+  GET_MANA(ch) = f[PFB_MANA];
+  GET_MAX_MANA(ch) = f[PFB_MAX_MANA];
+  GET_MOVE(ch) = f[PFB_MOVE];
+  GET_MAX_MOVE(ch) = f[PFB_MAX_MOVE];
+  ch->real_abils.str = f[PFB_STR];
+  ch->real_abils.str_add = f[PFB_STR_ADD];
+  ch->real_abils.intel = f[PFB_INT];
+  ch->real_abils.wis = f[PFB_WIS];
+  ch->real_abils.dex = f[PFB_DEX];
+  ch->real_abils.con = f[PFB_CON];
+  ch->real_abils.cha = f[PFB_CHA];
+  GET_AC(ch) = f[PFB_AC];
+  GET_GOLD(ch) = f[PFB_GOLD];
+  GET_BANK_GOLD(ch) = f[PFB_BANK_GOLD];
+  GET_EXP(ch) = f[PFB_EXP];
+  GET_HITROLL(ch) = f[PFB_HITROLL];
+  GET_DAMROLL(ch) = f[PFB_DAMROLL];
+  GET_OLC_ZONE(ch) = f[PFB_OLC_ZONE];
+  GET_PAGE_LENGTH(ch) = f[PFB_PAGE_LENGTH];
+  GET_SCREEN_WIDTH(ch) = f[PFB_SCREEN_WIDTH];
+  GET_QUESTPOINTS(ch) = f[PFB_QUESTPOINTS];
+  GET_QUEST_COUNTER(ch) = f[PFB_QUEST_COUNTER];
+  GET_QUEST(ch) = f[PFB_CURR_QUEST];
+
+  GET_PC_NAME(ch) = take_pfile_string(img, PFB_NAME);
+  if (img->str[PFB_PASSWD])
+    strlcpy(GET_PASSWD(ch), img->str[PFB_PASSWD], sizeof(GET_PASSWD(ch)));
+  GET_TITLE(ch) = take_pfile_string(img, PFB_TITLE);
+  ch->player.description = take_pfile_string(img, PFB_DESC);
+  POOFIN(ch) = take_pfile_string(img, PFB_POOFIN);
+  POOFOUT(ch) = take_pfile_string(img, PFB_POOFOUT);
+  if ((str = take_pfile_string(img, PFB_HOST)) != NULL) {
+    if (GET_HOST(ch))
+      free(GET_HOST(ch));
+    GET_HOST(ch) = str;
+  }
+
+  for (i = 0; i < img->num_skills; i++)
+    if (img->skills[i].num > 0 && img->skills[i].num <= MAX_SKILLS)
+      SET_PLAYER_SKILL(ch, img->skills[i].num, img->skills[i].level);
+
+  for (i = 0; i < img->num_affects; i++) {
+    if (img->affects[i].spell <= 0)
+      continue;
+    new_affect(&af);
+    af.spell = img->affects[i].spell;
+    af.duration = img->affects[i].duration;
+    af.modifier = img->affects[i].modifier;
+    af.location = img->affects[i].location;
+    for (j = 0; j < PFB_FLAG_WORDS; j++)
+      af.bitvector[j] = img->affects[i].bitvector[j];
+    affect_to_char(ch, &af);
+  }
+
+  for (i = 0; i < img->num_quests; i++)
+    add_completed_quest(ch, img->quests[i]);
+
+  /* Aliases keep the order they were saved in. */
+  for (tail = &GET_ALIASES(ch); *tail; tail = &(*tail)->next)
+    ;
+  for (i = 0; i < img->num_aliases; i++) {
+    pa = &img->aliases[i];
+    CREATE(alias, struct alias_data, 1);
+    alias->alias = pa->alias;
+    alias->replacement = pa->replacement;
+    alias->type = pa->type;
+    pa->alias = pa->replacement = NULL;
+    *tail = alias;
+    tail = &alias->next;
+  }
+
+  /* As with read_saved_vars_ascii(), variables already in memory win. */
+  if (img->num_vars && !SCRIPT(ch)) {
+    CREATE(SCRIPT(ch), struct script_data, 1);
+    for (i = 0; i < img->num_vars; i++)
+      add_var(&(SCRIPT(ch)->global_vars), img->vars[i].name, img->vars[i].value, img->vars[i].context);
+  }
+
+  if (CONFIG_SCRIPT_PLAYERS)
+    for (i = 0; i < img->num_triggers; i++)
+      if ((t_rnum = real_trigger(img->triggers[i])) != NOTHING) {
+        t = read_trigger(t_rnum);
+        if (!SCRIPT(ch))
+          CREATE(SCRIPT(ch), struct script_data, 1);
+        add_trigger(SCRIPT(ch), t, -1);
+      }
+}
+
+/* Writes the binary player file. tmp_aff holds the affects, already taken
+ * off the character, as for write_pfile_ascii(). */
+static bool write_pfile_binary(const char *filename, struct char_data *ch, struct affected_type *tmp_aff)
+{
+  struct pfile_image img;
+  long long *f = img.field;
+  struct pfb_affect af;
+  struct alias_data *alias;
+  struct trig_var_data *vars;
+  trig_data *t;
+  int i, j, err;
+
+  pfb_init_image(&img);
+
+  f[PFB_SEX] = GET_SEX(ch);
+  f[PFB_CLASS] = GET_CLASS(ch);
+  f[PFB_RACE] = GET_RACE(ch);
+  f[PFB_SUBRACE] = GET_SUBRACE(ch);
+  f[PFB_LEVEL] = GET_LEVEL(ch);
+  f[PFB_IDNUM] = GET_IDNUM(ch);
+  f[PFB_BIRTH] = ch->player.time.birth;
+  f[PFB_PLAYED] = ch->player.time.played;
+  f[PFB_LOGON] = ch->player.time.logon;
+  f[PFB_LAST_MOTD] = GET_LAST_MOTD(ch);
+  f[PFB_LAST_NEWS] = GET_LAST_NEWS(ch);
+  f[PFB_HEIGHT] = GET_HEIGHT(ch);
+  f[PFB_WEIGHT] = GET_WEIGHT(ch);
+  f[PFB_ALIGNMENT] = GET_ALIGNMENT(ch);
+  for (i = 0; i < PFB_FLAG_WORDS; i++)
+    f[PFB_PLR_FLAGS + i] = PLR_FLAGS(ch)[i];
+  for (i = 0; i < PFB_FLAG_WORDS; i++)
+    f[PFB_AFF_FLAGS + i] = AFF_FLAGS(ch)[i];
+  for (i = 0; i < PFB_FLAG_WORDS; i++)
+    f[PFB_PRF_FLAGS + i] = PRF_FLAGS(ch)[i];
+  for (i = 0; i < PFB_NUM_SAVES; i++)
+    f[PFB_SAVE + i] = GET_SAVE(ch, i);
+  f[PFB_WIMP_LEV] = GET_WIMP_LEV(ch);
+  f[PFB_FREEZE_LEV] = GET_FREEZE_LEV(ch);
+  f[PFB_INVIS_LEV] = GET_INVIS_LEV(ch);
+  f[PFB_LOADROOM] = GET_LOADROOM(ch);
+  f[PFB_BAD_PWS] = GET_BAD_PWS(ch);
+  f[PFB_PRACTICES] = GET_PRACTICES(ch);
+  f[PFB_HUNGER] = GET_COND(ch, HUNGER);
+  f[PFB_THIRST] = GET_COND(ch, THIRST);
+  f[PFB_DRUNK] = GET_COND(ch, DRUNK);
+  f[PFB_HIT] = GET_HIT(ch);
+  f[PFB_MAX_HIT] = GET_MAX_HIT(ch);
+  f[PFB_MANA] = GET_MANA(ch);
+  f[PFB_MAX_MANA] = GET_MAX_MANA(ch);
+  f[PFB_MOVE] = GET_MOVE(ch);
+  f[PFB_MAX_MOVE] = GET_MAX_MOVE(ch);
+  f[PFB_STR] = GET_STR(ch);
+  f[PFB_STR_ADD] = GET_ADD(ch);
+  f[PFB_INT] = GET_INT(ch);
+  f[PFB_WIS] = GET_WIS(ch);
+  f[PFB_DEX] = GET_DEX(ch);
+  f[PFB_CON] = GET_CON(ch);
+  f[PFB_CHA] = GET_CHA(ch);
+  f[PFB_AC] = GET_AC(ch);
+  f[PFB_GOLD] = GET_GOLD(ch);
+  f[PFB_BANK_GOLD] = GET_BANK_GOLD(ch);
+  f[PFB_EXP] = GET_EXP(ch);
+  f[PFB_HITROLL] = GET_HITROLL(ch);
+  f[PFB_DAMROLL] = GET_DAMROLL(ch);
+  f[PFB_OLC_ZONE] = GET_OLC_ZONE(ch);
+  f[PFB_PAGE_LENGTH] = GET_PAGE_LENGTH(ch);
+  f[PFB_SCREEN_WIDTH] = GET_SCREEN_WIDTH(ch);
+  f[PFB_QUESTPOINTS] = GET_QUESTPOINTS(ch);
+  f[PFB_QUEST_COUNTER] = GET_QUEST_COUNTER(ch);
+  f[PFB_CURR_QUEST] = GET_QUEST(ch);
+
+  pfb_set_string(&img, PFB_NAME, GET_NAME(ch));
+  pfb_set_string(&img, PFB_PASSWD, GET_PASSWD(ch));
+  pfb_set_string(&img, PFB_TITLE, GET_TITLE(ch));
+  if (ch->player.description && *ch->player.description)
+    pfb_set_string(&img, PFB_DESC, ch->player.description);
+  pfb_set_string(&img, PFB_POOFIN, POOFIN(ch));
+  pfb_set_string(&img, PFB_POOFOUT, POOFOUT(ch));
+  pfb_set_string(&img, PFB_HOST, GET_HOST(ch));
+
+  /* Immortals get every skill at 100 when they load, so none are saved. */
+  if (GET_LEVEL(ch) < LVL_IMMORT)
+    for (i = 1; i <= MAX_SKILLS; i++)
+      if (GET_PLAYER_SKILL(ch, i))
+        pfb_add_skill(&img, i, GET_PLAYER_SKILL(ch, i));
+
+  for (i = 0; i < MAX_AFFECT; i++) {
+    if (!tmp_aff[i].spell)
+      continue;
+    af.spell = tmp_aff[i].spell;
+    af.duration = tmp_aff[i].duration;
+    af.modifier = tmp_aff[i].modifier;
+    af.location = tmp_aff[i].location;
+    for (j = 0; j < PFB_FLAG_WORDS; j++)
+      af.bitvector[j] = tmp_aff[i].bitvector[j];
+    pfb_add_affect(&img, &af);
+  }
+
+  for (i = 0; i < GET_NUM_QUESTS(ch); i++)
+    pfb_add_quest(&img, ch->player_specials->saved.completed_quests[i]);
+
+  if (SCRIPT(ch)) {
+    for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next)
+      pfb_add_trigger(&img, GET_TRIG_VNUM(t));
+    /* Variables whose names begin with - are not saved. */
+    for (vars = SCRIPT(ch)->global_vars; vars; vars = vars->next)
+      if (*vars->name != '-')
+        pfb_add_var(&img, vars->name, vars->context, vars->value);
+  }
+
+  for (alias = GET_ALIASES(ch); alias; alias = alias->next)
+    pfb_add_alias(&img, alias->alias, alias->replacement, alias->type);
+
+  if ((err = pfb_write(filename, &img)) != PFB_OK)
+    mudlog(NRM, LVL_GOD, TRUE, "SYSERR: Couldn't write player file %s: %s", filename, pfb_strerror(err));
+  pfb_free_image(&img);
+  return (err == PFB_OK);
+}
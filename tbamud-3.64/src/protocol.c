@@ -42,7 +42,7 @@ static void Write( descriptor_t *apDescriptor, const char *apData )
          apDescriptor->pProtocol->WriteOOB = 2;
       }
    }
-   write_to_output( apDescriptor, apData, 0 );
+   write_to_output( apDescriptor, "%s", apData );
 }
 
 static void ReportBug( const char *apText )
@@ -194,6 +194,80 @@ static variable_name_t VariableNameTable[eMSDP_MAX+1] =
    { eMSDP_MAX,              "", 0 } /* This must always be last. */
 };
 
+/******************************************************************************
+ GMCP package table.
+ ******************************************************************************/
+
+/* GMCP packages are built from the MSDP variables, so the same MSDPSet*() 
+ * calls and dirty flags keep both kinds of client up to date.  The fields of 
+ * a package must be listed together.
+ */
+typedef struct
+{
+   int          Module;        /* The GMCP_ module the package belongs to */
+   const char  *pPackage;      /* The name of the package */
+   variable_t   Variable;      /* The MSDP variable holding the value */
+   const char  *pField;        /* The name of the field in the package */
+} gmcp_field_t;
+
+static const gmcp_field_t GMCPFieldTable[] = 
+{
+   { GMCP_CHAR, "Char.Vitals", eMSDP_HEALTH,          "hp" }, 
+   { GMCP_CHAR, "Char.Vitals", eMSDP_HEALTH_MAX,      "maxhp" }, 
+   { GMCP_CHAR, "Char.Vitals", eMSDP_MANA,            "mp" }, 
+   { GMCP_CHAR, "Char.Vitals", eMSDP_MANA_MAX,        "maxmp" }, 
+   { GMCP_CHAR, "Char.Vitals", eMSDP_MOVEMENT,        "mv" }, 
+   { GMCP_CHAR, "Char.Vitals", eMSDP_MOVEMENT_MAX,    "maxmv" }, 
+
+   { GMCP_CHAR, "Char.Status", eMSDP_CHARACTER_NAME,  "name" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_CLASS,           "class" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_LEVEL,           "level" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_ALIGNMENT,       "alignment" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_EXPERIENCE,      "xp" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_MONEY,           "gold" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_AC,              "ac" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_WIMPY,           "wimpy" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_OPPONENT_NAME,   "enemy" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_OPPONENT_HEALTH, "enemypct" }, 
+   { GMCP_CHAR, "Char.Status", eMSDP_OPPONENT_LEVEL,  "enemylevel" }, 
+
+   { GMCP_ROOM, "Room.Info",   eMSDP_ROOM_VNUM,       "num" }, 
+   { GMCP_ROOM, "Room.Info",   eMSDP_ROOM_NAME,       "name" }, 
+   { GMCP_ROOM, "Room.Info",   eMSDP_AREA_NAME,       "zone" }, 
+   { GMCP_ROOM, "Room.Info",   eMSDP_ROOM_EXITS,      "exits" }, 
+
+   { 0,         NULL,          eMSDP_NONE,            NULL } /* This must always be last. */
+};
+
+/* The modules a client can name in Core.Supports. */
+static const struct
+{
+   int          Module;        /* The GMCP_ bit */
+   const char  *pName;         /* The module name */
+} GMCPModuleTable[] = 
+{
+   { GMCP_CHAR, "Char" }, 
+   { GMCP_ROOM, "Room" }, 
+   { GMCP_COMM, "Comm" }, 
+   { 0,         NULL }
+};
+
+/******************************************************************************
+ JSON writer.
+ ******************************************************************************/
+
+/* Just enough JSON for GMCP.  It writes into a buffer supplied by the caller 
+ * and never allocates; if the buffer runs out it stops and sets bOverflow.
+ */
+typedef struct
+{
+   char        *pBuffer;       /* Where the output goes */
+   int          Size;          /* The size of the buffer */
+   int          Length;        /* How much has been written */
+   bool_t       bComma;        /* The next value needs a comma first */
+   bool_t       bOverflow;     /* The buffer ran out */
+} json_t;
+
 /******************************************************************************
  MSSP file-scope variables.
  ******************************************************************************/
@@ -217,6 +291,23 @@ static void ParseATCP            ( descriptor_t *apDescriptor, const char *apDat
 static void SendATCP             ( descriptor_t *apDescriptor, const char *apVariable, const char *apValue );
 #endif /* MUDLET_PACKAGE */
 
+static void ParseGMCP            ( descriptor_t *apDescriptor, const char *apData );
+static void GMCPEnable           ( descriptor_t *apDescriptor, int aModules );
+static void GMCPUpdate           ( descriptor_t *apDescriptor );
+static void GMCPStart            ( json_t *apJSON, const char *apPackage );
+static void GMCPEnd              ( json_t *apJSON );
+
+static void JSONInit             ( json_t *apJSON, char *apBuffer, int aSize );
+static void JSONRaw              ( json_t *apJSON, const char *apData, int aLength );
+static void JSONNext             ( json_t *apJSON );
+static void JSONQuote            ( json_t *apJSON, const char *apValue, int aLength );
+static void JSONOpen             ( json_t *apJSON, char aBracket );
+static void JSONClose            ( json_t *apJSON, char aBracket );
+static void JSONKey              ( json_t *apJSON, const char *apKey, int aLength );
+static void JSONString           ( json_t *apJSON, const char *apValue, int aLength );
+static void JSONNumber           ( json_t *apJSON, int aValue );
+static void JSONMSDPValue        ( json_t *apJSON, const char *apValue );
+
 static void SendMSSP             ( descriptor_t *apDescriptor );
 
 static char *GetMxpTag           ( const char *apTag, const char *apText );
@@ -297,6 +388,8 @@ protocol_t *ProtocolCreate( void )
    pProtocol->bCHARSET = false;
    pProtocol->bMSDP = false;
    pProtocol->bATCP = false;
+   pProtocol->bGMCP = false;
+   pProtocol->GMCPSupports = 0;
    pProtocol->bMSP = false;
    pProtocol->bMXP = false;
    pProtocol->bMCCP = false;
@@ -895,6 +988,8 @@ const char *CopyoverGet( descriptor_t *apDescriptor )
          *pBuffer++ = 'M';
       if ( pProtocol->bATCP )
          *pBuffer++ = 'A';
+      if ( pProtocol->bGMCP )
+         *pBuffer++ = 'G';
       if ( pProtocol->bMSP )
          *pBuffer++ = 'S';
       if ( pProtocol->pVariables[eMSDP_MXP]->ValueInt )
@@ -944,6 +1039,9 @@ void CopyoverSet( descriptor_t *apDescriptor, const char *apData )
             case 'A':
                pProtocol->bATCP = true;
                break;
+            case 'G':
+               GMCPEnable( apDescriptor, GMCP_ALL );
+               break;
             case 'S':
                pProtocol->bMSP = true;
                break;
@@ -1004,6 +1102,13 @@ void CopyoverSet( descriptor_t *apDescriptor, const char *apData )
          Write(apDescriptor, DoATCP);
       }
 
+      /* The client sends Core.Supports again once it sees GMCP offered */
+      if ( pProtocol->bGMCP )
+      {
+         char WillGMCP [] = { (char)IAC, (char)WILL, (char)TELOPT_GMCP, '\0' };
+         Write(apDescriptor, WillGMCP);
+      }
+
       /* Ask the client to send its MXP version again */
       if ( pProtocol->bMXP )
          MXPSendTag( apDescriptor, "<VERSION>" );
@@ -1016,21 +1121,67 @@ void CopyoverSet( descriptor_t *apDescriptor, const char *apData )
 
 void MSDPUpdate( descriptor_t *apDescriptor )
 {
+   char MSDPBuffer[MAX_VARIABLE_LENGTH+1];
+   int Length = 0;
    int i; /* Loop counter */
 
    protocol_t *pProtocol = apDescriptor ? apDescriptor->pProtocol : NULL;
 
+   if ( pProtocol->bGMCP )
+      GMCPUpdate( apDescriptor );
+
    for ( i = eMSDP_NONE+1; i < eMSDP_MAX; ++i )
    {
-      if ( pProtocol->pVariables[i]->bReport )
+      if ( pProtocol->pVariables[i]->bReport && pProtocol->pVariables[i]->bDirty )
       {
-         if ( pProtocol->pVariables[i]->bDirty )
+         if ( pProtocol->bMSDP )
          {
-            MSDPSend( apDescriptor, (variable_t)i );
-            pProtocol->pVariables[i]->bDirty = false;
+            char Number[32];
+            const char *pValue = Number;
+            int Required;
+
+            if ( VariableNameTable[i].bString )
+               pValue = pProtocol->pVariables[i]->pValueString;
+            else /* It's an integer, not a string */
+               sprintf( Number, "%d", pProtocol->pVariables[i]->ValueInt );
+
+            Required = strlen(VariableNameTable[i].pName) + strlen(pValue) + 2;
+
+            /* Start another subnegotiation if this one is full */
+            if ( Length > 0 && Length + Required + 2 >= MAX_VARIABLE_LENGTH )
+            {
+               sprintf( MSDPBuffer + Length, "%c%c", IAC, SE );
+               Write( apDescriptor, MSDPBuffer );
+               Length = 0;
+            }
+
+            if ( Required + 5 >= MAX_VARIABLE_LENGTH )
+            {
+               /* Too big even on its own; MSDPSend() reports it */
+               MSDPSend( apDescriptor, (variable_t)i );
+            }
+            else
+            {
+               if ( Length == 0 )
+                  Length = sprintf( MSDPBuffer, "%c%c%c", IAC, SB, TELOPT_MSDP );
+               Length += sprintf( MSDPBuffer + Length, "%c%s%c%s", MSDP_VAR, 
+                  VariableNameTable[i].pName, MSDP_VAL, pValue );
+            }
          }
+         else /* ATCP only takes one variable to a message */
+            MSDPSend( apDescriptor, (variable_t)i );
       }
    }
+
+   if ( Length > 0 )
+   {
+      sprintf( MSDPBuffer + Length, "%c%c", IAC, SE );
+      Write( apDescriptor, MSDPBuffer );
+   }
+
+   /* MSDP and GMCP have both been sent everything that changed. */
+   for ( i = eMSDP_NONE+1; i < eMSDP_MAX; ++i )
+      pProtocol->pVariables[i]->bDirty = false;
 }
 
 void MSDPFlush( descriptor_t *apDescriptor, variable_t aMSDP )
@@ -1321,6 +1472,45 @@ void MSDPSetArray( descriptor_t *apDescriptor, variable_t aMSDP, const char *apV
    }
 }
 
+/******************************************************************************
+ GMCP global functions.
+ ******************************************************************************/
+
+void GMCPSendChannel( descriptor_t *apDescriptor, const char *apChannel, const char *apTalker, const char *apText )
+{
+   char GMCPBuffer[MAX_VARIABLE_LENGTH+1];
+   json_t JSON;
+   int Length;
+
+   protocol_t *pProtocol = apDescriptor ? apDescriptor->pProtocol : NULL;
+
+   if ( pProtocol == NULL || !pProtocol->bGMCP || 
+      !(pProtocol->GMCPSupports & GMCP_COMM) || apText == NULL )
+      return;
+
+   /* Leave off the line ending */
+   Length = strlen(apText);
+   while ( Length > 0 && (apText[Length-1] == '\r' || apText[Length-1] == '\n') )
+      --Length;
+
+   JSONInit( &JSON, GMCPBuffer, sizeof(GMCPBuffer) );
+   GMCPStart( &JSON, "Comm.Channel.Text" );
+   JSONOpen( &JSON, '{' );
+   JSONKey( &JSON, "channel", 7 );
+   JSONString( &JSON, apChannel, strlen(apChannel) );
+   JSONKey( &JSON, "talker", 6 );
+   JSONString( &JSON, apTalker, strlen(apTalker) );
+   JSONKey( &JSON, "text", 4 );
+   JSONString( &JSON, apText, Length );
+   JSONClose( &JSON, '}' );
+   GMCPEnd( &JSON );
+
+   if ( JSON.bOverflow )
+      ReportBug( "GMCPSendChannel: Comm.Channel.Text exceeds MAX_VARIABLE_LENGTH.\n" );
+   else
+      Write( apDescriptor, GMCPBuffer );
+}
+
 /******************************************************************************
  MSSP global functions.
  ******************************************************************************/
@@ -1491,6 +1681,7 @@ static void Negotiate( descriptor_t *apDescriptor )
       const char WillMSDP       [] = { (char)IAC, (char)WILL, TELOPT_MSDP,      '\0' };
       const char WillMSSP       [] = { (char)IAC, (char)WILL, TELOPT_MSSP,      '\0' };
       const char DoATCP         [] = { (char)IAC, (char)DO,   (char)TELOPT_ATCP,'\0' };
+      const char WillGMCP       [] = { (char)IAC, (char)WILL, (char)TELOPT_GMCP,'\0' };
       const char WillMSP        [] = { (char)IAC, (char)WILL, TELOPT_MSP,       '\0' };
       const char DoMXP          [] = { (char)IAC, (char)DO,   TELOPT_MXP,       '\0' };
 
@@ -1517,6 +1708,7 @@ static void Negotiate( descriptor_t *apDescriptor )
       Write(apDescriptor, WillMSDP);
       Write(apDescriptor, WillMSSP);
       Write(apDescriptor, DoATCP);
+      Write(apDescriptor, WillGMCP);
       Write(apDescriptor, WillMSP);
       Write(apDescriptor, DoMXP);
 
@@ -1597,6 +1789,15 @@ static void PerformHandshake( descriptor_t *apDescriptor, char aCmd, char aProto
             bResult = false;
          break;
 
+      case (char)TELOPT_GMCP:
+         if ( aCmd == (char)DO )
+            GMCPEnable( apDescriptor, GMCP_ALL );
+         else if ( aCmd == (char)DONT )
+            pProtocol->bGMCP = false;
+         else /* Anything else is invalid. */
+            bResult = false;
+         break;
+
       case (char)TELOPT_MSSP:
          if ( aCmd == (char)DO )
             SendMSSP( apDescriptor );
@@ -1880,6 +2081,10 @@ static void PerformSubnegotiation( descriptor_t *apDescriptor, char aCmd, char *
          ParseATCP( apDescriptor, apData );
          break;
 
+      case (char)TELOPT_GMCP:
+         ParseGMCP( apDescriptor, apData );
+         break;
+
       default: /* Unknown subnegotiation, so we simply ignore it. */
          break;
    }
@@ -2215,6 +2420,316 @@ static void SendATCP( descriptor_t *apDescriptor, const char *apVariable, const
 }
 #endif /* MUDLET_PACKAGE */
 
+/******************************************************************************
+ Local GMCP functions.
+ ******************************************************************************/
+
+static void ParseGMCP( descriptor_t *apDescriptor, const char *apData )
+{
+   protocol_t *pProtocol = apDescriptor->pProtocol;
+   const char *pData = apData;
+   int Modules = 0;
+   int i; /* Loop counter */
+
+   if ( !PrefixString("Core.Supports.", apData) )
+      return; /* Nothing else from the client needs an answer */
+
+   /* Pick the module names out of a list like ["Char 1", "Room 1"] */
+   while ( (pData = strchr(pData, '"')) != NULL )
+   {
+      const char *pName = ++pData;
+
+      while ( *pData != '\0' && *pData != '"' && *pData != ' ' )
+         ++pData;
+
+      for ( i = 0; GMCPModuleTable[i].pName != NULL; ++i )
+      {
+         if ( (int)strlen(GMCPModuleTable[i].pName) == pData - pName && 
+            PrefixString(GMCPModuleTable[i].pName, pName) )
+            Modules |= GMCPModuleTable[i].Module;
+      }
+
+      /* Skip the version to the closing quote */
+      while ( *pData != '\0' && *pData != '"' )
+         ++pData;
+      if ( *pData == '"' )
+         ++pData;
+   }
+
+   if ( PrefixString("Core.Supports.Set", apData) )
+      GMCPEnable( apDescriptor, Modules );
+   else if ( PrefixString("Core.Supports.Add", apData) )
+      GMCPEnable( apDescriptor, pProtocol->GMCPSupports | Modules );
+   else if ( PrefixString("Core.Supports.Remove", apData) )
+      pProtocol->GMCPSupports &= ~Modules;
+}
+
+static void GMCPEnable( descriptor_t *apDescriptor, int aModules )
+{
+   protocol_t *pProtocol = apDescriptor->pProtocol;
+   int i; /* Loop counter */
+
+   pProtocol->bGMCP = true;
+   pProtocol->GMCPSupports = aModules;
+
+   /* The client gets all of its packages on the next update */
+   for ( i = 0; GMCPFieldTable[i].pPackage != NULL; ++i )
+   {
+      if ( aModules & GMCPFieldTable[i].Module )
+         pProtocol->pVariables[GMCPFieldTable[i].Variable]->bDirty = true;
+   }
+}
+
+static void GMCPUpdate( descriptor_t *apDescriptor )
+{
+   char GMCPBuffer[MAX_VARIABLE_LENGTH+1];
+   json_t JSON;
+   int i, j, k; /* Loop counters */
+
+   protocol_t *pProtocol = apDescriptor->pProtocol;
+
+   JSONInit( &JSON, GMCPBuffer, sizeof(GMCPBuffer) );
+
+   for ( i = 0; GMCPFieldTable[i].pPackage != NULL; i = j )
+   {
+      const char *pPackage = GMCPFieldTable[i].pPackage;
+      bool_t bDirty = false;
+      int Mark = JSON.Length;
+
+      /* Find the end of the package, and whether any of it has changed */
+      for ( j = i; GMCPFieldTable[j].pPackage != NULL && 
+         !strcmp(GMCPFieldTable[j].pPackage, pPackage); ++j )
+      {
+         if ( pProtocol->pVariables[GMCPFieldTable[j].Variable]->bDirty )
+            bDirty = true;
+      }
+
+      if ( !bDirty || !(pProtocol->GMCPSupports & GMCPFieldTable[i].Module) )
+         continue;
+
+      /* The whole package is sent, so the client never has to merge it */
+      GMCPStart( &JSON, pPackage );
+      JSONOpen( &JSON, '{' );
+      for ( k = i; k < j; ++k )
+      {
+         MSDP_t *pVariable = pProtocol->pVariables[GMCPFieldTable[k].Variable];
+
+         JSONKey( &JSON, GMCPFieldTable[k].pField, strlen(GMCPFieldTable[k].pField) );
+         if ( VariableNameTable[GMCPFieldTable[k].Variable].bString )
+            JSONMSDPValue( &JSON, pVariable->pValueString );
+         else /* It's an integer, not a string */
+            JSONNumber( &JSON, pVariable->ValueInt );
+      }
+      JSONClose( &JSON, '}' );
+      GMCPEnd( &JSON );
+
+      if ( JSON.bOverflow )
+      {
+         /* Send the packages before this one and try it again on its own */
+         GMCPBuffer[Mark] = '\0';
+         if ( Mark > 0 )
+         {
+            Write( apDescriptor, GMCPBuffer );
+            j = i;
+         }
+         else /* It doesn't fit even by itself */
+         {
+            ReportBug( "GMCPUpdate: A package exceeds MAX_VARIABLE_LENGTH.\n" );
+         }
+         JSONInit( &JSON, GMCPBuffer, sizeof(GMCPBuffer) );
+      }
+   }
+
+   if ( JSON.Length > 0 )
+      Write( apDescriptor, GMCPBuffer );
+}
+
+static void GMCPStart( json_t *apJSON, const char *apPackage )
+{
+   const char SB_GMCP[] = { (char)IAC, (char)SB, (char)TELOPT_GMCP };
+
+   JSONRaw( apJSON, SB_GMCP, sizeof(SB_GMCP) );
+   JSONRaw( apJSON, apPackage, strlen(apPackage) );
+   JSONRaw( apJSON, " ", 1 );
+   apJSON->bComma = false;
+}
+
+static void GMCPEnd( json_t *apJSON )
+{
+   const char SE_GMCP[] = { (char)IAC, (char)SE };
+
+   JSONRaw( apJSON, SE_GMCP, sizeof(SE_GMCP) );
+}
+
+/******************************************************************************
+ Local JSON functions.
+ ******************************************************************************/
+
+static void JSONInit( json_t *apJSON, char *apBuffer, int aSize )
+{
+   apJSON->pBuffer = apBuffer;
+   apJSON->Size = aSize;
+   apJSON->Length = 0;
+   apJSON->bComma = false;
+   apJSON->bOverflow = false;
+   apBuffer[0] = '\0';
+}
+
+static void JSONRaw( json_t *apJSON, const char *apData, int aLength )
+{
+   if ( apJSON->bOverflow || apJSON->Length + aLength >= apJSON->Size )
+   {
+      apJSON->bOverflow = true;
+      return;
+   }
+
+   memcpy( apJSON->pBuffer + apJSON->Length, apData, aLength );
+   apJSON->Length += aLength;
+   apJSON->pBuffer[apJSON->Length] = '\0';
+}
+
+/* Separates a value from the one before it, if there was one. */
+static void JSONNext( json_t *apJSON )
+{
+   if ( apJSON->bComma )
+      JSONRaw( apJSON, ",", 1 );
+   apJSON->bComma = true;
+}
+
+static void JSONOpen( json_t *apJSON, char aBracket )
+{
+   JSONNext( apJSON );
+   JSONRaw( apJSON, &aBracket, 1 );
+   apJSON->bComma = false;
+}
+
+static void JSONClose( json_t *apJSON, char aBracket )
+{
+   JSONRaw( apJSON, &aBracket, 1 );
+   apJSON->bComma = true;
+}
+
+/* Writes a quoted string.  Colour codes are dropped, since clients show GMCP 
+ * text however they like, and anything outside printable ASCII is escaped so 
+ * that an IAC can never turn up in the middle of the subnegotiation.
+ */
+static void JSONQuote( json_t *apJSON, const char *apValue, int aLength )
+{
+   const char *pEnd = apValue + aLength;
+   char Escape[8];
+
+   JSONRaw( apJSON, "\"", 1 );
+
+   while ( apValue < pEnd )
+   {
+      unsigned char Char = (unsigned char)*apValue++;
+
+      if ( Char == '\t' && apValue < pEnd && *apValue != '\t' )
+      {
+         ++apValue; /* A colour code */
+      }
+      else if ( Char == '\033' && apValue < pEnd && *apValue == '[' )
+      {
+         /* An ANSI sequence: skip to its final letter */
+         while ( apValue < pEnd && !isalpha(*apValue) )
+            ++apValue;
+         if ( apValue < pEnd )
+            ++apValue;
+      }
+      else if ( Char == '"' || Char == '\\' )
+      {
+         Escape[0] = '\\';
+         Escape[1] = Char;
+         JSONRaw( apJSON, Escape, 2 );
+      }
+      else if ( Char == '\t' || Char < ' ' || Char >= 0x7F )
+      {
+         if ( Char == '\t' )
+            ++apValue; /* Two tabs are one real tab */
+         sprintf( Escape, "\\u%04x", Char );
+         JSONRaw( apJSON, Escape, 6 );
+      }
+      else
+      {
+         Escape[0] = Char;
+         JSONRaw( apJSON, Escape, 1 );
+      }
+   }
+
+   JSONRaw( apJSON, "\"", 1 );
+}
+
+static void JSONKey( json_t *apJSON, const char *apKey, int aLength )
+{
+   JSONNext( apJSON );
+   JSONQuote( apJSON, apKey, aLength );
+   JSONRaw( apJSON, ":", 1 );
+   apJSON->bComma = false;
+}
+
+static void JSONString( json_t *apJSON, const char *apValue, int aLength )
+{
+   JSONNext( apJSON );
+   JSONQuote( apJSON, apValue, aLength );
+}
+
+static void JSONNumber( json_t *apJSON, int aValue )
+{
+   char Number[32];
+
+   JSONNext( apJSON );
+   JSONRaw( apJSON, Number, sprintf(Number, "%d", aValue) );
+}
+
+/* Writes an MSDP value, turning an MSDP table or array into a JSON object 
+ * or array.  Only one level is handled, which is all the variables in the 
+ * GMCP packages use.  Values that look like numbers are written as numbers.
+ */
+static void JSONMSDPValue( json_t *apJSON, const char *apValue )
+{
+   bool_t bTable = ( *apValue == (char)MSDP_TABLE_OPEN );
+
+   if ( !bTable && *apValue != (char)MSDP_ARRAY_OPEN )
+   {
+      JSONString( apJSON, apValue, strlen(apValue) );
+      return;
+   }
+
+   JSONOpen( apJSON, bTable ? '{' : '[' );
+   ++apValue;
+
+   while ( *apValue == (char)MSDP_VAR || *apValue == (char)MSDP_VAL )
+   {
+      char Type = *apValue++;
+      const char *pStart = apValue;
+      int Length, i;
+
+      while ( *apValue != '\0' && (unsigned char)*apValue > MSDP_ARRAY_CLOSE )
+         ++apValue;
+      Length = apValue - pStart;
+
+      if ( Type == (char)MSDP_VAR )
+      {
+         JSONKey( apJSON, pStart, Length );
+         continue;
+      }
+
+      for ( i = (pStart[0] == '-') ? 1 : 0; i < Length && isdigit(pStart[i]); ++i )
+         ;
+      if ( Length > 0 && Length < 10 && i == Length && pStart[Length-1] != '-' )
+      {
+         JSONNext( apJSON );
+         JSONRaw( apJSON, pStart, Length );
+      }
+      else /* Send it as a string */
+      {
+         JSONString( apJSON, pStart, Length );
+      }
+   }
+
+   JSONClose( apJSON, bTable ? '}' : ']' );
+}
+
 /******************************************************************************
  Local MSSP functions.
  ******************************************************************************/
@@ -51,6 +51,7 @@ typedef struct descriptor_data descriptor_t;
 #define TELOPT_MSP                     90
 #define TELOPT_MXP                     91
 #define TELOPT_ATCP                    200
+#define TELOPT_GMCP                    201
 
 #define MSDP_VAR                       1
 #define MSDP_VAL                       2
@@ -63,6 +64,11 @@ typedef struct descriptor_data descriptor_t;
 #define MSSP_VAR                       1
 #define MSSP_VAL                       2
 
+#define GMCP_CHAR                      (1 << 0) /* Char.Vitals, Char.Status */
+#define GMCP_ROOM                      (1 << 1) /* Room.Info */
+#define GMCP_COMM                      (1 << 2) /* Comm.Channel */
+#define GMCP_ALL                       (GMCP_CHAR | GMCP_ROOM | GMCP_COMM)
+
 #define UNICODE_MALE                   9794
 #define UNICODE_FEMALE                 9792
 #define UNICODE_NEUTER                 9791
@@ -205,6 +211,8 @@ typedef struct
    bool_t    bCHARSET;         /* The client supports CHARSET */
    bool_t    bMSDP;            /* The client supports MSDP */
    bool_t    bATCP;            /* The client supports ATCP */
+   bool_t    bGMCP;            /* The client supports GMCP */
+   int       GMCPSupports;     /* The GMCP_ modules the client asked for */
    bool_t    bMSP;             /* The client supports MSP */
    bool_t    bMXP;             /* The client supports MXP */
    bool_t    bMCCP;            /* The client supports MCCP */
@@ -356,6 +364,10 @@ void CopyoverSet( descriptor_t *apDescriptor, const char *apData );
  * Call this regularly (I'd suggest at least once per second) to flush every 
  * dirty MSDP variable that has been requested by the client via REPORT.  This 
  * will automatically use ATCP instead if MSDP is not supported by the client.
+ *
+ * The MSDP variables go out together in a single subnegotiation.  A GMCP 
+ * client is sent every package that has a dirty variable in it, all in one 
+ * write.
  */
 void MSDPUpdate( descriptor_t *apDescriptor );
 
@@ -434,6 +446,18 @@ void MSDPSetTable( descriptor_t *apDescriptor, variable_t aMSDP, const char *apV
  */
 void MSDPSetArray( descriptor_t *apDescriptor, variable_t aMSDP, const char *apValue );
 
+/******************************************************************************
+ GMCP functions.
+ ******************************************************************************/
+
+/* Function: GMCPSendChannel
+ *
+ * Sends a Comm.Channel.Text message, if the client supports GMCP and asked 
+ * for the Comm module.  The text is what the player saw; colour codes and 
+ * the trailing newline are left out.
+ */
+void GMCPSendChannel( descriptor_t *apDescriptor, const char *apChannel, const char *apTalker, const char *apText );
+
 /******************************************************************************
  MSSP functions.
  ******************************************************************************/
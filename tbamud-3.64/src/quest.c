@@ -61,24 +61,63 @@ static const char *quest_imm_usage =
 /* Utility Functions                                                        */
 /*--------------------------------------------------------------------------*/
 
+/* The quest table is kept sorted by vnum, both at boot and by add_quest(),
+ * so it can be searched the same way as the mob and object tables. */
 qst_rnum real_quest(qst_vnum vnum)
 {
-  int rnum;
+  int bot, top, mid;
 
-  for (rnum = 0; rnum < total_quests; rnum++)
-    if (QST_NUM(rnum) == vnum)
-      return(rnum);
-  return(NOTHING);
+  bot = 0;
+  top = total_quests - 1;
+
+  /* quickly reject out-of-range vnums */
+  if (top < 0 || QST_NUM(bot) > vnum || QST_NUM(top) < vnum)
+    return (NOTHING);
+
+  /* perform binary search on quest-table */
+  while (bot <= top) {
+    mid = (bot + top) / 2;
+
+    if (QST_NUM(mid) == vnum)
+      return (mid);
+    if (QST_NUM(mid) > vnum)
+      top = mid - 1;
+    else
+      bot = mid + 1;
+  }
+  return (NOTHING);
+}
+
+/* Finds where vnum is, or would go, in the character's completed quests,
+ * which are kept in vnum order. */
+static int find_completed_quest(struct char_data *ch, qst_vnum vnum)
+{
+  qst_vnum *done = ch->player_specials->saved.completed_quests;
+  int bot = 0, top = GET_NUM_QUESTS(ch) - 1, mid;
+
+  while (bot <= top) {
+    mid = (bot + top) / 2;
+
+    if (done[mid] == vnum)
+      return (mid);
+    if (done[mid] > vnum)
+      top = mid - 1;
+    else
+      bot = mid + 1;
+  }
+  return (bot);
 }
 
 int is_complete(struct char_data *ch, qst_vnum vnum)
 {
   int i;
 
-  for (i = 0; i < GET_NUM_QUESTS(ch); i++)
-    if (ch->player_specials->saved.completed_quests[i] == vnum)
-      return TRUE;
-  return FALSE;
+  if (IS_NPC(ch) || GET_NUM_QUESTS(ch) <= 0)
+    return FALSE;
+
+  i = find_completed_quest(ch, vnum);
+  return (i < GET_NUM_QUESTS(ch) &&
+          ch->player_specials->saved.completed_quests[i] == vnum);
 }
 
 qst_vnum find_quest_by_qmnum(struct char_data *ch, mob_vnum qm, int num)
@@ -257,36 +296,36 @@ void clear_quest(struct char_data *ch)
 
 void add_completed_quest(struct char_data *ch, qst_vnum vnum)
 {
-  qst_vnum *temp;
+  qst_vnum *done;
   int i;
 
-  CREATE(temp, qst_vnum, GET_NUM_QUESTS(ch) +1);
-  for (i=0; i < GET_NUM_QUESTS(ch); i++)
-    temp[i] = ch->player_specials->saved.completed_quests[i];
+  i = find_completed_quest(ch, vnum);
+  done = ch->player_specials->saved.completed_quests;
+  if (i < GET_NUM_QUESTS(ch) && done[i] == vnum)
+    return;
+
+  if (done)
+    RECREATE(done, qst_vnum, GET_NUM_QUESTS(ch) + 1);
+  else
+    CREATE(done, qst_vnum, 1);
 
-  temp[GET_NUM_QUESTS(ch)] = vnum;
+  memmove(done + i + 1, done + i, (GET_NUM_QUESTS(ch) - i) * sizeof(qst_vnum));
+  done[i] = vnum;
   GET_NUM_QUESTS(ch)++;
-
-  if (ch->player_specials->saved.completed_quests)
-    free(ch->player_specials->saved.completed_quests);
-  ch->player_specials->saved.completed_quests = temp;
+  ch->player_specials->saved.completed_quests = done;
 }
 
 void remove_completed_quest(struct char_data *ch, qst_vnum vnum)
 {
-  qst_vnum *temp;
-  int i, j = 0;
+  qst_vnum *done = ch->player_specials->saved.completed_quests;
+  int i;
 
-  CREATE(temp, qst_vnum, GET_NUM_QUESTS(ch));
-  for (i = 0; i < GET_NUM_QUESTS(ch); i++)
-    if (ch->player_specials->saved.completed_quests[i] != vnum)
-      temp[j++] = ch->player_specials->saved.completed_quests[i];
+  i = find_completed_quest(ch, vnum);
+  if (i >= GET_NUM_QUESTS(ch) || done[i] != vnum)
+    return;
 
   GET_NUM_QUESTS(ch)--;
-
-  if (ch->player_specials->saved.completed_quests)
-    free(ch->player_specials->saved.completed_quests);
-  ch->player_specials->saved.completed_quests = temp;
+  memmove(done + i, done + i + 1, (GET_NUM_QUESTS(ch) - i) * sizeof(qst_vnum));
 }
 
 void generic_complete_quest(struct char_data *ch)
@@ -390,10 +429,13 @@ void autoquest_trigger_check(struct char_data *ch, struct char_data *vict,
         generic_complete_quest(ch);
       break;
     case AQ_MOB_FIND:
+      /* One sighting per visit; going on would reward a finished quest again. */
       for (i=world[IN_ROOM(ch)].people; i; i = i->next_in_room)
         if (IS_NPC(i))
-          if (QST_TARGET(rnum) == GET_MOB_VNUM(i))
+          if (QST_TARGET(rnum) == GET_MOB_VNUM(i)) {
             generic_complete_quest(ch);
+            break;
+          }
       break;
     case AQ_MOB_KILL:
       if (!IS_NPC(ch) && IS_NPC(vict) && (ch != vict))
@@ -1251,6 +1251,7 @@ void assign_the_shopkeepers(void)
 
     if (SHOP_KEEPER(cindex) > top_of_mobt) {
     	log ("shop %d had mob out of bounds", cindex);
+    	flush_log(TRUE);
     	abort();
     }
 
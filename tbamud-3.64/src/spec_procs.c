@@ -47,6 +47,8 @@ struct spec_mob_action {
   /* this is just for reference */
   const char *name;
   SPECIAL(*func);
+  /* pulses between combat actions, only used by mob_class_action[] */
+  int combat_pulses;
 };
 
 struct spec_mob_skill {
@@ -64,18 +66,18 @@ struct curative_spells {
  * List of class specific mob behavior.
  */
 struct spec_mob_action mob_class_action[NUM_CLASSES] = {
-    { "Magic User",       spec_None   },
-    { "Cleric",           spec_Cleric },
-    { "Thief",            spec_Thief  },
-    { "Warrior",          spec_None   },
-    { "Ranger",           spec_None   },
-    { "Assassin",         spec_None   },
-    { "Shou-lin",         spec_None   },
-    { "Solamnic Knight",  spec_None   },
-    { "Death Knight",     spec_None   },
-    { "Shadow Dance",     spec_None   },
-    { "Necromancer",      spec_None   },
-    { "Druid",            spec_None   },
+    { "Magic User",       spec_None,   1 },
+    { "Cleric",           spec_Cleric, 1 },
+    { "Thief",            spec_Thief,  1 },
+    { "Warrior",          spec_None,   1 },
+    { "Ranger",           spec_None,   1 },
+    { "Assassin",         spec_None,   1 },
+    { "Shou-lin",         spec_None,   1 },
+    { "Solamnic Knight",  spec_None,   1 },
+    { "Death Knight",     spec_None,   1 },
+    { "Shadow Dance",     spec_None,   1 },
+    { "Necromancer",      spec_None,   1 },
+    { "Druid",            spec_None,   1 },
 };
 
 struct spec_mob_action mob_race_action[NUM_RACES] = {
@@ -941,6 +943,13 @@ void mobCombatAction(struct char_data *mob) {
   }
 }
 
+/*
+ * How often, in pulses, the mob gets a chance at a combat action.
+ */
+int mobCombatCadence(struct char_data *mob) {
+  return mob_class_action[(int)GET_CLASS(mob)].combat_pulses;
+}
+
 /*
  *
  */
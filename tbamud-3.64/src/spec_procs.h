@@ -57,6 +57,7 @@ SPECIAL(spec_OffensiveAction);
 SPECIAL(spec_Orc);
 
 void mobCombatAction(struct char_data *mob);
+int mobCombatCadence(struct char_data *mob);
 void mobNormalAction(struct char_data *mob);
 
 #endif /* _SPEC_PROCS_H_ */
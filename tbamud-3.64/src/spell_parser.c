@@ -36,6 +36,33 @@ static void spello(int spl, const char *name, int max_mana, int min_mana, int ma
 static int mag_manacost(struct char_data *ch, int spellnum);
 
 /* Local (File Scope) Variables */
+
+/* Spell and skill names, indexed for find_skill_num(). The first word of
+ * each name goes into a trie, and every node lists, lowest number first, the
+ * spells whose first word starts with the letters on the way down to it. The
+ * words after the first are then checked against those spells in turn. */
+#define MAX_SKILL_WORDS 8
+
+struct skill_trie {
+  char letter;
+  struct skill_trie *child, *next;
+  int *spells;
+  int num_spells;
+};
+
+struct skill_words {
+  int count;
+  const char *word[MAX_SKILL_WORDS];
+  int len[MAX_SKILL_WORDS];
+};
+
+static struct skill_trie *skill_trie = NULL;
+static struct skill_words skill_words[TOP_SPELL_DEFINE + 1];
+static bool skill_index_built = FALSE;
+
+static void free_skill_trie(struct skill_trie *node);
+static void build_skill_index(void);
+
 struct syllable {
   const char *org;
   const char *news;
@@ -89,6 +116,7 @@ static void say_spell(struct char_data *ch, int spellnum, struct char_data *tch,
 {
   char lbuf[256], buf[256], buf1[256], buf2[256];	/* FIXME */
   const char *format;
+  struct act_variants same, other;
 
   struct char_data *i;
   int j, ofs = 0;
@@ -124,15 +152,19 @@ static void say_spell(struct char_data *ch, int spellnum, struct char_data *tch,
 
   snprintf(buf1, sizeof(buf1), format, skill_name(spellnum));
   snprintf(buf2, sizeof(buf2), format, buf);
+  act_variants_init(&same, buf1);
+  act_variants_init(&other, buf2);
 
   for (i = world[IN_ROOM(ch)].people; i; i = i->next_in_room) {
     if (i == ch || i == tch || !i->desc || !AWAKE(i))
       continue;
     if (GET_CLASS(ch) == GET_CLASS(i))
-      perform_act(buf1, ch, tobj, tch, i);
+      act_variant_send(&same, ch, tobj, tch, i);
     else
-      perform_act(buf2, ch, tobj, tch, i);
+      act_variant_send(&other, ch, tobj, tch, i);
   }
+  act_variants_free(&same);
+  act_variants_free(&other);
 
   if (tch != NULL && tch != ch && IN_ROOM(tch) == IN_ROOM(ch)) {
     snprintf(buf1, sizeof(buf1), "$n stares at you and utters the words, '%s'.",
@@ -154,29 +186,108 @@ const char *skill_name(int num)
     return ("UNDEFINED");
 }
 
-int find_skill_num(char *name)
+static void free_skill_trie(struct skill_trie *node)
 {
-  int skindex, ok;
-  char *temp, *temp2;
-  char first[256], first2[256], tempbuf[256];
+  struct skill_trie *next;
+
+  for (; node; node = next) {
+    next = node->next;
+    free_skill_trie(node->child);
+    if (node->spells)
+      free(node->spells);
+    free(node);
+  }
+}
+
+static void build_skill_index(void)
+{
+  struct skill_trie **link, *node;
+  struct skill_words *sw;
+  const char *p;
+  int skindex, i;
+
+  free_skill_trie(skill_trie);
+  skill_trie = NULL;
 
   for (skindex = 1; skindex <= TOP_SPELL_DEFINE; skindex++) {
-    if (is_abbrev(name, spell_info[skindex].name))
-      return (skindex);
-
-    ok = TRUE;
-    strlcpy(tempbuf, spell_info[skindex].name, sizeof(tempbuf));	/* strlcpy: OK */
-    temp = any_one_arg(tempbuf, first);
-    temp2 = any_one_arg(name, first2);
-    while (*first && *first2 && ok) {
-      if (!is_abbrev(first2, first))
-	ok = FALSE;
-      temp = any_one_arg(temp, first);
-      temp2 = any_one_arg(temp2, first2);
+    sw = &skill_words[skindex];
+    sw->count = 0;
+
+    for (p = spell_info[skindex].name; p && *p && sw->count < MAX_SKILL_WORDS; ) {
+      while (*p && isspace(*p))
+        p++;
+      if (!*p)
+        break;
+      sw->word[sw->count] = p;
+      while (*p && !isspace(*p))
+        p++;
+      sw->len[sw->count] = p - sw->word[sw->count];
+      sw->count++;
     }
 
-    if (ok && !*first2)
-      return (skindex);
+    if (!sw->count)
+      continue;
+
+    for (link = &skill_trie, i = 0; i < sw->len[0]; i++, link = &node->child) {
+      for (node = *link; node && node->letter != LOWER(sw->word[0][i]); node = node->next)
+        ;
+      if (!node) {
+        CREATE(node, struct skill_trie, 1);
+        node->letter = LOWER(sw->word[0][i]);
+        node->next = *link;
+        *link = node;
+      }
+      RECREATE(node->spells, int, node->num_spells + 1);
+      node->spells[node->num_spells++] = skindex;
+    }
+  }
+
+  skill_index_built = TRUE;
+}
+
+/** Throws away the index of spell and skill names, for it to be built again
+ * from spell_info[] the next time find_skill_num() is called. */
+void skill_names_changed(void)
+{
+  skill_index_built = FALSE;
+}
+
+/** Finds a spell or skill by name. Each word given may be an abbreviation of
+ * the word in the same place in the name, so "mag mis" is magic missile. If
+ * more than one name fits, the lowest numbered one is found.
+ * @param name The name, or abbreviation, to look for.
+ * @retval int The spell or skill number, or -1 if none fits. */
+int find_skill_num(char *name)
+{
+  struct arg_list args;
+  struct skill_trie *node = NULL, *level;
+  struct skill_words *sw;
+  size_t i;
+  int j, k;
+
+  if (!skill_index_built)
+    build_skill_index();
+
+  if (!split_args(name, &args) || *args.rest)
+    return (-1);
+
+  for (level = skill_trie, i = 0; i < args.arg[0].len; i++, level = node->child) {
+    for (node = level; node && node->letter != LOWER(args.arg[0].word[i]); node = node->next)
+      ;
+    if (!node)
+      return (-1);
+  }
+
+  for (k = 0; k < node->num_spells; k++) {
+    sw = &skill_words[node->spells[k]];
+    if (args.count > sw->count)
+      continue;
+    for (j = 1; j < args.count; j++)
+      if (args.arg[j].len > (size_t) sw->len[j] ||
+          strn_cmp(args.arg[j].word, sw->word[j], args.arg[j].len))
+        break;
+    if (j == args.count)
+      return (node->spells[k]);
   }
 
   return (-1);
@@ -993,4 +1104,7 @@ void mag_assign_spells(void)
   skillo(SKILL_WHIRLWIND, "whirlwind");
   skillo(SKILL_SECOND_ATTACK, "second attack");
   skillo(SKILL_THIRD_ATTACK, "third attack");
+
+  /* The names are all in place, so find_skill_num() can index them. */
+  skill_names_changed();
 }
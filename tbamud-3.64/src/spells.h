@@ -234,6 +234,7 @@ ASPELL(spell_detect_poison);
 /* basic magic calling functions */
 
 int find_skill_num(char *name);
+void skill_names_changed(void);
 
 int mag_damage(int level, struct char_data *ch, struct char_data *victim,
   int spellnum, int savetype);
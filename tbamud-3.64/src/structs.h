@@ -855,6 +855,13 @@
 #define SMALL_BUFSIZE      1024        /**< Static output buffer size   */
 /** Max amount of output that can be buffered */
 #define LARGE_BUFSIZE      (MAX_SOCK_BUF - GARBAGE_SPACE - MAX_PROMPT_LENGTH)
+/** Output waiting on a stalled connection before room and channel chatter
+ * is skipped for it. */
+#define OUTPUT_HIGH_WATER  (LARGE_BUFSIZE / 2)
+/** Output waiting below which a connection is caught up again. */
+#define OUTPUT_LOW_WATER   SMALL_BUFSIZE
+/** Seconds a connection may refuse all output before it is dropped. */
+#define OUTPUT_STALL_TIMEOUT 60
 
 #define MAX_STRING_LENGTH     49152  /**< Max length of string, as defined */
 #define MAX_INPUT_LENGTH      512    /**< Max length per *line* of input */
@@ -987,9 +994,14 @@ struct obj_data
 
   struct obj_data *next_content;  /**< For 'contains' lists   */
   struct obj_data *next;          /**< For the object list */
+  struct obj_data *prev;          /**< For the object list */
   struct char_data *sitting_here; /**< For furniture, who is sitting in it */
   
   struct list_data *events;      /**< Used for object events */
+
+  long timer_expire;             /**< Mud hour the timer runs out, 0 if idle */
+  struct obj_data *next_timer;   /**< For the object timer wheel */
+  struct obj_data *prev_timer;   /**< For the object timer wheel */
 };
 
 /** Instance info for an object that gets saved to disk.
@@ -1069,6 +1081,10 @@ struct room_data
   struct char_data *people;   /**< List of NPCs / PCs in room */
   
   struct list_data * events;  
+
+  long mob_trig_types;   /**< Script types of the mobs here (dg_handler.c) */
+  long obj_trig_types;   /**< Script types of the objects here, on the floor or on someone */
+  long trig_types_epoch; /**< When the two above were gathered; stale if not current */
 };
 
 /* char-related structures */
@@ -1150,6 +1166,15 @@ struct char_ability_data
   sbyte cha;     /**< Charisma */
 };
 
+/** Running totals of everything a character's spell affects and worn
+ * equipment add, kept up to date as affects come and go so that the current
+ * abilities can be worked out without walking every affect again. */
+struct affect_sum_data
+{
+  sh_int apply[NUM_APPLIES];          /**< Summed modifiers, by APPLY_ location */
+  ubyte flags[AF_ARRAY_MAX * 32];     /**< How many sources set each AFF_ flag */
+};
+
 /** Character 'points', or health statistics. */
 struct char_point_data
 {
@@ -1288,6 +1313,7 @@ struct char_data
   struct char_player_data player;       /**< General PC/NPC data */
   struct char_ability_data real_abils;  /**< Abilities without modifiers */
   struct char_ability_data aff_abils;   /**< Abilities with modifiers */
+  struct affect_sum_data aff_sums;      /**< Totals of affect and eq modifiers */
   struct char_point_data points;        /**< Point/statistics */
   struct char_special_data char_specials; /**< PC/NPC specials	  */
   struct player_special_data *player_specials; /**< PC specials		  */
@@ -1326,11 +1352,25 @@ struct txt_block
   struct txt_block *next; /**< ? */
 };
 
-/** ? */
+/** One line of player input waiting to be run. Lines come from a shared pool
+ * in comm.c and go back to it once read. */
+struct txt_line
+{
+  char text[MAX_INPUT_LENGTH]; /**< The command itself */
+  int aliased;                 /**< TRUE if this line came from an alias */
+  struct txt_line *next;       /**< Next free line, while in the pool */
+};
+
+/** Most lines a single input queue can hold, aliases included. */
+#define INPUT_Q_SLOTS 512
+
+/** A descriptor's input queue: a fixed ring of lines taken from the pool. */
 struct txt_q
 {
-  struct txt_block *head; /**< ? */
-  struct txt_block *tail; /**< ? */
+  struct txt_line *line[INPUT_Q_SLOTS]; /**< The ring of queued lines */
+  int first;                            /**< Slot of the next line to run */
+  int count;                            /**< Number of lines queued */
+  int peak;                             /**< Most lines ever queued at once */
 };
 
 /** Master structure players. Holds the real players connection to the mud.
@@ -1340,13 +1380,17 @@ struct descriptor_data
 {
   socket_t descriptor;      /**< file descriptor for socket */
   char host[HOST_LENGTH+1]; /**< hostname */
+  unsigned long host_addr;  /**< numeric peer address, host order, or 0	*/
   byte bad_pws;             /**< number of bad pw attemps this login */
   byte idle_tics;           /**< tics idle at password prompt		*/
   int connected;            /**< mode of 'connectedness'		*/
   int desc_num;             /**< unique num assigned to desc		*/
   time_t login_time;        /**< when the person connected		*/
   char *showstr_head;       /**< for keeping track of an internal str	*/
-  char **showstr_vector;    /**< for paging through texts		*/
+  const char *showstr_text; /**< the text being paged through		*/
+  int *showstr_lines;       /**< where each screen line starts in it	*/
+  int showstr_nlines;       /**< number of screen lines in the text	*/
+  int showstr_top;          /**< first line of the page on screen	*/
   int showstr_count;        /**< number of pages to page through	*/
   int showstr_page;         /**< which page are we currently showing?	*/
   char **str;               /**< for the modify-str system		*/
@@ -1362,6 +1406,8 @@ struct descriptor_data
   int history_pos;          /**< Circular array position.		*/
   int bufptr;               /**< ptr to end of current output		*/
   int bufspace;             /**< space left in the output buffer	*/
+  int out_sent;             /**< bytes at the start of output already sent */
+  int flushing;             /**< end of the flush being sent, or 0	*/
   struct txt_block *large_outbuf; /**< ptr to large buffer, if we need it */
   struct txt_q input;       /**< q of unprocessed input		*/
   struct char_data *character; /**< linked to char			*/
@@ -1371,6 +1417,13 @@ struct descriptor_data
   struct descriptor_data *next;     /**< link to next descriptor		*/
   struct oasis_olc_data *olc;       /**< OLC info */
   protocol_t *pProtocol;    /**< Kavir plugin */
+  bool msdp_pending;        /**< MSDP variables to refresh this pulse */
+  time_t out_stalled;       /**< when waiting output last moved, or 0	*/
+  bool out_behind;          /**< skipping chatter until output drains	*/
+  int out_skipped;          /**< chatter skipped since falling behind	*/
+  int out_skipped_total;    /**< chatter skipped this connection		*/
+  int out_behind_count;     /**< times fallen behind this connection	*/
+  long out_bytes;           /**< bytes sent this connection		*/
   
   struct list_data * events;
 };
@@ -1520,6 +1573,7 @@ struct index_data
 
   char *farg; /**< String argument for special function. */
   struct trig_data *proto; /**< Points to the trigger prototype. */
+  long fired; /**< Times copies of this trigger have been started. */
 };
 
 /** Master linked list for the mob/object prototype trigger lists. */
@@ -1624,6 +1678,8 @@ struct game_operation
   int max_playing; /**< Maximum number of players allowed. */
   int max_filesize; /**< Maximum size of misc files.   */
   int max_bad_pws; /**< Maximum number of pword attempts.  */
+  int max_input_queue; /**< Commands queued before a flood disconnect. */
+  int binary_pfiles; /**< Save player files in the binary format ? */
   int siteok_everyone; /**< Everyone from all sites are SITEOK.*/
   int nameserver_is_slow; /**< Is the nameserver slow or fast?   */
   int use_new_socials; /**< Use new or old socials file ?      */
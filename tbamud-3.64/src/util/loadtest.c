@@ -0,0 +1,514 @@
+/* ************************************************************************
+*  file: loadtest.c                                        Part of tbaMUD *
+*  Usage: Drive a running server with scripted players and report the     *
+*         round-trip latency of their commands.                           *
+*         loadtest [options] <name prefix>                                *
+*  All rights reserved.  See license for complete information.            *
+************************************************************************* */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#define MAX_CLIENTS     1000
+#define CLIENT_BUFSIZE  8192
+#define NAME_LENGTH     20      /* MAX_NAME_LENGTH in structs.h */
+#define REPLY_TIMEOUT   10.0    /* seconds to wait for a prompt */
+#define LOGIN_TIMEOUT   60.0    /* seconds to get into the game */
+#define NUM_KINDS       6
+
+/* What a client is doing. */
+#define CL_LOGIN    0   /* answering the nanny() prompts */
+#define CL_THINK    1   /* in the game, waiting to send its next command */
+#define CL_WAIT     2   /* command sent, waiting for the prompt */
+#define CL_DEAD     3   /* connection lost */
+
+/* Kinds of command; KIND_LOGIN times connect to first prompt. */
+#define KIND_LOGIN   0
+#define KIND_MOVE    1
+#define KIND_LOOK    2
+#define KIND_COMBAT  3
+#define KIND_SAY     4
+#define KIND_WHO     5
+
+struct client {
+  int fd;
+  char name[NAME_LENGTH + 1];
+  int state;
+  int kind;              /* kind of the outstanding command */
+  double sent;           /* when it went out */
+  double next;           /* when to send the next one */
+  char buf[CLIENT_BUFSIZE];
+  size_t len;
+};
+
+struct samples {
+  double *val;
+  int num, max;
+  int timeouts;
+};
+
+static const char *kind_names[NUM_KINDS] = {
+  "login", "move", "look", "combat", "say", "who"
+};
+
+static const char *moves[] = { "north", "east", "south", "west", "up", "down" };
+
+static struct client clients[MAX_CLIENTS];
+static struct samples stats[NUM_KINDS];
+static int weights[NUM_KINDS] = { 0, 40, 20, 10, 20, 10 };
+static char password[32] = "loadtest";
+static char target[64] = "guard";
+static int think_ms = 1000;
+
+/* Wall clock in seconds. */
+static double now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (tv.tv_sec + tv.tv_usec / 1000000.0);
+}
+
+/* Server CPU seconds used so far, read from /proc; -1 if unavailable. */
+static double server_cpu(int pid)
+{
+  char path[64], buf[1024], *p;
+  unsigned long utime, stime;
+  FILE *fl;
+
+  if (pid <= 0)
+    return (-1);
+
+  snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+  if (!(fl = fopen(path, "r")))
+    return (-1);
+  if (!fgets(buf, sizeof(buf), fl)) {
+    fclose(fl);
+    return (-1);
+  }
+  fclose(fl);
+
+  /* skip "pid (comm) state", comm may contain spaces */
+  if (!(p = strrchr(buf, ')')) ||
+      sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+    return (-1);
+
+  return ((double) (utime + stime) / sysconf(_SC_CLK_TCK));
+}
+
+static void add_sample(int kind, double val)
+{
+  struct samples *s = &stats[kind];
+
+  if (s->num == s->max) {
+    s->max = s->max ? s->max * 2 : 256;
+    if (!(s->val = (double *) realloc(s->val, s->max * sizeof(double)))) {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  s->val[s->num++] = val;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return (x < y ? -1 : x > y);
+}
+
+static double percentile(struct samples *s, int pct)
+{
+  int i = (s->num * pct + 99) / 100 - 1;
+
+  return (s->val[i < 0 ? 0 : i] * 1000.0);
+}
+
+static void send_line(struct client *cl, const char *line)
+{
+  char out[256];
+  int len;
+
+  len = snprintf(out, sizeof(out), "%s\r\n", line);
+  if (write(cl->fd, out, len) != len) {
+    close(cl->fd);
+    cl->state = CL_DEAD;
+  }
+  cl->len = 0;
+  *cl->buf = '\0';
+}
+
+/* Names may only hold letters, so number the clients in base 26. */
+static void make_name(char *name, const char *prefix, int num)
+{
+  char suffix[8];
+  int i = sizeof(suffix) - 1;
+
+  suffix[i] = '\0';
+  do {
+    suffix[--i] = 'a' + num % 26;
+    num /= 26;
+  } while (num && i > 0);
+
+  snprintf(name, NAME_LENGTH + 1, "%s%s", prefix, suffix + i);
+}
+
+static int connect_client(struct client *cl, struct sockaddr_in *sa)
+{
+  if ((cl->fd = socket(PF_INET, SOCK_STREAM, 0)) < 0) {
+    perror("socket");
+    return (0);
+  }
+  if (connect(cl->fd, (struct sockaddr *) sa, sizeof(*sa)) < 0) {
+    perror("connect");
+    close(cl->fd);
+    return (0);
+  }
+  cl->state = CL_LOGIN;
+  cl->kind = KIND_LOGIN;
+  cl->sent = now();
+  cl->len = 0;
+  *cl->buf = '\0';
+  return (1);
+}
+
+/* Strips telnet negotiation out of freshly read data, in place. */
+static size_t strip_telnet(char *buf, size_t len)
+{
+  size_t i, j;
+
+  for (i = j = 0; i < len; i++) {
+    if ((unsigned char) buf[i] != 255) {
+      buf[j++] = buf[i];
+      continue;
+    }
+    if (i + 1 >= len)
+      break;
+    if ((unsigned char) buf[i + 1] == 250) {          /* IAC SB ... IAC SE */
+      for (i += 2; i + 1 < len && !((unsigned char) buf[i] == 255 && (unsigned char) buf[i + 1] == 240); i++)
+        ;
+      i++;
+    } else if ((unsigned char) buf[i + 1] >= 251)      /* IAC WILL/WONT/DO/DONT x */
+      i += 2;
+    else                                               /* IAC x */
+      i++;
+  }
+  return (j);
+}
+
+/* Answers whatever the login sequence is asking. Returns 1 once the
+ * client is standing in the game. */
+static int answer_login(struct client *cl)
+{
+  static const struct {
+    const char *prompt;
+    const char *answer;   /* NULL: the name, "": the password */
+  } steps[] = {
+    { "By what name"          , NULL },
+    { "Did I get that right"  , "y"  },
+    { "Give me a password"    , ""   },
+    { "retype password"       , ""   },
+    { "Password:"             , ""   },
+    { "What is your sex"      , "m"  },
+    { "Race:"                 , "h"  },
+    { "Class:"                , "w"  },
+    { "PRESS RETURN"          , "-"  },
+    { "Make your choice"      , "1"  },
+    { NULL, NULL }
+  };
+  int i;
+
+  if (strstr(cl->buf, "Wrong password") || strstr(cl->buf, "Invalid name") ||
+      strstr(cl->buf, "Sorry,")) {
+    fprintf(stderr, "%s: login refused: %s\n", cl->name, cl->buf);
+    close(cl->fd);
+    cl->state = CL_DEAD;
+    return (0);
+  }
+
+  for (i = 0; steps[i].prompt; i++)
+    if (strstr(cl->buf, steps[i].prompt)) {
+      if (!steps[i].answer)
+        send_line(cl, cl->name);
+      else if (!*steps[i].answer)
+        send_line(cl, password);
+      else if (*steps[i].answer == '-')
+        send_line(cl, "");
+      else
+        send_line(cl, steps[i].answer);
+      return (0);
+    }
+
+  /* Anything ending in the game prompt means we're in. */
+  return (cl->len >= 2 && !strcmp(cl->buf + cl->len - 2, "> "));
+}
+
+static int pick_kind(void)
+{
+  int total = 0, i, r;
+
+  for (i = 1; i < NUM_KINDS; i++)
+    total += weights[i];
+  r = rand() % total;
+  for (i = 1; i < NUM_KINDS - 1; i++)
+    if ((r -= weights[i]) < 0)
+      break;
+  return (i);
+}
+
+static void send_command(struct client *cl)
+{
+  char cmd[128];
+
+  cl->kind = pick_kind();
+  switch (cl->kind) {
+  case KIND_MOVE:
+    strcpy(cmd, moves[rand() % 6]);
+    break;
+  case KIND_LOOK:
+    strcpy(cmd, "look");
+    break;
+  case KIND_COMBAT:
+    snprintf(cmd, sizeof(cmd), "kill %s", target);
+    break;
+  case KIND_SAY:
+    strcpy(cmd, "say The quick brown fox jumps over the lazy dog.");
+    break;
+  default:
+    strcpy(cmd, "who");
+    break;
+  }
+  cl->sent = now();
+  cl->state = CL_WAIT;
+  send_line(cl, cmd);
+}
+
+static void read_client(struct client *cl)
+{
+  int n;
+
+  n = read(cl->fd, cl->buf + cl->len, CLIENT_BUFSIZE - 1 - cl->len);
+  if (n <= 0) {
+    fprintf(stderr, "%s: connection closed\n", cl->name);
+    close(cl->fd);
+    cl->state = CL_DEAD;
+    return;
+  }
+  cl->len += strip_telnet(cl->buf + cl->len, n);
+  cl->buf[cl->len] = '\0';
+
+  switch (cl->state) {
+  case CL_LOGIN:
+    if (answer_login(cl)) {
+      add_sample(KIND_LOGIN, now() - cl->sent);
+      cl->state = CL_THINK;
+      cl->next = now() + (rand() % (think_ms + 1)) / 1000.0;
+    }
+    break;
+  case CL_WAIT:
+    if (cl->len >= 2 && !strcmp(cl->buf + cl->len - 2, "> ")) {
+      add_sample(cl->kind, now() - cl->sent);
+      cl->state = CL_THINK;
+      cl->next = now() + (think_ms / 2 + rand() % (think_ms + 1)) / 1000.0;
+    }
+    break;
+  }
+
+  /* Keep only the tail; all we look for is near the end. */
+  if (cl->len > CLIENT_BUFSIZE / 2) {
+    memmove(cl->buf, cl->buf + cl->len - 256, 256);
+    cl->len = 256;
+    cl->buf[cl->len] = '\0';
+  }
+}
+
+static void set_weights(char *mix)
+{
+  char *tok, *eq;
+  int i;
+
+  for (i = 1; i < NUM_KINDS; i++)
+    weights[i] = 0;
+
+  for (tok = strtok(mix, ","); tok; tok = strtok(NULL, ",")) {
+    if (!(eq = strchr(tok, '=')))
+      break;
+    *eq = '\0';
+    for (i = 1; i < NUM_KINDS; i++)
+      if (!strcmp(tok, kind_names[i]))
+        break;
+    if (i == NUM_KINDS)
+      break;
+    weights[i] = atoi(eq + 1);
+  }
+  if (tok) {
+    fprintf(stderr, "Bad command mix near '%s'.\n", tok);
+    exit(1);
+  }
+  for (i = 1; i < NUM_KINDS && weights[i] <= 0; i++)
+    ;
+  if (i == NUM_KINDS) {
+    fprintf(stderr, "The command mix is empty.\n");
+    exit(1);
+  }
+}
+
+static void usage(void)
+{
+  fprintf(stderr,
+    "Usage: loadtest [-h host] [-p port] [-n clients] [-t seconds] [-w think_ms]\n"
+    "                [-m kind=weight,...] [-k target] [-s password] [-P server_pid]\n"
+    "                <name prefix>\n"
+    "Kinds are move, look, combat, say and who; the default mix is\n"
+    "move=40,look=20,combat=10,say=20,who=10.\n");
+  exit(1);
+}
+
+int main(int argc, char **argv)
+{
+  struct sockaddr_in sa;
+  struct hostent *he;
+  struct timeval tv;
+  fd_set input;
+  char *host = "127.0.0.1", *prefix;
+  int port = 4000, num = 10, seconds = 60, pid = 0;
+  int i, maxfd, alive, opt, server_gone = 0;
+  double start, end, cpu_start, cpu_end, cpu, next_cpu = 0, t;
+
+  while ((opt = getopt(argc, argv, "h:p:n:t:w:m:k:s:P:")) != -1)
+    switch (opt) {
+    case 'h': host = optarg; break;
+    case 'p': port = atoi(optarg); break;
+    case 'n': num = atoi(optarg); break;
+    case 't': seconds = atoi(optarg); break;
+    case 'w': think_ms = atoi(optarg); break;
+    case 'm': set_weights(optarg); break;
+    case 'k': snprintf(target, sizeof(target), "%s", optarg); break;
+    case 's': snprintf(password, sizeof(password), "%s", optarg); break;
+    case 'P': pid = atoi(optarg); break;
+    default: usage();
+    }
+  if (optind != argc - 1 || num < 1 || num > MAX_CLIENTS || think_ms < 0 || seconds < 1)
+    usage();
+  prefix = argv[optind];
+  if (strlen(prefix) > NAME_LENGTH - 3) {
+    fprintf(stderr, "The name prefix may be at most %d letters.\n", NAME_LENGTH - 3);
+    exit(1);
+  }
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  if ((sa.sin_addr.s_addr = inet_addr(host)) == INADDR_NONE) {
+    if (!(he = gethostbyname(host))) {
+      fprintf(stderr, "Unknown host '%s'.\n", host);
+      exit(1);
+    }
+    memcpy(&sa.sin_addr, he->h_addr, sizeof(sa.sin_addr));
+  }
+
+  srand(getpid());
+  cpu_start = cpu_end = server_cpu(pid);
+  start = now();
+  end = start + seconds;
+
+  for (i = 0; i < num; i++) {
+    make_name(clients[i].name, prefix, i);
+    if (!connect_client(&clients[i], &sa))
+      clients[i].state = CL_DEAD;
+  }
+
+  while ((t = now()) < end) {
+    /* Sample as we go so a server that dies still gets its CPU reported. */
+    if (t >= next_cpu) {
+      if ((cpu = server_cpu(pid)) >= 0)
+        cpu_end = cpu;
+      else if (cpu_start >= 0 && !server_gone) {
+        fprintf(stderr, "Server process %d has gone away.\n", pid);
+        server_gone = 1;
+      }
+      next_cpu = t + 1.0;
+    }
+
+    FD_ZERO(&input);
+    maxfd = -1;
+    alive = 0;
+    for (i = 0; i < num; i++) {
+      struct client *cl = &clients[i];
+
+      if (cl->state == CL_DEAD)
+        continue;
+      if (cl->state == CL_THINK && t >= cl->next)
+        send_command(cl);
+      else if (cl->state != CL_THINK &&
+               t - cl->sent > (cl->state == CL_LOGIN ? LOGIN_TIMEOUT : REPLY_TIMEOUT)) {
+        stats[cl->kind].timeouts++;
+        if (cl->state == CL_WAIT) {
+          cl->state = CL_THINK;
+          cl->next = t;
+        } else {
+          fprintf(stderr, "%s: stuck logging in, giving up\n", cl->name);
+          close(cl->fd);
+          cl->state = CL_DEAD;
+          continue;
+        }
+      }
+      if (cl->state == CL_DEAD)
+        continue;
+      FD_SET(cl->fd, &input);
+      if (cl->fd > maxfd)
+        maxfd = cl->fd;
+      alive++;
+    }
+    if (!alive) {
+      fprintf(stderr, "No connections left.\n");
+      break;
+    }
+
+    tv.tv_sec = 0;
+    tv.tv_usec = 10000;
+    if (select(maxfd + 1, &input, NULL, NULL, &tv) < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("select");
+      exit(1);
+    }
+    for (i = 0; i < num; i++)
+      if (clients[i].state != CL_DEAD && FD_ISSET(clients[i].fd, &input))
+        read_client(&clients[i]);
+  }
+
+  t = now() - start;
+  if ((cpu = server_cpu(pid)) >= 0)
+    cpu_end = cpu;
+
+  for (alive = 0, i = 0; i < num; i++)
+    if (clients[i].state != CL_DEAD) {
+      send_line(&clients[i], "quit");
+      close(clients[i].fd);
+      alive++;
+    }
+
+  printf("%d of %d clients connected at the end of a %.1f second run.\n\n", alive, num, t);
+  printf("%-8s %8s %8s %8s %8s %8s %8s\n", "command", "count", "p50 ms", "p90 ms", "p99 ms", "max ms", "timeouts");
+  for (i = 0; i < NUM_KINDS; i++) {
+    struct samples *s = &stats[i];
+
+    if (!s->num) {
+      if (s->timeouts)
+        printf("%-8s %8d %8s %8s %8s %8s %8d\n", kind_names[i], 0, "-", "-", "-", "-", s->timeouts);
+      continue;
+    }
+    qsort(s->val, s->num, sizeof(double), compare_double);
+    printf("%-8s %8d %8.1f %8.1f %8.1f %8.1f %8d\n", kind_names[i], s->num,
+      percentile(s, 50), percentile(s, 90), percentile(s, 99), percentile(s, 100), s->timeouts);
+  }
+
+  if (cpu_start >= 0 && cpu_end >= 0)
+    printf("\nServer CPU: %.2f seconds, %.1f%% of one core.\n", cpu_end - cpu_start,
+      100.0 * (cpu_end - cpu_start) / t);
+  else if (pid)
+    printf("\nServer CPU: unavailable for pid %d.\n", pid);
+
+  return (0);
+}
@@ -0,0 +1,536 @@
+/* ************************************************************************
+*  file:  plrtobin.c                                       Part of tbaMUD *
+*  Usage: Convert ASCII player files to the binary format and back.       *
+*  Copyright (C) 1990, 1991 - see 'license.doc' for complete information. *
+*  All Rights Reserved                                                    *
+************************************************************************* */
+
+/* The game reads either format, preferring the binary file if a player has
+ * both, and writes whichever the binary_pfiles setting asks for. This lets an
+ * existing player base be converted in one go instead of as players log in:
+ *
+ *   for f in `find lib/plrfiles -name '*.plr'`; do
+ *     bin/plrtobin $f ${f%.plr}.plb && rm $f
+ *   done
+ *
+ * and, with -a, converted back to ASCII for hand editing. */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "utils.h"
+#include "pfdefaults.h"
+#include "pfbinary.h"
+
+#define READ_SIZE 256
+
+static void tag_argument(char *argument, char *tag);
+static long asciiflag_conv(char *flag);
+static int sprintascii(char *out, long bits);
+static char *read_tilde_string(FILE *fl);
+static void read_flags(struct pfile_image *img, int first, char *line);
+static int read_ascii(const char *filename, struct pfile_image *img);
+static int write_ascii(const char *filename, struct pfile_image *img);
+
+int main(int argc, char **argv)
+{
+  struct pfile_image img;
+  int err, to_ascii = FALSE;
+
+  if (argc == 4 && !strcmp(argv[1], "-a")) {
+    to_ascii = TRUE;
+    argv++;
+    argc--;
+  }
+  if (argc != 3) {
+    printf("Usage: %s [-a] infile outfile\n"
+           "Converts an ASCII player file (.plr) to the binary format (.plb),\n"
+           "or with -a a binary player file back to ASCII.\n", argv[0]);
+    return 1;
+  }
+
+  if (to_ascii) {
+    if ((err = pfb_read(argv[1], &img)) != PFB_OK) {
+      fprintf(stderr, "%s: %s\n", argv[1], pfb_strerror(err));
+      return 1;
+    }
+    if (!write_ascii(argv[2], &img)) {
+      perror(argv[2]);
+      pfb_free_image(&img);
+      return 1;
+    }
+  } else {
+    if (!read_ascii(argv[1], &img)) {
+      perror(argv[1]);
+      return 1;
+    }
+    if ((err = pfb_write(argv[2], &img)) != PFB_OK) {
+      fprintf(stderr, "%s: %s\n", argv[2], pfb_strerror(err));
+      pfb_free_image(&img);
+      return 1;
+    }
+  }
+  pfb_free_image(&img);
+  return 0;
+}
+
+/* The same as get_line() in the game: skips comments and blank lines. */
+int get_line(FILE *fl, char *buf)
+{
+  char temp[READ_SIZE];
+  int lines = 0;
+  int sl;
+
+  do {
+    if (!fgets(temp, READ_SIZE, fl))
+      return (0);
+    lines++;
+  } while (*temp == '*' || *temp == '\n' || *temp == '\r');
+
+  /* Last line of file doesn't always have a \n, but it should. */
+  sl = strlen(temp);
+  while (sl > 0 && (temp[sl - 1] == '\n' || temp[sl - 1] == '\r'))
+    temp[--sl] = '\0';
+
+  strcpy(buf, temp); /* strcpy: OK, if buf >= READ_SIZE (256) */
+  return (lines);
+}
+
+static void tag_argument(char *argument, char *tag)
+{
+  char *tmp = argument, *ttag = tag, *wrt = argument;
+  int i;
+
+  for (i = 0; i < 4 && *tmp; i++)
+    *(ttag++) = *(tmp++);
+  *ttag = '\0';
+
+  while (*tmp == ':' || *tmp == ' ')
+    tmp++;
+
+  while (*tmp)
+    *(wrt++) = *(tmp++);
+  *wrt = '\0';
+}
+
+static long asciiflag_conv(char *flag)
+{
+  long flags = 0;
+  int is_num = TRUE;
+  char *p;
+
+  for (p = flag; *p; p++) {
+    if (islower(*p))
+      flags |= 1 << (*p - 'a');
+    else if (isupper(*p))
+      flags |= 1 << (26 + (*p - 'A'));
+
+    /* Allow the first character to be a minus sign */
+    if (!isdigit(*p) && (*p != '-' || p != flag))
+      is_num = FALSE;
+  }
+
+  if (is_num)
+    flags = atol(flag);
+
+  return (flags);
+}
+
+static int sprintascii(char *out, long bits)
+{
+  int i, j = 0;
+  /* 32 bits, don't just add letters to try to get more unless your bitvector_t is also as large. */
+  char *flags = "abcdefghijklmnopqrstuvwxyzABCDEF";
+
+  for (i = 0; flags[i] != '\0'; i++)
+    if (bits & (1 << i))
+      out[j++] = flags[i];
+
+  if (j == 0) /* Didn't write anything. */
+    out[j++] = '0';
+
+  /* NUL terminate the output string. */
+  out[j++] = '\0';
+  return j;
+}
+
+/* Reads a ~ terminated string as fread_string() in the game does: lines end
+ * in \r\n and @ colour codes become tabs. Returns NULL for an empty string. */
+static char *read_tilde_string(FILE *fl)
+{
+  char buf[MAX_STRING_LENGTH], tmp[513], *point;
+  int done = 0, length = 0, templength;
+
+  *buf = '\0';
+  do {
+    if (!fgets(tmp, 512, fl))
+      break;
+    point = strchr(tmp, '\0');
+    for (point--; point >= tmp && (*point == '\r' || *point == '\n'); point--);
+    if (point >= tmp && *point == '~') {
+      *point = '\0';
+      done = 1;
+    } else {
+      *(++point) = '\r';
+      *(++point) = '\n';
+      *(++point) = '\0';
+    }
+    templength = point - tmp;
+    if (length + templength >= MAX_STRING_LENGTH)
+      break;
+    strcat(buf + length, tmp);	/* strcat: OK (size checked above) */
+    length += templength;
+  } while (!done);
+
+  for (point = buf; *point; point++)
+    if (*point == '@') {
+      if (*(point + 1) != '@')
+        *point = '\t';
+      else
+        point++;
+    }
+
+  return (*buf ? strdup(buf) : NULL);
+}
+
+/* Act, Aff and Pref lines hold four flag words, or one in older files. */
+static void read_flags(struct pfile_image *img, int first, char *line)
+{
+  char f1[128], f2[128], f3[128], f4[128];
+
+  if (sscanf(line, "%s %s %s %s", f1, f2, f3, f4) == 4) {
+    img->field[first] = asciiflag_conv(f1);
+    img->field[first + 1] = asciiflag_conv(f2);
+    img->field[first + 2] = asciiflag_conv(f3);
+    img->field[first + 3] = asciiflag_conv(f4);
+  } else
+    img->field[first] = asciiflag_conv(line);
+}
+
+/* A table of the tags holding a single number, so they need no code each. */
+static const struct {
+  const char *tag;
+  int field;
+} number_tags[] = {
+  { "Ac  ", PFB_AC },           { "Alin", PFB_ALIGNMENT },
+  { "Badp", PFB_BAD_PWS },      { "Bank", PFB_BANK_GOLD },
+  { "Brth", PFB_BIRTH },        { "Cha ", PFB_CHA },
+  { "Clas", PFB_CLASS },        { "Con ", PFB_CON },
+  { "Dex ", PFB_DEX },          { "Drnk", PFB_DRUNK },
+  { "Drol", PFB_DAMROLL },      { "Exp ", PFB_EXP },
+  { "Frez", PFB_FREEZE_LEV },   { "Gold", PFB_GOLD },
+  { "Hite", PFB_HEIGHT },       { "Hrol", PFB_HITROLL },
+  { "Hung", PFB_HUNGER },       { "Id  ", PFB_IDNUM },
+  { "Int ", PFB_INT },          { "Invs", PFB_INVIS_LEV },
+  { "Last", PFB_LOGON },        { "Lern", PFB_PRACTICES },
+  { "Levl", PFB_LEVEL },        { "Lmot", PFB_LAST_MOTD },
+  { "Lnew", PFB_LAST_NEWS },    { "Olc ", PFB_OLC_ZONE },
+  { "Page", PFB_PAGE_LENGTH },  { "Plyd", PFB_PLAYED },
+  { "Qcnt", PFB_QUEST_COUNTER },{ "Qcur", PFB_CURR_QUEST },
+  { "Qpnt", PFB_QUESTPOINTS },  { "Qstp", PFB_QUESTPOINTS },
+  { "Race", PFB_RACE },         { "Room", PFB_LOADROOM },
+  { "ScrW", PFB_SCREEN_WIDTH }, { "Sex ", PFB_SEX },
+  { "SubR", PFB_SUBRACE },      { "Thir", PFB_THIRST },
+  { "Thr1", PFB_SAVE },         { "Thr2", PFB_SAVE_1 },
+  { "Thr3", PFB_SAVE_2 },       { "Thr4", PFB_SAVE_3 },
+  { "Thr5", PFB_SAVE_4 },       { "Wate", PFB_WEIGHT },
+  { "Wimp", PFB_WIMP_LEV },     { "Wis ", PFB_WIS },
+  { NULL, 0 }
+};
+
+/* Tags holding two numbers, as "Hit : 20/20". */
+static const struct {
+  const char *tag;
+  int field;
+} pair_tags[] = {
+  { "Hit ", PFB_HIT }, { "Mana", PFB_MANA }, { "Move", PFB_MOVE },
+  { "Str ", PFB_STR },
+  { NULL, 0 }
+};
+
+/* Tags holding a string on the rest of the line. */
+static const struct {
+  const char *tag;
+  int str;
+} string_tags[] = {
+  { "Name", PFB_NAME }, { "Pass", PFB_PASSWD }, { "Titl", PFB_TITLE },
+  { "PfIn", PFB_POOFIN }, { "PfOt", PFB_POOFOUT }, { "Host", PFB_HOST },
+  { NULL, 0 }
+};
+
+/* Parses an ASCII player file the way load_char() does. */
+static int read_ascii(const char *filename, struct pfile_image *img)
+{
+  struct pfb_affect af;
+  char line[MAX_INPUT_LENGTH + 1], abuf[MAX_INPUT_LENGTH + 1], rbuf[MAX_INPUT_LENGTH + 1];
+  char tbuf[MAX_INPUT_LENGTH + 1], tag[6], *p;
+  int i, n, num, num2, count, n_vars;
+  long num3;
+  FILE *fl;
+
+  pfb_init_image(img);
+
+  if (!(fl = fopen(filename, "r")))
+    return FALSE;
+
+  while (get_line(fl, line)) {
+    tag_argument(line, tag);
+
+    for (i = 0; number_tags[i].tag; i++)
+      if (!strcmp(tag, number_tags[i].tag))
+        break;
+    if (number_tags[i].tag) {
+      img->field[number_tags[i].field] = atol(line);
+      continue;
+    }
+
+    for (i = 0; pair_tags[i].tag; i++)
+      if (!strcmp(tag, pair_tags[i].tag))
+        break;
+    if (pair_tags[i].tag) {
+      num = num2 = 0;
+      sscanf(line, "%d/%d", &num, &num2);
+      img->field[pair_tags[i].field] = num;
+      img->field[pair_tags[i].field + 1] = num2;
+      continue;
+    }
+
+    for (i = 0; string_tags[i].tag; i++)
+      if (!strcmp(tag, string_tags[i].tag))
+        break;
+    if (string_tags[i].tag) {
+      pfb_set_string(img, string_tags[i].str, line);
+      continue;
+    }
+
+    if (!strcmp(tag, "Act "))
+      read_flags(img, PFB_PLR_FLAGS, line);
+    else if (!strcmp(tag, "Aff "))
+      read_flags(img, PFB_AFF_FLAGS, line);
+    else if (!strcmp(tag, "Pref"))
+      read_flags(img, PFB_PRF_FLAGS, line);
+    else if (!strcmp(tag, "Desc")) {
+      if (img->str[PFB_DESC])
+        free(img->str[PFB_DESC]);
+      img->str[PFB_DESC] = read_tilde_string(fl);
+    } else if (!strcmp(tag, "Trig"))
+      pfb_add_trigger(img, atoi(line));
+    else if (!strcmp(tag, "Skil")) {
+      do {
+        num = num2 = 0;
+        if (!get_line(fl, line))
+          break;
+        sscanf(line, "%d %d", &num, &num2);
+        if (num != 0)
+          pfb_add_skill(img, num, num2);
+      } while (num != 0);
+    } else if (!strcmp(tag, "Qest")) {
+      do {
+        num = NOTHING;
+        if (!get_line(fl, line))
+          break;
+        sscanf(line, "%d", &num);
+        if (num != NOTHING)
+          pfb_add_quest(img, num);
+      } while (num != NOTHING);
+    } else if (!strcmp(tag, "Affs")) {
+      do {
+        memset(&af, 0, sizeof(af));
+        if (!get_line(fl, line))
+          break;
+        n_vars = sscanf(line, "%d %d %d %d %d %d %d %d", &af.spell, &af.duration,
+          &af.modifier, &af.location, &af.bitvector[0], &af.bitvector[1],
+          &af.bitvector[2], &af.bitvector[3]);
+        if (af.spell > 0) {
+          /* Old 32-bit files give a single affect bit number. */
+          if (n_vars == 5) {
+            n = af.bitvector[0];
+            af.bitvector[0] = 0;
+            if (n > 0)
+              af.bitvector[n / 32] |= 1 << (n % 32);
+          }
+          pfb_add_affect(img, &af);
+        }
+      } while (af.spell != 0);
+    } else if (!strcmp(tag, "Alis")) {
+      count = atoi(line);
+      for (i = 0; i < count; i++) {
+        get_line(fl, abuf);
+        rbuf[0] = ' ';
+        get_line(fl, rbuf + 1);
+        get_line(fl, tbuf);
+        if (abuf[0] && rbuf[1] && *tbuf)
+          pfb_add_alias(img, abuf[0] == ' ' ? abuf + 1 : abuf,
+                        rbuf[1] == ' ' ? rbuf + 1 : rbuf, atoi(tbuf));
+      }
+    } else if (!strcmp(tag, "Vars")) {
+      count = atoi(line);
+      for (i = 0; i < count; i++) {
+        if (!get_line(fl, line))
+          break;
+        /* name context value, where the value is the rest of the line */
+        if (!(p = strchr(line, ' ')))
+          continue;
+        *p++ = '\0';
+        num3 = strtol(p, &p, 10);
+        while (*p == ' ')
+          p++;
+        pfb_add_var(img, line, num3, p);
+      }
+    }
+  }
+
+  fclose(fl);
+  return TRUE;
+}
+
+/* Writes an ASCII player file the way save_char() does. */
+static int write_ascii(const char *filename, struct pfile_image *img)
+{
+  long long *f = img->field;
+  char bits[127], bits2[127], bits3[127], bits4[127], *p;
+  int i, ok;
+  FILE *fl;
+
+  if (!(fl = fopen(filename, "w")))
+    return FALSE;
+
+  if (img->str[PFB_NAME])       fprintf(fl, "Name: %s\n", img->str[PFB_NAME]);
+  if (img->str[PFB_PASSWD])     fprintf(fl, "Pass: %s\n", img->str[PFB_PASSWD]);
+  if (img->str[PFB_TITLE])      fprintf(fl, "Titl: %s\n", img->str[PFB_TITLE]);
+  if (img->str[PFB_DESC] && *img->str[PFB_DESC]) {
+    fprintf(fl, "Desc:\n");
+    for (p = img->str[PFB_DESC]; *p; p++)
+      if (*p != '\r')
+        fputc(*p, fl);
+    fprintf(fl, "~\n");
+  }
+  if (img->str[PFB_POOFIN])     fprintf(fl, "PfIn: %s\n", img->str[PFB_POOFIN]);
+  if (img->str[PFB_POOFOUT])    fprintf(fl, "PfOt: %s\n", img->str[PFB_POOFOUT]);
+  if (f[PFB_SEX] != PFDEF_SEX)          fprintf(fl, "Sex : %d\n", (int)f[PFB_SEX]);
+  if (f[PFB_CLASS] != PFDEF_CLASS)      fprintf(fl, "Clas: %d\n", (int)f[PFB_CLASS]);
+  if (f[PFB_RACE] != PFDEF_RACE)        fprintf(fl, "Race: %d\n", (int)f[PFB_RACE]);
+  if (f[PFB_SUBRACE] != PFDEF_SUBRACE)  fprintf(fl, "SubR: %d\n", (int)f[PFB_SUBRACE]);
+  if (f[PFB_LEVEL] != PFDEF_LEVEL)      fprintf(fl, "Levl: %d\n", (int)f[PFB_LEVEL]);
+
+  fprintf(fl, "Id  : %ld\n", (long)f[PFB_IDNUM]);
+  fprintf(fl, "Brth: %ld\n", (long)f[PFB_BIRTH]);
+  fprintf(fl, "Plyd: %d\n", (int)f[PFB_PLAYED]);
+  fprintf(fl, "Last: %ld\n", (long)f[PFB_LOGON]);
+
+  if (f[PFB_LAST_MOTD] != PFDEF_LASTMOTD) fprintf(fl, "Lmot: %d\n", (int)f[PFB_LAST_MOTD]);
+  if (f[PFB_LAST_NEWS] != PFDEF_LASTNEWS) fprintf(fl, "Lnew: %d\n", (int)f[PFB_LAST_NEWS]);
+
+  if (img->str[PFB_HOST])       fprintf(fl, "Host: %s\n", img->str[PFB_HOST]);
+  if (f[PFB_HEIGHT] != PFDEF_HEIGHT)    fprintf(fl, "Hite: %d\n", (int)f[PFB_HEIGHT]);
+  if (f[PFB_WEIGHT] != PFDEF_WEIGHT)    fprintf(fl, "Wate: %d\n", (int)f[PFB_WEIGHT]);
+  if (f[PFB_ALIGNMENT] != PFDEF_ALIGNMENT) fprintf(fl, "Alin: %d\n", (int)f[PFB_ALIGNMENT]);
+
+  sprintascii(bits,  f[PFB_PLR_FLAGS]);
+  sprintascii(bits2, f[PFB_PLR_FLAGS_1]);
+  sprintascii(bits3, f[PFB_PLR_FLAGS_2]);
+  sprintascii(bits4, f[PFB_PLR_FLAGS_3]);
+  fprintf(fl, "Act : %s %s %s %s\n", bits, bits2, bits3, bits4);
+
+  sprintascii(bits,  f[PFB_AFF_FLAGS]);
+  sprintascii(bits2, f[PFB_AFF_FLAGS_1]);
+  sprintascii(bits3, f[PFB_AFF_FLAGS_2]);
+  sprintascii(bits4, f[PFB_AFF_FLAGS_3]);
+  fprintf(fl, "Aff : %s %s %s %s\n", bits, bits2, bits3, bits4);
+
+  sprintascii(bits,  f[PFB_PRF_FLAGS]);
+  sprintascii(bits2, f[PFB_PRF_FLAGS_1]);
+  sprintascii(bits3, f[PFB_PRF_FLAGS_2]);
+  sprintascii(bits4, f[PFB_PRF_FLAGS_3]);
+  fprintf(fl, "Pref: %s %s %s %s\n", bits, bits2, bits3, bits4);
+
+  for (i = 0; i < PFB_NUM_SAVES; i++)
+    if (f[PFB_SAVE + i] != PFDEF_SAVETHROW)
+      fprintf(fl, "Thr%d: %d\n", i + 1, (int)f[PFB_SAVE + i]);
+
+  if (f[PFB_WIMP_LEV] != PFDEF_WIMPLEV)     fprintf(fl, "Wimp: %d\n", (int)f[PFB_WIMP_LEV]);
+  if (f[PFB_FREEZE_LEV] != PFDEF_FREEZELEV) fprintf(fl, "Frez: %d\n", (int)f[PFB_FREEZE_LEV]);
+  if (f[PFB_INVIS_LEV] != PFDEF_INVISLEV)   fprintf(fl, "Invs: %d\n", (int)f[PFB_INVIS_LEV]);
+  if (f[PFB_LOADROOM] != PFDEF_LOADROOM)    fprintf(fl, "Room: %d\n", (int)f[PFB_LOADROOM]);
+
+  if (f[PFB_BAD_PWS] != PFDEF_BADPWS)       fprintf(fl, "Badp: %d\n", (int)f[PFB_BAD_PWS]);
+  if (f[PFB_PRACTICES] != PFDEF_PRACTICES)  fprintf(fl, "Lern: %d\n", (int)f[PFB_PRACTICES]);
+
+  if (f[PFB_LEVEL] < LVL_IMMORT) {
+    if (f[PFB_HUNGER] != PFDEF_HUNGER)      fprintf(fl, "Hung: %d\n", (int)f[PFB_HUNGER]);
+    if (f[PFB_THIRST] != PFDEF_THIRST)      fprintf(fl, "Thir: %d\n", (int)f[PFB_THIRST]);
+    if (f[PFB_DRUNK] != PFDEF_DRUNK)        fprintf(fl, "Drnk: %d\n", (int)f[PFB_DRUNK]);
+  }
+
+  if (f[PFB_HIT] != PFDEF_HIT || f[PFB_MAX_HIT] != PFDEF_MAXHIT)
+    fprintf(fl, "Hit : %d/%d\n", (int)f[PFB_HIT], (int)f[PFB_MAX_HIT]);
+  if (f[PFB_MANA] != PFDEF_MANA || f[PFB_MAX_MANA] != PFDEF_MAXMANA)
+    fprintf(fl, "Mana: %d/%d\n", (int)f[PFB_MANA], (int)f[PFB_MAX_MANA]);
+  if (f[PFB_MOVE] != PFDEF_MOVE || f[PFB_MAX_MOVE] != PFDEF_MAXMOVE)
+    fprintf(fl, "Move: %d/%d\n", (int)f[PFB_MOVE], (int)f[PFB_MAX_MOVE]);
+  if (f[PFB_STR] != PFDEF_STR || f[PFB_STR_ADD] != PFDEF_STRADD)
+    fprintf(fl, "Str : %d/%d\n", (int)f[PFB_STR], (int)f[PFB_STR_ADD]);
+
+  if (f[PFB_INT] != PFDEF_INT)              fprintf(fl, "Int : %d\n", (int)f[PFB_INT]);
+  if (f[PFB_WIS] != PFDEF_WIS)              fprintf(fl, "Wis : %d\n", (int)f[PFB_WIS]);
+  if (f[PFB_DEX] != PFDEF_DEX)              fprintf(fl, "Dex : %d\n", (int)f[PFB_DEX]);
+  if (f[PFB_CON] != PFDEF_CON)              fprintf(fl, "Con : %d\n", (int)f[PFB_CON]);
+  if (f[PFB_CHA] != PFDEF_CHA)              fprintf(fl, "Cha : %d\n", (int)f[PFB_CHA]);
+
+  if (f[PFB_AC] != PFDEF_AC)                fprintf(fl, "Ac  : %d\n", (int)f[PFB_AC]);
+  if (f[PFB_GOLD] != PFDEF_GOLD)            fprintf(fl, "Gold: %d\n", (int)f[PFB_GOLD]);
+  if (f[PFB_BANK_GOLD] != PFDEF_BANK)       fprintf(fl, "Bank: %d\n", (int)f[PFB_BANK_GOLD]);
+  if (f[PFB_EXP] != PFDEF_EXP)              fprintf(fl, "Exp : %d\n", (int)f[PFB_EXP]);
+  if (f[PFB_HITROLL] != PFDEF_HITROLL)      fprintf(fl, "Hrol: %d\n", (int)f[PFB_HITROLL]);
+  if (f[PFB_DAMROLL] != PFDEF_DAMROLL)      fprintf(fl, "Drol: %d\n", (int)f[PFB_DAMROLL]);
+  if (f[PFB_OLC_ZONE] != PFDEF_OLC)         fprintf(fl, "Olc : %d\n", (int)f[PFB_OLC_ZONE]);
+  if (f[PFB_PAGE_LENGTH] != PFDEF_PAGELENGTH)   fprintf(fl, "Page: %d\n", (int)f[PFB_PAGE_LENGTH]);
+  if (f[PFB_SCREEN_WIDTH] != PFDEF_SCREENWIDTH) fprintf(fl, "ScrW: %d\n", (int)f[PFB_SCREEN_WIDTH]);
+  if (f[PFB_QUESTPOINTS] != PFDEF_QUESTPOINTS)  fprintf(fl, "Qstp: %d\n", (int)f[PFB_QUESTPOINTS]);
+  if (f[PFB_QUEST_COUNTER] != PFDEF_QUESTCOUNT) fprintf(fl, "Qcnt: %d\n", (int)f[PFB_QUEST_COUNTER]);
+  if (img->num_quests) {
+    fprintf(fl, "Qest:\n");
+    for (i = 0; i < img->num_quests; i++)
+      fprintf(fl, "%d\n", img->quests[i]);
+    fprintf(fl, "%d\n", NOTHING);
+  }
+  if (f[PFB_CURR_QUEST] != PFDEF_CURRQUEST) fprintf(fl, "Qcur: %d\n", (int)f[PFB_CURR_QUEST]);
+
+  for (i = 0; i < img->num_triggers; i++)
+    fprintf(fl, "Trig: %d\n", img->triggers[i]);
+
+  if (f[PFB_LEVEL] < LVL_IMMORT) {
+    fprintf(fl, "Skil:\n");
+    for (i = 0; i < img->num_skills; i++)
+      fprintf(fl, "%d %d\n", img->skills[i].num, img->skills[i].level);
+    fprintf(fl, "0 0\n");
+  }
+
+  if (img->num_affects) {
+    fprintf(fl, "Affs:\n");
+    for (i = 0; i < img->num_affects; i++)
+      fprintf(fl, "%d %d %d %d %d %d %d %d\n", img->affects[i].spell,
+        img->affects[i].duration, img->affects[i].modifier, img->affects[i].location,
+        img->affects[i].bitvector[0], img->affects[i].bitvector[1],
+        img->affects[i].bitvector[2], img->affects[i].bitvector[3]);
+    fprintf(fl, "0 0 0 0 0 0 0 0\n");
+  }
+
+  if (img->num_aliases) {
+    fprintf(fl, "Alis: %d\n", img->num_aliases);
+    for (i = 0; i < img->num_aliases; i++)
+      fprintf(fl, " %s\n%s\n%d\n", img->aliases[i].alias,
+        img->aliases[i].replacement, img->aliases[i].type);
+  }
+
+  if (img->num_vars) {
+    fprintf(fl, "Vars: %d\n", img->num_vars);
+    for (i = 0; i < img->num_vars; i++)
+      fprintf(fl, "%s %ld %s\n", img->vars[i].name, img->vars[i].context, img->vars[i].value);
+  }
+
+  ok = !ferror(fl);
+  ok = (fclose(fl) == 0) && ok;
+  return ok;
+}
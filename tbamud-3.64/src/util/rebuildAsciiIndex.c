@@ -4,7 +4,17 @@
 *  All Rights Reserved                                                    *
 ************************************************************************* */
 
-#include <stdio.h>
+/* Player files are read in either format: ASCII .plr files directly, binary
+ * .plb files through pfbinary.c. A player with both is indexed once, from the
+ * binary file, since that is the one the game loads. */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "pfdefaults.h"
+#include "pfbinary.h"
+
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -37,20 +47,30 @@ int main(int argc, char** argv)
  	return 0;
 }
 
-char *parsename(char *filename) {
+char *parsename(char *filename, int *binary) {
 	static char copy[1024];
 	strcpy(copy, filename);
 	char *extension = strchr(copy, '.');
 	if (extension == NULL) {
 		return NULL;
 	}
-	if (strcmp(".plr", extension)) {
+	if (!strcmp(".plr", extension))
+		*binary = 0;
+	else if (!strcmp(".plb", extension))
+		*binary = 1;
+	else
 		return NULL;
-	}
 	*extension = '\0';
 	return copy;
 }
 
+int adminlevel_from_level(int level) {
+	if (level >= 30)
+		return level-30;
+	else
+		return 0;
+}
+
 char *findLine(FILE *plr_file, char *tag) {
 	static char line[5000];
 	rewind(plr_file);
@@ -76,16 +96,29 @@ int parseadminlevel(FILE *plr_file, int level) {
 	if (fromFile != NULL)
 		return atoi(fromFile);
 
-	if (level >= 30)
-		return level-30;
-	else
-		return 0;
+	return adminlevel_from_level(level);
 }
 
 long parselast(FILE *plr_file) {
 	return atol(findLine(plr_file, "Last:"));
 }
 
+void index_binary(FILE *index_file, char *filename, char *name) {
+	struct pfile_image img;
+	int err, level;
+
+	if ((err = pfb_read(filename, &img)) != PFB_OK) {
+		fprintf(stderr, "%s: %s\n", filename, pfb_strerror(err));
+		return;
+	}
+	level = (int)img.field[PFB_LEVEL];
+
+	fprintf(index_file, "%ld %s %d %d 0 %ld\n", (long)img.field[PFB_IDNUM], name,
+		level > 30 ? 30 : level, adminlevel_from_level(level), (long)img.field[PFB_LOGON]);
+
+	pfb_free_image(&img);
+}
+
 
 void walkdir(FILE *index_file, char *dir) {
  	char filename_qfd[1000] ;
@@ -112,9 +145,18 @@ void walkdir(FILE *index_file, char *dir) {
 
    		walkdir(index_file, filename_qfd);
   	} else {
-			char *name = parsename(dp->d_name);
+			int binary;
+			char *name = parsename(dp->d_name, &binary);
+
+			if (name != NULL && binary) {
+				index_binary(index_file, filename_qfd, name);
+			} else if (name != NULL) {
+				/* The game loads the binary file when there is one. */
+				strcpy(filename_qfd + strlen(filename_qfd) - 4, ".plb");
+				if (stat(filename_qfd, &stbuf) == 0)
+					continue;
+				sprintf(filename_qfd, "%s/%s", dir, dp->d_name);
 
-			if (name != NULL) {
   			FILE *plr_file = fopen(filename_qfd, "r");
  				long id = parseid(plr_file);
 
@@ -186,6 +186,57 @@ int strn_cmp(const char *arg1, const char *arg2, int n)
 }
 #endif
 
+/* Lines logged during a pass of the game loop are gathered here and written
+ * in one go by flush_log(), instead of being flushed to disk one at a time. */
+static char log_buffer[LOG_BUFFER_SIZE];
+static size_t log_buffer_len = 0;
+/* The last line logged, and how many times it has been logged again since. */
+static char log_last[MAX_STRING_LENGTH];
+static int log_repeats = -1;
+static time_t log_repeat_since;
+
+/* The timestamp only changes once a second, so it is kept between lines. */
+static const char *log_timestamp(time_t ct)
+{
+  static time_t stamp_time = 0;
+  static char stamp[16];
+
+  if (ct != stamp_time) {
+    char *time_s = asctime(localtime(&ct));
+
+    snprintf(stamp, sizeof(stamp), "%-15.15s", time_s + 4);
+    stamp_time = ct;
+  }
+  return stamp;
+}
+
+static void log_append(time_t ct, const char *line)
+{
+  size_t need = strlen(line) + 20;
+
+  if (log_buffer_len + need > sizeof(log_buffer))
+    flush_log(FALSE);
+
+  if (need > sizeof(log_buffer)) {
+    fprintf(logfile, "%s :: %s\n", log_timestamp(ct), line);
+    return;
+  }
+
+  log_buffer_len += snprintf(log_buffer + log_buffer_len,
+    sizeof(log_buffer) - log_buffer_len, "%s :: %s\n", log_timestamp(ct), line);
+}
+
+static void log_report_repeats(time_t ct)
+{
+  char line[MAX_INPUT_LENGTH];
+  int repeats = log_repeats;
+
+  /* Later copies start a new count rather than being folded into this one. */
+  log_repeats = -1;
+  snprintf(line, sizeof(line), "Last message repeated %d time%s.", repeats, repeats == 1 ? "" : "s");
+  log_append(ct, line);
+}
+
 /** New variable argument log() function; logs messages to disk.
  * Works the same as the old for previously written code but is very nice
  * if new code wishes to implment printf style log messages without the need
@@ -195,8 +246,8 @@ int strn_cmp(const char *arg1, const char *arg2, int n)
  * @param args The comma delimited, variable substitutions to make in str. */
 void basic_mud_vlog(const char *format, va_list args)
 {
+  char line[MAX_STRING_LENGTH];
   time_t ct = time(0);
-  char *time_s = asctime(localtime(&ct));
 
   if (logfile == NULL) {
     puts("SYSERR: Using log() before stream was initialized!");
@@ -206,14 +257,65 @@ void basic_mud_vlog(const char *format, va_list args)
   if (format == NULL)
     format = "SYSERR: log() received a NULL format.";
 
-  time_s[strlen(time_s) - 1] = '\0';
+  vsnprintf(line, sizeof(line), format, args);
+
+  /* A line identical to the one before is only counted. */
+  if (log_repeats >= 0 && !strcmp(line, log_last)) {
+    if (!log_repeats++)
+      log_repeat_since = ct;
+    if (ct - log_repeat_since >= LOG_REPEAT_WINDOW)
+      log_report_repeats(ct);
+    return;
+  }
+
+  if (log_repeats > 0)
+    log_report_repeats(ct);
+  strcpy(log_last, line);	/* strcpy: OK (same size) */
+  log_repeats = 0;
+
+  log_append(ct, line);
+}
 
-  fprintf(logfile, "%-15.15s :: ", time_s + 4);
-  vfprintf(logfile, format, args);
-  fputc('\n', logfile);
+/** Writes out everything log() has gathered. Called once per pass of the
+ * game loop and on the way out; a repeat count that has been waiting for
+ * LOG_REPEAT_WINDOW seconds, or any at all if all is TRUE, is written first.
+ * @param all TRUE when the game is stopping and nothing may be held back. */
+void flush_log(bool all)
+{
+  time_t ct = time(0);
+
+  if (logfile == NULL)
+    return;
+
+  if (log_repeats > 0 && (all || ct - log_repeat_since >= LOG_REPEAT_WINDOW))
+    log_report_repeats(ct);
+
+  if (log_buffer_len) {
+    fwrite(log_buffer, 1, log_buffer_len, logfile);
+    log_buffer_len = 0;
+  }
   fflush(logfile);
 }
 
+/** Writes out the gathered log lines from a fatal signal handler, where stdio
+ * may not be used. The stream itself is flushed after every batch, so only
+ * the gathered lines can be outstanding. */
+void flush_log_crash(void)
+{
+  size_t done = 0;
+  ssize_t n;
+
+  if (logfile == NULL)
+    return;
+
+  while (done < log_buffer_len) {
+    if ((n = write(fileno(logfile), log_buffer + done, log_buffer_len - done)) <= 0)
+      break;
+    done += n;
+  }
+  log_buffer_len = 0;
+}
+
 /** Log messages directly to syslog on disk, no display to in game immortals.
  * Supports variable string modification arguments, a la printf. Most likely
  * any calls to plain old log() have been redirected, via macro, to this
@@ -683,7 +785,8 @@ int get_line(FILE *fl, char *buf)
  * @param[in] fbufsize The maximum size of filename, and the maximum size
  * of the path that can be written to it.
  * @param[in] mode What type of files can be created. Currently, recognized
- * modes are CRASH_FILE, ETEXT_FILE, SCRIPT_VARS_FILE and PLR_FILE.
+ * modes are CRASH_FILE, ETEXT_FILE, SCRIPT_VARS_FILE, PLR_FILE and
+ * PLR_BIN_FILE.
  * @param[in] orig_name The player name to create the filepath (of type mode)
  * for.
  * @retval int 0 if filename cannot be created, 1 if it can. */
@@ -715,6 +818,10 @@ int get_filename(char *filename, size_t fbufsize, int mode, const char *orig_nam
     prefix = LIB_PLRFILES;
     suffix = SUF_PLR;
     break;
+  case PLR_BIN_FILE:
+    prefix = LIB_PLRFILES;
+    suffix = SUF_PLRBIN;
+    break;
   default:
     return (0);
   }
@@ -780,6 +887,7 @@ void core_dump_real(const char *who, int line)
 #if 1	/* By default, let's not litter. */
 #if defined(CIRCLE_UNIX)
   /* These would be duplicated otherwise...make very sure. */
+  flush_log(TRUE);
   fflush(stdout);
   fflush(stderr);
   fflush(logfile);
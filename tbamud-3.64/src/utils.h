@@ -34,12 +34,20 @@
 /** Standard line size, used for many string limits. */
 #define READ_SIZE	256
 
+/** Bytes of log lines gathered before they are written out. */
+#define LOG_BUFFER_SIZE    (64 * 1024)
+/** Seconds a run of identical log lines is counted before the count is
+ * written. */
+#define LOG_REPEAT_WINDOW  10
+
 #define ATTR_STR( maxAttr, thisAttr, listAttr ) listAttr[( thisAttr > maxAttr ? maxAttr : thisAttr )]
 
 /* Public functions made available from utils.c. Documentation for all functions
  * are made available with the function definition. */
 void basic_mud_log(const char *format, ...) __attribute__ ((format (printf, 1, 2)));
 void basic_mud_vlog(const char *format, va_list args);
+void flush_log(bool all);
+void flush_log_crash(void);
 int touch(const char *path);
 void mudlog(int type, int level, int file, const char *str, ...) __attribute__ ((format (printf, 4, 5)));
 int	rand_number(int from, int to);
@@ -132,6 +140,9 @@ void	gain_exp(struct char_data *ch, int gain);
 void	gain_exp_regardless(struct char_data *ch, int gain);
 void	gain_condition(struct char_data *ch, int condition, int value);
 void	point_update(void);
+int	obj_timer_left(struct obj_data *obj);
+void	set_obj_timer(struct obj_data *obj, int hours);
+void	obj_timer_cancel(struct obj_data *obj);
 void	update_pos(struct char_data *victim);
 void run_autowiz(void);
 int increase_gold(struct char_data *ch, int amt);
@@ -163,8 +174,9 @@ void char_from_furniture(struct char_data *ch);
 #define ETEXT_FILE       1 /**< ???? */
 #define SCRIPT_VARS_FILE 2 /**< Reference to a global variable file. */
 #define PLR_FILE         3 /**< The standard player file */
+#define PLR_BIN_FILE     4 /**< The binary player file */
 
-#define MAX_FILES        4 /**< Max number of files types vailable */
+#define MAX_FILES        5 /**< Max number of files types vailable */
 
 /* breadth-first searching for graph function (tracking, etc) */
 #define BFS_ERROR		(-1)       /**< Error in the search. */
@@ -755,8 +767,9 @@ do                                                              \
 #define GET_OBJ_VAL(obj, val)	((obj)->obj_flags.value[(val)])
 /** Weight of obj. */
 #define GET_OBJ_WEIGHT(obj)	((obj)->obj_flags.weight)
-/** Current timer of obj. */
-#define GET_OBJ_TIMER(obj)	((obj)->obj_flags.timer)
+/** Current timer of obj. Live objects change it with set_obj_timer();
+ * prototypes and OLC copies are never scheduled and use obj_flags.timer. */
+#define GET_OBJ_TIMER(obj)	(obj_timer_left(obj))
 /** Real number of obj instance. */
 #define GET_OBJ_RNUM(obj)	((obj)->item_number)
 /** Virtual number of obj, or NOTHING if not a real obj. */
@@ -1093,6 +1106,10 @@ do                                                              \
 #define CONFIG_MAX_FILESIZE     config_info.operation.max_filesize
 /** Get the max bad password attempts. */
 #define CONFIG_MAX_BAD_PWS      config_info.operation.max_bad_pws
+/** Get the max commands a connection may have queued. */
+#define CONFIG_MAX_INPUT_QUEUE  config_info.operation.max_input_queue
+/** Get the setting to save player files as binary. */
+#define CONFIG_BINARY_PFILES    config_info.operation.binary_pfiles
 /** Get the siteok setting. */
 #define CONFIG_SITEOK_ALL       config_info.operation.siteok_everyone
 /** Get the auto-save-to-disk settings for OLC. */